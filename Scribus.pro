@@ -161,17 +161,21 @@ HEADERS += scribus/actionmanager.h \
            scribus/scdocoutput.h \
            scribus/scdocoutput_ps2.h \
            scribus/scdomelement.h \
+           scribus/scfilewriter.h \
            scribus/scfonts.h \
            scribus/scgtplugin.h \
            scribus/scguardedptr.h \
            scribus/schelptreemodel.h \
            scribus/scimage.h \
+           scribus/scimagebandwriter.h \
            scribus/scimagecachedir.h \
            scribus/scimagecachefile.h \
            scribus/scimagecachemanager.h \
            scribus/scimagecacheproxy.h \
            scribus/scimagecachewriteaction.h \
+           scribus/scimagefilewriter.h \
            scribus/scimagestructs.h \
+           scribus/scitemindex.h \
            scribus/sclayer.h \
            scribus/sclimits.h \
            scribus/sclistboxpixmap.h \
@@ -302,6 +306,7 @@ HEADERS += scribus/actionmanager.h \
            scribus/fonts/scface_ps.h \
            scribus/fonts/scface_ttf.h \
            scribus/fonts/scfontmetrics.h \
+           scribus/fonts/scglyphcache.h \
            scribus/fonts/sfnt.h \
            scribus/fonts/sfnt_format.h \
            scribus/imagedataloaders/scimgdataloader.h \
@@ -332,6 +337,7 @@ HEADERS += scribus/actionmanager.h \
            scribus/tests/cellareatests.h \
            scribus/tests/runtests.h \
            scribus/tests/testGlyphStore.h \
+           scribus/tests/testImageEffects.h \
            scribus/tests/testIndex.h \
            scribus/tests/testStoryText.h \
            scribus/text/boxes.h \
@@ -1242,16 +1248,20 @@ SOURCES += scribus/actionmanager.cpp \
            scribus/scdocoutput.cpp \
            scribus/scdocoutput_ps2.cpp \
            scribus/scdomelement.cpp \
+           scribus/scfilewriter.cpp \
            scribus/scfonts.cpp \
            scribus/scgtplugin.cpp \
            scribus/schelptreemodel.cpp \
            scribus/scimage.cpp \
+           scribus/scimagebandwriter.cpp \
            scribus/scimagecachedir.cpp \
            scribus/scimagecachefile.cpp \
            scribus/scimagecachemanager.cpp \
            scribus/scimagecacheproxy.cpp \
            scribus/scimagecachewriteaction.cpp \
+           scribus/scimagefilewriter.cpp \
            scribus/scimagestructs.cpp \
+           scribus/scitemindex.cpp \
            scribus/sclayer.cpp \
            scribus/sclockedfile.cpp \
            scribus/scmimedata.cpp \
@@ -1355,6 +1365,7 @@ SOURCES += scribus/actionmanager.cpp \
            scribus/fonts/scface_ps.cpp \
            scribus/fonts/scface_ttf.cpp \
            scribus/fonts/scfontmetrics.cpp \
+           scribus/fonts/scglyphcache.cpp \
            scribus/fonts/sfnt.cpp \
            scribus/imagedataloaders/scimgdataloader.cpp \
            scribus/imagedataloaders/scimgdataloader_gimp.cpp \
@@ -1387,6 +1398,7 @@ SOURCES += scribus/actionmanager.cpp \
            scribus/tests/cellareatests.cpp \
            scribus/tests/runtests.cpp \
            scribus/tests/testGlyphStore.cpp \
+           scribus/tests/testImageEffects.cpp \
            scribus/tests/testIndex.cpp \
            scribus/tests/testStoryText.cpp \
            scribus/text/boxes.cpp \
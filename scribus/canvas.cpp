@@ -16,9 +16,11 @@
 #if defined(_MSC_VER) && !defined(_USE_MATH_DEFINES)
 #define _USE_MATH_DEFINES
 #endif
+#include <algorithm>
 #include <cmath>
 
 // #include <QDebug>
+#include <QSet>
 #include <QToolTip>
 #include <QWidget>
 
@@ -110,8 +112,9 @@ Canvas::Canvas(ScribusDoc* doc, ScribusView* parent) : QWidget(parent), m_doc(do
 	setAutoFillBackground(true);
 	setAttribute(Qt::WA_OpaquePaintEvent, true);
 	setAttribute(Qt::WA_NoSystemBackground, true);
-	m_buffer = /*QImage()*/QPixmap();
-	m_bufferRect = QRect();
+	m_tileCount = 0;
+	m_tileUseCounter = 0;
+	m_tilesInvalidated = false;
 	m_viewMode.init();
 	m_renderMode = RENDER_NORMAL;
 }
@@ -470,19 +473,17 @@ PageItem* Canvas::itemUnderCursor(QPoint globalPos, PageItem* itemAbove, bool al
 		return NULL;
 
 	int currNr = itemAbove? m_doc->Items->indexOf(itemAbove)-1 : m_doc->Items->count()-1;
-	while (currNr >= 0)
+	// only items whose bounds touch the mouse area are candidates, topmost last
+	QVector<int> candidates = m_doc->itemIndex(m_doc->Items).itemsInArea(*m_doc->Items, mouseArea);
+	int candidate = std::upper_bound(candidates.begin(), candidates.end(), currNr) - candidates.begin() - 1;
+	while (candidate >= 0)
 	{
+		currNr = candidates.at(candidate--);
 		currItem = m_doc->Items->at(currNr);
 		if ((m_doc->masterPageMode())  && (!((currItem->OwnPage == -1) || (currItem->OwnPage == static_cast<int>(m_doc->currentPage()->pageNr())))))
-		{
-			--currNr;
 			continue;
-		}
 		if ((m_doc->drawAsPreview && !m_doc->editOnPreview) && !(currItem->isAnnotation() || currItem->isGroup()))
-		{
-			--currNr;
 			continue;
-		}
 		if (((currItem->LayerID == m_doc->activeLayer()) || (m_doc->layerSelectable(currItem->LayerID))) && (!m_doc->layerLocked(currItem->LayerID)))
 		{
 			QTransform itemPos = currItem->getTransform();
@@ -511,7 +512,6 @@ PageItem* Canvas::itemUnderCursor(QPoint globalPos, PageItem* itemAbove, bool al
 				return currItem;
 			}
 		}
-		--currNr;
 	}
 	return NULL;
 }
@@ -603,16 +603,19 @@ PageItem * Canvas::itemUnderItem(PageItem * item, int& index) const
 /*
  Rendermodes:
  
- m_buffer holds the current page(s)
- m_bufferRect describes the contents in local coordinates:
+ The contents are cached in tiles of TileSize x TileSize pixels, one tile
+ set per zoom level. Tile (tx, ty) covers the pixels starting at
+ (tx * TileSize, ty * TileSize) in scaled canvas coordinates:
 
  minCanvasCoordinate |-> local (0,0) 
  
  (0,0) |-> local (scale*minCanvasCoordinate) 
  
- local m_bufferRect.topLeft |-> buffer (0,0)
- 
+ local canvasToLocal(0,0) + (tx, ty) * TileSize |-> tile (0,0)
  
+ Tiles survive scrolling and zooming. They are dropped when the document
+ reports a changed region (see invalidateTiles()), on forced redraws and
+ by clearBuffers().
  */
 
 void Canvas::setRenderMode(RenderMode mode)
@@ -628,8 +631,8 @@ void Canvas::setRenderMode(RenderMode mode)
 
 void Canvas::clearBuffers()
 {
-	m_buffer = QPixmap();
-	m_bufferRect = QRect();
+	m_tileSets.clear();
+	m_tileCount = 0;
 	m_selectionBuffer = QPixmap();
 	m_selectionRect = QRect();
 }
@@ -639,151 +642,187 @@ void Canvas::setScale(double scale)
 	if (m_viewMode.scale == scale)
 		return;
 	m_viewMode.scale = scale;
-	clearBuffers();
 	update();
 }
 
 
-bool Canvas::adjustBuffer()
+void Canvas::invalidateTiles(QRectF canvasRect)
 {
-	bool ret = false;
-	QRect viewport(-x(), -y(), m_view->viewport()->width(), m_view->viewport()->height());
-// 	qDebug()<<"Canvas::adjustBuffer"<<viewport<<m_viewMode.forceRedraw<<m_viewMode.operItemSelecting;
-	QPoint minCanvasCoordinate = canvasToLocal(QPointF(0.0, 0.0));
-	if (minCanvasCoordinate != m_oldMinCanvasCoordinate)
+	if (!canvasRect.isValid())
 	{
-		m_bufferRect.translate(minCanvasCoordinate.x() - m_oldMinCanvasCoordinate.x(),
-							   minCanvasCoordinate.y() - m_oldMinCanvasCoordinate.y());
-		m_oldMinCanvasCoordinate = minCanvasCoordinate;
+		clearBuffers();
+		return;
 	}
-#if DRAW_DEBUG_LINES
-//	qDebug() << "adjust buffer" << m_bufferRect << "for viewport" << viewport;
-#endif
-	if (!m_bufferRect.isValid())
+	m_tilesInvalidated = true;
+	for (int i = m_tileSets.count() - 1; i >= 0; --i)
 	{
-//		qDebug() << "adjust buffer: invalid buffer, viewport" << viewport;
-		m_bufferRect = viewport;
-		m_buffer = QPixmap(m_bufferRect.width(), m_bufferRect.height());
-		fillBuffer(&m_buffer, m_bufferRect.topLeft(), m_bufferRect);
-		ret = true;
-#if DRAW_DEBUG_LINES
-		QPainter p(&m_buffer);
-		p.setPen(Qt::blue);
-		p.drawLine(0, 0, m_buffer.width(), m_buffer.height());
-		p.drawLine(m_buffer.width(), 0, 0, m_buffer.height());
-		p.end();
-#endif
+		TileSet& tileSet = m_tileSets[i];
+		double scale = tileSet.scale;
+		// same margin as ScribusView::updateCanvas(), plus rounding
+		QRect area = QRectF(canvasRect.x() * scale, canvasRect.y() * scale, canvasRect.width() * scale, canvasRect.height() * scale).toAlignedRect().adjusted(-11, -11, 11, 11);
+		for (int ty = tileIndex(area.top()); ty <= tileIndex(area.bottom()); ++ty)
+		{
+			for (int tx = tileIndex(area.left()); tx <= tileIndex(area.right()); ++tx)
+				m_tileCount -= tileSet.tiles.remove(tileKey(tx, ty));
+		}
+		if (tileSet.tiles.isEmpty())
+			m_tileSets.removeAt(i);
 	}
-	else if (!m_bufferRect.contains(viewport))
-	{
-		QRect newRect(m_bufferRect);
-		if (m_bufferRect.left() > viewport.left())
-			newRect.translate(viewport.left() - m_bufferRect.left(), 0);
-		if (m_bufferRect.right() < viewport.right())
-			newRect.translate(viewport.right() - m_bufferRect.right(), 0);
-		if (m_bufferRect.top() > viewport.top())
-			newRect.translate(0, viewport.top() - m_bufferRect.top());
-		if (m_bufferRect.bottom() < viewport.bottom())
-			newRect.translate(0, viewport.bottom() - m_bufferRect.bottom());
-//		qDebug() << "adjust buffer: " << m_bufferRect << "outside viewport" << viewport << " new rect:" << newRect;
-		
-		if (!m_bufferRect.intersects(newRect))
+}
+
+Canvas::TileSet& Canvas::currentTileSet()
+{
+	for (int i = 0; i < m_tileSets.count(); ++i)
+	{
+		if (m_tileSets.at(i).scale == m_viewMode.scale)
 		{
-//			qDebug() << "adjust buffer: fresh buffer" << m_bufferRect << "-->" << newRect;
-			m_bufferRect = newRect;
-// 			m_buffer = QImage(m_bufferRect.width(), m_bufferRect.height(), QImage::Format_ARGB32);
-			m_buffer = QPixmap(m_bufferRect.width(), m_bufferRect.height());
-			fillBuffer(&m_buffer, m_bufferRect.topLeft(), m_bufferRect);
-			ret = true;
-#if DRAW_DEBUG_LINES
-			QPainter p(&m_buffer);
-			p.setPen(Qt::blue);
-			p.drawLine(0, 0, m_buffer.width(), m_buffer.height());
-			p.drawLine(m_buffer.width(), 0, 0, m_buffer.height());
-			p.end();
-#endif			
+			if (i > 0)
+				m_tileSets.move(i, 0);
+			return m_tileSets.first();
 		}
-		else
+	}
+	while (m_tileSets.count() >= MaxTileSets)
+	{
+		m_tileCount -= m_tileSets.last().tiles.count();
+		m_tileSets.removeLast();
+	}
+	TileSet tileSet;
+	tileSet.scale = m_viewMode.scale;
+	m_tileSets.prepend(tileSet);
+	return m_tileSets.first();
+}
+
+void Canvas::fillTiles(QRect rect)
+{
+	QPoint origin = canvasToLocal(QPointF(0.0, 0.0));
+	QRect area = rect.translated(-origin);
+	int tx0 = tileIndex(area.left());
+	int tx1 = tileIndex(area.right());
+	int ty0 = tileIndex(area.top());
+	int ty1 = tileIndex(area.bottom());
+	quint64 firstUse = m_tileUseCounter + 1;
+	QHash<quint64, Tile>& tiles = currentTileSet().tiles;
+	for (int ty = ty0; ty <= ty1; ++ty)
+	{
+		int tx = tx0;
+		while (tx <= tx1)
 		{
-			// copy buffer:
-// 			QImage newBuffer(newRect.width(), newRect.height(), QImage::Format_ARGB32);
-			QPixmap newBuffer(newRect.width(), newRect.height());
-			QPainter p(&newBuffer);
-			int xpos = m_bufferRect.x() - newRect.x();
-			int ypos = m_bufferRect.y() - newRect.y();
-			int x = 0;
-			int y = 0;
-			int width = m_bufferRect.width();
-			int height = m_bufferRect.height();
-			if (xpos < 0)
-			{
-				x = -xpos;
-				width -= x;
-				xpos = 0;
-			}
-			if (ypos < 0)
-			{
-				y = -ypos;
-				height -= y;
-				ypos = 0;
-			}
-			if (xpos + width > newRect.width())
+			QHash<quint64, Tile>::iterator it = tiles.find(tileKey(tx, ty));
+			if (it != tiles.end())
 			{
-				width = newRect.width() - xpos;
+				it->lastUse = ++m_tileUseCounter;
+				++tx;
+				continue;
 			}
-			if (ypos + height > newRect.height())
+			// render a block of missing tiles in one pass: the run in this row,
+			// extended downwards as long as the same run is missing below
+			int txEnd = tx;
+			while ((txEnd < tx1) && !tiles.contains(tileKey(txEnd + 1, ty)))
+				++txEnd;
+			int tyEnd = ty;
+			bool missing = true;
+			while (missing && (tyEnd < ty1))
 			{
-				height = newRect.height() - ypos;
+				for (int i = tx; missing && (i <= txEnd); ++i)
+					missing = !tiles.contains(tileKey(i, tyEnd + 1));
+				if (missing)
+					++tyEnd;
 			}
-// 			p.drawImage(xpos, ypos, m_buffer, x, y,  width + 1, height + 1); // FIXME: == params drawPixmap?
-			p.drawPixmap(xpos, ypos, m_buffer, x, y,  width + 1, height + 1);
+			QRect block(origin.x() + tx * TileSize, origin.y() + ty * TileSize, (txEnd - tx + 1) * TileSize, (tyEnd - ty + 1) * TileSize);
+			QPixmap buffer(block.size());
+			fillBuffer(&buffer, block.topLeft(), block);
 #if DRAW_DEBUG_LINES
+			QPainter p(&buffer);
 			p.setPen(Qt::blue);
-			p.drawLine(xpos, ypos+height/2, xpos+width/2, ypos);
-			p.drawLine(xpos+width, ypos+height/2, xpos+width/2, ypos);
-			p.drawLine(xpos, ypos+height/2, xpos+width/2, ypos+height);
-			p.drawLine(xpos+width, ypos+height/2, xpos+width/2, ypos+height);
-//			qDebug() << "adjust buffer old" << m_bufferRect << "@" << xpos << ypos << "--> new" << newRect;
-#endif
+			p.drawLine(0, 0, buffer.width(), buffer.height());
+			p.drawLine(buffer.width(), 0, 0, buffer.height());
 			p.end();
-
-			// #8548, #13470 do not return true in this case, we only partially update buffer content
-			// and the redraw rect from paintEvent may not be included in the updated area if
-			// canvas has just been resized, after an object has been put in scrap area for eg.
-			if (newRect.top() < m_bufferRect.top())
-			{
-				fillBuffer(&newBuffer, newRect.topLeft(), QRect(newRect.left(), newRect.top(), newRect.width(), m_bufferRect.top() - newRect.top() + 2));
-				//ret = true;
-			}
-			if (newRect.bottom() > m_bufferRect.bottom())
-			{
-				fillBuffer(&newBuffer, newRect.topLeft(), QRect(newRect.left(), m_bufferRect.bottom() - 1, newRect.width(), newRect.bottom() - m_bufferRect.bottom() + 2));
-				//ret = true;
-			}
-			if (newRect.left() < m_bufferRect.left())
+#endif
+			for (int j = ty; j <= tyEnd; ++j)
 			{
-				fillBuffer(&newBuffer, newRect.topLeft(), QRect(newRect.left(), m_bufferRect.top(), m_bufferRect.left() - newRect.left() + 2, m_bufferRect.height()));
-				//ret = true;
+				for (int i = tx; i <= txEnd; ++i)
+				{
+					Tile tile;
+					tile.pixmap = buffer.copy((i - tx) * TileSize, (j - ty) * TileSize, TileSize, TileSize);
+					tile.lastUse = ++m_tileUseCounter;
+					tiles.insert(tileKey(i, j), tile);
+					++m_tileCount;
+				}
 			}
-			if (newRect.right() > m_bufferRect.right())
+			tx = txEnd + 1;
+		}
+	}
+	if (m_tileCount > MaxTiles)
+	{
+		// evict least recently used tiles, but never those just painted
+		QList<QPair<quint64, QPair<int, quint64> > > candidates;
+		for (int i = 0; i < m_tileSets.count(); ++i)
+		{
+			QHash<quint64, Tile>::const_iterator it;
+			for (it = m_tileSets.at(i).tiles.constBegin(); it != m_tileSets.at(i).tiles.constEnd(); ++it)
 			{
-				fillBuffer(&newBuffer, newRect.topLeft(), QRect(m_bufferRect.right() - 1, m_bufferRect.top(), newRect.right() - m_bufferRect.right() + 2, m_bufferRect.height()));
-				//ret = true;
+				if (it->lastUse < firstUse)
+					candidates.append(qMakePair(it->lastUse, qMakePair(i, it.key())));
 			}
-			m_buffer = newBuffer;
-			m_bufferRect = newRect;
-#if DRAW_DEBUG_LINES
-			QPainter p2(&m_buffer);
-			p2.setPen(Qt::blue);
-			p2.drawRect(xpos, ypos, width, height);
-			p2.end();
-#endif
+		}
+		std::sort(candidates.begin(), candidates.end());
+		for (int i = 0; (i < candidates.count()) && (m_tileCount > MaxTiles); ++i)
+		{
+			m_tileSets[candidates.at(i).second.first].tiles.remove(candidates.at(i).second.second);
+			--m_tileCount;
+		}
+		for (int i = m_tileSets.count() - 1; i > 0; --i)
+		{
+			if (m_tileSets.at(i).tiles.isEmpty())
+				m_tileSets.removeAt(i);
+		}
+	}
+}
+
+void Canvas::redrawTiles(QRect rect, QRect viewport)
+{
+	QPoint origin = canvasToLocal(QPointF(0.0, 0.0));
+	QRect area = rect.translated(-origin);
+	QRect visibleArea = viewport.translated(-origin);
+	int vx0 = tileIndex(visibleArea.left());
+	int vx1 = tileIndex(visibleArea.right());
+	int vy0 = tileIndex(visibleArea.top());
+	int vy1 = tileIndex(visibleArea.bottom());
+	TileSet& tileSet = currentTileSet();
+	while (m_tileSets.count() > 1)
+		m_tileSets.removeLast();
+	QHash<quint64, Tile> visibleTiles;
+	for (int ty = vy0; ty <= vy1; ++ty)
+	{
+		for (int tx = vx0; tx <= vx1; ++tx)
+		{
+			QHash<quint64, Tile>::const_iterator it = tileSet.tiles.constFind(tileKey(tx, ty));
+			if (it == tileSet.tiles.constEnd())
+				continue;
+			QRect tileRect(tx * TileSize, ty * TileSize, TileSize, TileSize);
+			if (!tileRect.intersects(area))
+				visibleTiles.insert(it.key(), it.value());
+		}
+	}
+	tileSet.tiles = visibleTiles;
+	m_tileCount = visibleTiles.count();
+	fillTiles(rect);
+}
+
+void Canvas::drawTiles(QPainter* p, QRect rect)
+{
+	QPoint origin = canvasToLocal(QPointF(0.0, 0.0));
+	QRect area = rect.translated(-origin);
+	const QHash<quint64, Tile>& tiles = currentTileSet().tiles;
+	for (int ty = tileIndex(area.top()); ty <= tileIndex(area.bottom()); ++ty)
+	{
+		for (int tx = tileIndex(area.left()); tx <= tileIndex(area.right()); ++tx)
+		{
+			QHash<quint64, Tile>::const_iterator it = tiles.constFind(tileKey(tx, ty));
+			if (it != tiles.constEnd())
+				p->drawPixmap(origin.x() + tx * TileSize, origin.y() + ty * TileSize, it->pixmap);
 		}
 	}
-//	else
-//		qDebug() << "adjustBuffer: reusing" << m_bufferRect;
-// 	qDebug() << "Canvas::adjustBuffer"<<ret;
-	return ret;
 }
 
 void Canvas::fillBuffer(QPaintDevice* buffer, QPoint bufferOrigin, QRect clipRect)
@@ -816,8 +855,14 @@ void Canvas::paintEvent ( QPaintEvent * p )
 	t1 = t2=t3=t4=t5 =t6= 0;
 	t.start();
 #endif
-	// fill buffer if necessary
-	bool bufferFilled = adjustBuffer();
+	// render the tiles of the viewport which are not cached yet
+	QRect viewport(-x(), -y(), m_view->viewport()->width(), m_view->viewport()->height());
+	if ((m_renderMode == RENDER_NORMAL) && ((m_viewMode.forceRedraw && !m_tilesInvalidated) || m_viewMode.operTextSelecting))
+	{
+//		qDebug() << "Canvas::paintEvent: forceRedraw=" << m_viewMode.forceRedraw;
+		redrawTiles(p->rect(), viewport);
+	}
+	fillTiles(viewport.united(p->rect()));
 	// It is ugly, but until we figure out why drawing directly on the 
 	// widget is so slow, it saves us a Cray! - pm
 	QPixmap tmpImg(p->rect().size());
@@ -827,33 +872,20 @@ void Canvas::paintEvent ( QPaintEvent * p )
 	{
 		case RENDER_NORMAL:
 		{
-#if DRAW_DEBUG_LINES
-//			qDebug() << "update Buffer:" << m_bufferRect << p->rect() << m_viewMode.forceRedraw;
-#endif
 #ifdef SHOW_ME_WHAT_YOU_GET_IN_D_CANVA
 			dmode = "NORMAL";
 			t1 = t.elapsed();
 			t.start();
 #endif
-			if ((m_viewMode.forceRedraw || m_viewMode.operTextSelecting) && (!bufferFilled))
-			{
-//				qDebug() << "Canvas::paintEvent: forceRedraw=" << m_viewMode.forceRedraw << "bufferFilled=" << bufferFilled;
-				fillBuffer(&m_buffer, m_bufferRect.topLeft(), p->rect());
-			}
 #ifdef SHOW_ME_WHAT_YOU_GET_IN_D_CANVA
 			t2 = t.elapsed();
 			t.start();
 #endif
-			int xV = p->rect().x() - m_bufferRect.x();
-			int yV = p->rect().y() - m_bufferRect.y();
-			int wV = p->rect().width();
-			int hV = p->rect().height();
-			if (hV > 0 && wV > 0)
+			if (!p->rect().isEmpty())
 			{
-// 				qp.drawImage(p->rect().x(), p->rect().y(), m_buffer, xV, yV,  wV, hV);
-				qp.drawPixmap(p->rect().x(), p->rect().y(), m_buffer, xV, yV,  wV, hV);
+				drawTiles(&qp, p->rect());
 #if DRAW_DEBUG_LINES
-//				qDebug() << "normal rendering" << xV << yV << wV << hV << "at" << p->rect().x() << p->rect().y();
+//				qDebug() << "normal rendering" << p->rect();
 				qp.setPen(Qt::blue);
 				qp.drawLine(p->rect().x(), p->rect().y(), p->rect().x() + p->rect().width(), p->rect().y() + p->rect().height());
 				qp.drawLine(p->rect().x() + p->rect().width(), p->rect().y(), p->rect().x(), p->rect().y() + p->rect().height());
@@ -884,31 +916,15 @@ void Canvas::paintEvent ( QPaintEvent * p )
 			t1 = t.elapsed();
 			t.start();
 #endif
-				int xV = p->rect().x() - m_bufferRect.x();
-				int yV = p->rect().y() - m_bufferRect.y();
-				int wV = p->rect().width();
-				int hV = p->rect().height();
-				if (xV < 0)
-				{
-					wV += xV;
-					xV = 0;
-				}
-				if (yV < 0)
-				{
-					hV += yV;
-					yV = 0;
-				}
 #ifdef SHOW_ME_WHAT_YOU_GET_IN_D_CANVA
 				t2 = t.elapsed();
 				t.start();
 #endif
-				if (hV > 0 && wV > 0)
+				if (!p->rect().isEmpty())
 				{
-// 					qp.drawImage(p->rect().x(), p->rect().y(), m_buffer, xV, yV,  wV, hV);
-					
-					qp.drawPixmap(p->rect().x(), p->rect().y(), m_buffer, xV, yV,  wV, hV);
+					drawTiles(&qp, p->rect());
 	#if DRAW_DEBUG_LINES
-//					qDebug() << "buffered rendering" << xV << yV << wV << hV << "at" << p->rect().x() << p->rect().y();
+//					qDebug() << "buffered rendering" << p->rect();
 					qp.setPen(Qt::green);
 					qp.drawLine(p->rect().x(), p->rect().y(), p->rect().x() + p->rect().width(), p->rect().y() + p->rect().height());
 					qp.drawLine(p->rect().x() + p->rect().width(), p->rect().y(), p->rect().x(), p->rect().y() + p->rect().height());
@@ -955,6 +971,7 @@ void Canvas::paintEvent ( QPaintEvent * p )
 	qDebug()<<dmode<<t1<<t2<<t3<<t4<<t5<<t6<<"-" <<t1+t2+t3+t4+t5+t6;
 #endif
 	m_viewMode.forceRedraw = false;
+	m_tilesInvalidated = false;
 	m_viewMode.operItemSelecting = false;
 	m_viewMode.operTextSelecting = false;
 }
@@ -1384,6 +1401,14 @@ void Canvas::DrawMasterItems(ScPainter *painter, ScPage *page, ScLayer& layer, Q
 
 	PageItem *currItem;
 	ScPage* Mp = m_doc->MasterPages.at(m_doc->MasterNames[page->MPageNam]);
+	// Master items are stored at master page coordinates and drawn shifted
+	// onto the page, except those changed on the page itself
+	QSet<PageItem*> visibleItems;
+	ScItemIndex& masterIndex = m_doc->itemIndex(&m_doc->MasterItems);
+	QRectF masterArea = cullingArea.translated(Mp->xOffset() - page->xOffset(), Mp->yOffset() - page->yOffset());
+	QVector<int> candidates = masterIndex.itemsInArea(m_doc->MasterItems, masterArea) + masterIndex.itemsInArea(m_doc->MasterItems, cullingArea);
+	for (int i = 0; i < candidates.count(); ++i)
+		visibleItems.insert(m_doc->MasterItems.at(candidates[i]));
 	uint layerCount = m_doc->layerCount();
 	if ((layerCount > 1) && ((layer.blendMode != 0) || (layer.transparency != 1.0)) && (!layer.outlineMode))
 		painter->beginLayer(layer.transparency, layer.blendMode);
@@ -1393,6 +1418,8 @@ void Canvas::DrawMasterItems(ScPainter *painter, ScPage *page, ScLayer& layer, Q
 		currItem = page->FromMaster.at(a);
 		if (currItem->LayerID != layer.ID)
 			continue;
+		if (!visibleItems.contains(currItem))
+			continue;
 		if ((currItem->OwnPage != -1) && (currItem->OwnPage != static_cast<int>(Mp->pageNr())))
 			continue;
 		if ((m_viewMode.previewMode) && (!currItem->printEnabled()))
@@ -1403,15 +1430,22 @@ void Canvas::DrawMasterItems(ScPainter *painter, ScPage *page, ScLayer& layer, Q
 		double OldY = currItem->yPos();
 		double OldBX = currItem->BoundingX;
 		double OldBY = currItem->BoundingY;
+		// the item is back in place before anything else sees it, keep its preflight result
+		m_doc->checkerCache().setSuspended(true);
 		if (!currItem->ChangedMasterItem)
 		{
+			// The whole master moves along, which doesn't change the layout of its
+			// frames, so keep it for the next page instead of redoing it on each one
+			bool wasInvalid = currItem->invalid;
 			//Hack to not check for undo changes, indicate drawing only
 			currItem->moveBy(-Mp->xOffset() + page->xOffset(), -Mp->yOffset() + page->yOffset(), true);
+			currItem->invalid = wasInvalid;
 			currItem->BoundingX = OldBX - Mp->xOffset() + page->xOffset();
 			currItem->BoundingY = OldBY - Mp->yOffset() + page->yOffset();
 		}
 		currItem->savedOwnPage = currItem->OwnPage;
 		currItem->OwnPage = page->pageNr();
+		m_doc->checkerCache().setSuspended(false);
 //FIXME						if (!evSpon || forceRedraw)
 //					currItem->invalid = true;
 		if (cullingArea.intersects(currItem->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0)))
@@ -1427,6 +1461,7 @@ void Canvas::DrawMasterItems(ScPainter *painter, ScPage *page, ScLayer& layer, Q
 //								qDebug() << "skip masterpage item (move/resizeEdit/selected)" << m_viewMode.operItemMoving << currItem->isSelected();
 		}
 		currItem->OwnPage = currItem->savedOwnPage;
+		m_doc->checkerCache().setSuspended(true);
 		if (!currItem->ChangedMasterItem)
 		{
 			//Hack to not check for undo changes, indicate drawing only
@@ -1434,6 +1469,7 @@ void Canvas::DrawMasterItems(ScPainter *painter, ScPage *page, ScLayer& layer, Q
 			currItem->BoundingX = OldBX;
 			currItem->BoundingY = OldBY;
 		}
+		m_doc->checkerCache().setSuspended(false);
 	}
 	if ((layerCount > 1) && ((layer.blendMode != 0) || (layer.transparency != 1.0)) && (!layer.outlineMode))
 		painter->endLayer();
@@ -1465,13 +1501,16 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip, bool
 	if ((layerCount > 1) && ((layer.blendMode != 0) || (layer.transparency != 1.0)) && (!layer.outlineMode))
 		painter->beginLayer(layer.transparency, layer.blendMode);
 
+	// items outside the culling area are skipped without looking at them
+	QVector<int> candidates = m_doc->itemIndex(m_doc->Items).itemsInArea(*m_doc->Items, cullingArea);
+
 	//if notes are used
 	//then we must be sure that text frames are valid and all notes frames are created before we start drawing
 	if (!notesFramesPass && !m_doc->notesList().isEmpty())
 	{
-		for (QList<PageItem*>::iterator it = m_doc->Items->begin(); it != m_doc->Items->end(); ++it)
+		for (int i = 0; i < candidates.count(); ++i)
 		{
-			PageItem* currItem = *it;
+			PageItem* currItem = m_doc->Items->at(candidates[i]);
 			if ( !currItem->isTextFrame()
 				|| currItem->isNoteFrame()
 				|| !currItem->invalid
@@ -1485,9 +1524,14 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip, bool
 				currItem->layout();
 		}
 	}
-	for (int it = 0; it < m_doc->Items->count(); ++it)
+	// the notes pass above may have added notes frames
+	candidates = m_doc->itemIndex(m_doc->Items).itemsInArea(*m_doc->Items, cullingArea);
+	QList<PageItem*> visibleItems;
+	for (int i = 0; i < candidates.count(); ++i)
+		visibleItems.append(m_doc->Items->at(candidates[i]));
+	for (int it = 0; it < visibleItems.count(); ++it)
 	{
-		currItem = m_doc->Items->at(it);
+		currItem = visibleItems.at(it);
 		if (notesFramesPass && !currItem->isNoteFrame())
 			continue;
 		if (!notesFramesPass && currItem->isNoteFrame())
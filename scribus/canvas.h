@@ -26,6 +26,9 @@ scribusview.h  -  description
 
 #include <QApplication>
 //#include <QDebug>
+#include <QHash>
+#include <QList>
+#include <QPixmap>
 #include <QPolygon>
 #include <QRect>
 #include <QRectF>
@@ -142,6 +145,11 @@ public:
 	void setRenderMode(RenderMode m);
 	
 	void clearBuffers();              // very expensive
+	/**
+		Drops the cached tiles of all zoom levels which show the given area
+		in canvas coordinates, or all tiles if the rect is invalid.
+	 */
+	void invalidateTiles(QRectF canvasRect);
 	
 	// deprecated:
 	void resetRenderMode() { m_renderMode = RENDER_NORMAL; clearBuffers(); }
@@ -239,9 +247,16 @@ private:
 	void getGroupRectScreen(double *x, double *y, double *w, double *h);
 
 	/**
-		Enlarges the buffer such that it contains the viewport.
+		Renders the missing tiles of the current zoom level within rect,
+		in local coordinates.
+	 */
+	void fillTiles(QRect rect);
+	/**
+		Re-renders the tiles within rect after a forced redraw. Tiles outside
+		the viewport may be stale as well and are dropped.
 	 */
-	bool adjustBuffer();
+	void redrawTiles(QRect rect, QRect viewport);
+	void drawTiles(QPainter* p, QRect rect);
 	/**
 		Fills the given buffer with contents.
 	    bufferOrigin and clipRect are in local coordinates
@@ -265,12 +280,33 @@ private:
 	ScribusView* m_view;
 	CanvasViewMode m_viewMode;
 	
+	struct Tile
+	{
+		QPixmap pixmap;
+		quint64 lastUse;
+	};
+	struct TileSet
+	{
+		double scale;
+		QHash<quint64, Tile> tiles;
+	};
+	enum
+	{
+		TileSize = 256,    // in device pixels
+		MaxTileSets = 3,   // zoom levels kept for zooming back and forth
+		MaxTiles = 256     // about 64 MB of tiles
+	};
+	TileSet& currentTileSet();
+	static quint64 tileKey(int tx, int ty) { return (static_cast<quint64>(static_cast<quint32>(tx)) << 32) | static_cast<quint32>(ty); }
+	static int tileIndex(int pos) { return pos >= 0 ? pos / TileSize : -((-pos - 1) / TileSize) - 1; }
+
 	RenderMode m_renderMode;
-	QPixmap m_buffer;
-	QRect   m_bufferRect;
+	QList<TileSet> m_tileSets;    // most recently used zoom level first
+	int     m_tileCount;
+	quint64 m_tileUseCounter;
+	bool    m_tilesInvalidated;   // the next forced redraw was announced by invalidateTiles()
 	QPixmap m_selectionBuffer;
 	QRect   m_selectionRect;
-	QPoint  m_oldMinCanvasCoordinate;
 };
 
 
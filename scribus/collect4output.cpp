@@ -22,13 +22,83 @@ for which a new license (GPL+exception) is in place.
 #include "scraction.h"
 #include "scpattern.h"
 #include "util_file.h"
+#include "third_party/zip/scribus_zip.h"
 
+#include <QApplication>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QDir>
 #include <QMap>
 #include <QMessageBox>
+#include <QMutexLocker>
 #include <QProgressBar>
+#include <QRunnable>
 #include <QString>
+#include <QThread>
+
+/*! \brief Copies one collected file on the worker pool of CollectForOutput */
+class CollectFileCopy : public QRunnable
+{
+public:
+	CollectFileCopy(CollectForOutput* collect, const QString& oldFile, const QString& newFile) :
+		m_collect(collect),
+		m_oldFile(oldFile),
+		m_newFile(newFile)
+	{
+	}
+
+	void run()
+	{
+		bool skipped = isCurrent();
+		bool success = skipped || copyFileAtomic(m_oldFile, m_newFile);
+		if (!success)
+			qDebug()<<"CollectForOutput::collectFile copyFileAtomic failed for"<<m_oldFile<<"to"<<m_newFile;
+#ifndef Q_OS_WIN32
+		else if (!skipped)
+		{
+			QFile of(m_newFile);
+			if (of.exists())
+			{
+				bool permsSet=of.setPermissions(QFile::permissions(m_oldFile));
+				if (!permsSet)
+					qDebug()<<"Unable to set permissions successfully while collecting for output on"<<m_newFile;
+			}
+			else
+				qDebug()<<"Unable to set permissions successfully while collecting for output on"<<m_newFile<<"as the file does not exist";
+		}
+#endif
+		m_collect->copyFinished(m_oldFile, success);
+	}
+
+private:
+	/* The copy of an earlier collect can be kept if it has the same size and was
+	   made after the last change of the original, or if both have the same content */
+	bool isCurrent() const
+	{
+		QFileInfo oldInfo(m_oldFile);
+		QFileInfo newInfo(m_newFile);
+		if (!newInfo.exists() || (newInfo.size() != oldInfo.size()))
+			return false;
+		if (newInfo.lastModified() >= oldInfo.lastModified())
+			return true;
+		return (fileHash(m_oldFile) == fileHash(m_newFile));
+	}
+
+	static QByteArray fileHash(const QString& fileName)
+	{
+		QFile file(fileName);
+		if (!file.open(QIODevice::ReadOnly))
+			return QByteArray();
+		QCryptographicHash hash(QCryptographicHash::Sha1);
+		if (!hash.addData(&file))
+			return QByteArray();
+		return hash.result();
+	}
+
+	CollectForOutput* m_collect;
+	QString m_oldFile;
+	QString m_newFile;
+};
 
 CollectForOutput::CollectForOutput(ScribusDoc* doc, QString outputDirectory, bool withFonts, bool withProfiles, bool compressDoc)
 	: QObject(ScCore),
@@ -38,7 +108,9 @@ CollectForOutput::CollectForOutput(ScribusDoc* doc, QString outputDirectory, boo
 	itemCount(0),
 	fontCount(0),
 	patternCount(0),
-	uiCollect(false)
+	uiCollect(false),
+	copiesQueued(0),
+	copiesDone(0)
 {
 	m_Doc=doc;
 	if (outputDirectory!=QString::null)
@@ -46,6 +118,9 @@ CollectForOutput::CollectForOutput(ScribusDoc* doc, QString outputDirectory, boo
 	m_compressDoc = compressDoc;
 	m_withFonts = withFonts;
 	m_withProfiles = withProfiles;
+	m_zipArchive = false;
+	// copies mostly wait for the disk or a network share, so use a few threads even on small machines
+	copyPool.setMaxThreadCount(qMax(4, QThread::idealThreadCount()));
 	dirs = PrefsManager::instance()->prefsFile->getContext("dirs");
 	collectedFiles.clear();
 
@@ -70,7 +145,7 @@ bool CollectForOutput::newDirDialog()
 			wdir = dirs->get("collect", prefsDocDir);
 		else
 			wdir = dirs->get("collect", ".");
-		m_outputDirectory = ScCore->primaryMainWindow()->CFileDialog(wdir, tr("Choose a Directory"), "", "", fdDirectoriesOnly, &m_compressDoc, &m_withFonts, &m_withProfiles);
+		m_outputDirectory = ScCore->primaryMainWindow()->CFileDialog(wdir, tr("Choose a Directory"), "", "", fdDirectoriesOnly, &m_compressDoc, &m_withFonts, &m_withProfiles, &m_zipArchive);
 	}
 	if (m_outputDirectory.isEmpty())
 		return false;
@@ -132,10 +207,13 @@ QString CollectForOutput::collect(QString &newFileName)
 	/* collect document must go last because of image paths changes in collectItems() */
 	if (!collectDocument())
 	{
+		waitForCopies();
+		updateWatchedFiles();
 		QString errorMsg( tr("Cannot collect the file: \n%1").arg(newName) );
 		ScMessageBox::warning(ScCore->primaryMainWindow(), CommonStrings::trWarning, "<qt>" + errorMsg + "</qt>");
 		return errorMsg;
 	}
+	finishCopies();
 
 	QDir::setCurrent(m_outputDirectory);
 	ScCore->primaryMainWindow()->updateActiveWindowCaption(newName);
@@ -288,8 +366,7 @@ void CollectForOutput::processItem(PageItem *ite)
 			{
 				QString oldFile = ofName;
 				ite->Pfile = collectFile(oldFile, itf.fileName());
-				ScCore->fileWatcher->removeFile(oldFile);
-				ScCore->fileWatcher->addFile(ite->Pfile);
+				watchedFiles.append(qMakePair(oldFile, ite->Pfile));
 			}
 		}
 	}
@@ -325,8 +402,7 @@ void CollectForOutput::processItem(PageItem *ite)
 					{
 						QString oldFile = ite->Pfile;
 						ite->Pfile = collectFile(oldFile, itf.fileName());
-						ScCore->fileWatcher->removeFile(oldFile);
-						ScCore->fileWatcher->addFile(ite->Pfile);
+						watchedFiles.append(qMakePair(oldFile, ite->Pfile));
 					}
 				}
 			}
@@ -357,23 +433,7 @@ bool CollectForOutput::collectFonts()
 		QFileInfo itf(prefsManager->appPrefs.fontPrefs.AvailFonts[it3.key()].fontFilePath());
 		QString oldFileITF(prefsManager->appPrefs.fontPrefs.AvailFonts[it3.key()].fontFilePath());
 		QString outFileITF(m_outputDirectory + "fonts/" + itf.fileName());
-		bool success = copyFileAtomic(oldFileITF, outFileITF);
-		if (!success)
-			qDebug()<<"CollectForOutput::collectFile copyFileAtomic failed for"<<oldFileITF<<"to"<<outFileITF;
-#ifndef Q_OS_WIN32
-		else
-		{
-			QFile of(outFileITF);
-			if (of.exists())
-			{
-				bool permsSet=of.setPermissions(QFile::permissions(oldFileITF));
-				if (!permsSet)
-					qDebug()<<"Unable to set permissions successfully while collecting for output on"<<outFileITF;
-			}
-			else
-				qDebug()<<"Unable to set permissions successfully while collecting for output on"<<outFileITF<<"as the file does not exist";
-		}
-#endif
+		copyCollectedFile(oldFileITF, outFileITF);
 		if (prefsManager->appPrefs.fontPrefs.AvailFonts[it3.key()].type() == ScFace::TYPE1)
 		{
 			QStringList metrics;
@@ -397,23 +457,7 @@ bool CollectForOutput::collectFonts()
 				QString origAFM = metrics[a];
 				QFileInfo fi(origAFM);
 				QString outFileAFM(m_outputDirectory + "fonts/" + fi.fileName());
-				bool success = copyFileAtomic(origAFM, outFileAFM);
-				if (!success)
-					qDebug()<<"CollectForOutput::collectFile copyFileAtomic failed for"<<origAFM<<"to"<<outFileAFM;
-#ifndef Q_OS_WIN32
-				else
-				{
-					QFile of(outFileAFM);
-					if (of.exists())
-					{
-						bool permsSet=of.setPermissions(QFile::permissions(origAFM));
-						if (!permsSet)
-							qDebug()<<"Unable to set permissions successfully while collecting for output on"<<outFileAFM;
-					}
-					else
-						qDebug()<<"Unable to set permissions successfully while collecting for output on"<<outFileAFM<<"as the file does not exist";
-				}
-#endif
+				copyCollectedFile(origAFM, outFileAFM);
 			}
 		}
 		if (uiCollect)
@@ -473,23 +517,7 @@ bool CollectForOutput::collectProfiles()
 		QString profileName(it.key());
 		QString oldFile(it.value());
 		QString outFile(m_outputDirectory + "profiles/" + QFileInfo(oldFile).fileName());
-		bool success = copyFileAtomic(oldFile, outFile);
-		if (!success)
-			qDebug()<<"CollectForOutput::collectFile copyFileAtomic failed for"<<oldFile<<"to"<<outFile;
-#ifndef Q_OS_WIN32
-		else
-		{
-			QFile of(outFile);
-			if (of.exists())
-			{
-				bool permsSet=of.setPermissions(QFile::permissions(oldFile));
-				if (!permsSet)
-					qDebug()<<"Unable to set permissions successfully while collecting for output on"<<outFile;
-			}
-			else
-				qDebug()<<"Unable to set permissions successfully while collecting for output on"<<outFile<<"as the file does not exist";
-		}
-#endif
+		copyCollectedFile(oldFile, outFile);
 		if (uiCollect)
 			emit profilesCollected(c++);
 	}
@@ -517,24 +545,81 @@ QString CollectForOutput::collectFile(QString oldFile, QString newFile)
 	if (copy)
 	{
 		QString outFile(m_outputDirectory + "images/" + newFile);
-		bool success = copyFileAtomic(oldFile, outFile);
-		if (!success)
-			qDebug()<<"CollectForOutput::collectFile copyFileAtomic failed for"<<oldFile<<"to"<<outFile;
-#ifndef Q_OS_WIN32
-		else
-		{
-			QFile of(outFile);
-			if (of.exists())
-			{
-				bool permsSet=of.setPermissions(QFile::permissions(oldFile));
-				if (!permsSet)
-					qDebug()<<"Unable to set permissions successfully while collecting for output on"<<outFile;
-			}
-			else
-				qDebug()<<"Unable to set permissions successfully while collecting for output on"<<outFile<<"as the file does not exist";
-		}
-#endif
+		copyCollectedFile(oldFile, outFile);
 	}
 	collectedFiles[newFile] = oldFile;
 	return m_outputDirectory + "images/" + newFile;
 }
+
+void CollectForOutput::copyCollectedFile(const QString& oldFile, const QString& newFile)
+{
+	// faces of a font collection and Type1 faces sharing a metrics file map to the same target
+	if (queuedCopies.contains(newFile))
+		return;
+	queuedCopies.insert(newFile);
+	++copiesQueued;
+	copyPool.start(new CollectFileCopy(this, oldFile, newFile));
+}
+
+void CollectForOutput::copyFinished(const QString& oldFile, bool success)
+{
+	QMutexLocker locker(&copyMutex);
+	++copiesDone;
+	if (!success)
+		copyErrors.append(oldFile);
+}
+
+bool CollectForOutput::waitForCopies()
+{
+	while (!copyPool.waitForDone(100))
+	{
+		copyMutex.lock();
+		int done = copiesDone;
+		copyMutex.unlock();
+		if (uiCollect)
+			emit filesCopied(done);
+		if (ScCore->usingGUI())
+			qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
+	}
+	if (uiCollect)
+		emit filesCopied(copiesQueued);
+	return copyErrors.isEmpty();
+}
+
+bool CollectForOutput::finishCopies()
+{
+	bool copied = waitForCopies();
+	updateWatchedFiles();
+	if (!copied)
+	{
+		QString errorMsg( tr("Cannot collect all files for output for file:\n%1").arg(newName) );
+		ScMessageBox::warning(ScCore->primaryMainWindow(), CommonStrings::trWarning,
+							 "<qt>" + errorMsg + "<br>" + copyErrors.join("<br>") + "</qt>");
+	}
+	if (m_zipArchive && !createZipArchive())
+	{
+		ScMessageBox::warning(ScCore->primaryMainWindow(), CommonStrings::trWarning,
+							 "<qt>" + tr("Cannot create the zip archive of:\n%1").arg(m_outputDirectory) + "</qt>");
+	}
+	return copied;
+}
+
+void CollectForOutput::updateWatchedFiles()
+{
+	for (int i = 0; i < watchedFiles.count(); ++i)
+	{
+		ScCore->fileWatcher->removeFile(watchedFiles[i].first);
+		ScCore->fileWatcher->addFile(watchedFiles[i].second);
+	}
+	watchedFiles.clear();
+}
+
+bool CollectForOutput::createZipArchive()
+{
+	QString dirName = m_outputDirectory.left(m_outputDirectory.length() - 1);
+	ScZipHandler zip(true);
+	if (!zip.open(dirName + ".zip"))
+		return false;
+	bool written = zip.write(dirName);
+	return zip.close() && written;
+}
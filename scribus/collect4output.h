@@ -9,6 +9,11 @@ for which a new license (GPL+exception) is in place.
 
 #include <QObject>
 #include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
 
 #include "scribusstructs.h"
 
@@ -16,12 +21,17 @@ class QString;
 class ScribusDoc;
 class PrefsContext;
 class PageItem;
+class CollectFileCopy;
 
 
 /*! \brief Performs "Collect for Output" tasks.
 collect() method copies the document, fonts and images
 into user defined directory. QObject inheritance mainly due
 moc speedup and tr() methods.
+Files are copied on a pool of worker threads while the document
+is scanned. A file whose copy from an earlier collect is still
+current is not copied again, so an interrupted collect can simply
+be repeated.
 \author Petr Vanek, Franz Schmid
 */
 class CollectForOutput : public QObject
@@ -36,7 +46,7 @@ class CollectForOutput : public QObject
 		\param compressDoc use gzipped document
 		*/
 		CollectForOutput(ScribusDoc* doc, QString outputDirectory=QString::null, bool withFonts=false, bool withProfiles=false, bool compressDoc=false);
-		~CollectForOutput(){};
+		~CollectForOutput() { copyPool.waitForDone(); };
 
 		/*! \brief Main method doing everything.
 		It calls all related methods
@@ -52,6 +62,8 @@ class CollectForOutput : public QObject
 		bool m_withFonts;
 		/*! Collect icc profiles too. See the constructor */
 		bool m_withProfiles;
+		/*! Pack the output directory into a zip archive when done */
+		bool m_zipArchive;
 		/*! User defined directory via GUI */
 		QString m_outputDirectory;
 		/*! Name of the moved file with the new directory path */
@@ -91,6 +103,19 @@ class CollectForOutput : public QObject
 		\retval QString really used fullpath of the new file
 		*/
 		QString collectFile(QString oldFile, QString newFile);
+		/*! \brief Queue copying oldFile to newFile on the worker pool. */
+		void copyCollectedFile(const QString& oldFile, const QString& newFile);
+		/*! \brief Wait for all queued copies, reporting progress with filesCopied().
+		\retval true if all files were copied */
+		bool waitForCopies();
+		/*! \brief Wait for the copies, report failed ones and create the zip archive if requested.
+		\retval true if all files were copied */
+		bool finishCopies();
+		/*! \brief Point the file watcher to the collected images once they exist */
+		void updateWatchedFiles();
+		/*! \brief Pack the output directory into a zip archive next to it.
+		\retval true on success */
+		bool createZipArchive();
 
 		ProfilesL docProfiles;
 		QStringList patterns;
@@ -100,11 +125,28 @@ class CollectForOutput : public QObject
 		int patternCount;
 		bool uiCollect;
 
+		/*! Worker pool copying the collected files */
+		QThreadPool copyPool;
+		QMutex copyMutex;
+		int copiesQueued;
+		int copiesDone;
+		/*! Target paths already queued, so that no two tasks write the same file */
+		QSet<QString> queuedCopies;
+		QStringList copyErrors;
+		/*! Images to move in the file watcher, old and new name */
+		QList<QPair<QString, QString> > watchedFiles;
+
+	private:
+		friend class CollectFileCopy;
+		/*! Called by the copy tasks from the worker threads */
+		void copyFinished(const QString& oldFile, bool success);
+
 	signals:
 		void fontsCollected(int);
 		void patternsCollected(int);
 		void profilesCollected(int);
 		void itemsCollected(int);
+		void filesCopied(int);
 };
 
 #endif
@@ -5,6 +5,7 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
+#include <QHash>
 #include "sccolormgmtstructs.h"
 
 bool operator==(const ScColorTransformInfo& v1, const ScColorTransformInfo& v2)
@@ -19,6 +20,19 @@ bool operator==(const ScColorTransformInfo& v1, const ScColorTransformInfo& v2)
 			(v1.flags  == v2.flags));
 }
 
+uint qHash(const ScColorTransformInfo& info, uint seed)
+{
+	uint hash = qHash(info.inputProfile, seed);
+	hash = 31 * hash + qHash(info.outputProfile, seed);
+	hash = 31 * hash + qHash(info.proofingProfile, seed);
+	hash = 31 * hash + static_cast<uint>(info.inputFormat);
+	hash = 31 * hash + static_cast<uint>(info.outputFormat);
+	hash = 31 * hash + static_cast<uint>(info.renderIntent);
+	hash = 31 * hash + static_cast<uint>(info.proofingIntent);
+	hash = 31 * hash + static_cast<uint>(info.flags);
+	return hash;
+}
+
 eColorType colorFormatType(eColorFormat format)
 {
 	eColorType type = Color_Unknown;
@@ -124,6 +124,7 @@ typedef struct
 } ScColorTransformInfo;
 
 bool operator==(const ScColorTransformInfo& v1, const ScColorTransformInfo& v2);
+uint qHash(const ScColorTransformInfo& info, uint seed = 0);
 
 eColorType colorFormatType(eColorFormat format);
 uint       colorFormatNumChannels(eColorFormat format);
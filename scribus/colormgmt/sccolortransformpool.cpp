@@ -10,7 +10,7 @@ for which a new license (GPL+exception) is in place.
 #include "sccolormgmtstructs.h"
 #include "sccolortransformpool.h"
 
-ScColorTransformPool::ScColorTransformPool(int engineID) : m_engineID(engineID)
+ScColorTransformPool::ScColorTransformPool(int engineID) : m_engineID(engineID), m_useCounter(0), m_recentCount(0)
 {
 
 }
@@ -18,6 +18,7 @@ ScColorTransformPool::ScColorTransformPool(int engineID) : m_engineID(engineID)
 void ScColorTransformPool::clear(void)
 {
 	m_pool.clear();
+	m_recentCount = 0;
 }
 
 void ScColorTransformPool::addTransform(const ScColorTransform& transform, bool force)
@@ -29,47 +30,88 @@ void ScColorTransformPool::addTransform(const ScColorTransform& transform, bool
 	ScColorTransform trans;
 	if (!force)
 		trans = findTransform(transform.transformInfo());
-	if (trans.isNull())
-		m_pool.append(transform.weakRef());
+	if (!trans.isNull())
+		return;
+	PoolEntry& entry = m_pool[transform.transformInfo()];
+	if (entry.recent.isNull())
+		++m_recentCount;
+	entry.transform = transform.weakRef();
+	entry.recent    = transform.strongRef();
+	entry.lastUse   = ++m_useCounter;
+	if (m_recentCount > MaxRecentTransforms)
+		releaseOldest();
 }
 
 void ScColorTransformPool::removeTransform(const ScColorTransform& transform)
 {
 	if (m_engineID != transform.engine().engineID())
 		return;
-	m_pool.removeOne(transform.strongRef());
+	QHash<ScColorTransformInfo, PoolEntry>::Iterator it = m_pool.find(transform.transformInfo());
+	if ((it == m_pool.end()) || (it->transform != transform.strongRef()))
+		return;
+	if (!it->recent.isNull())
+		--m_recentCount;
+	m_pool.erase(it);
 }
 
 void ScColorTransformPool::removeTransform(const ScColorTransformInfo& info)
 {
-	QList< QWeakPointer<ScColorTransformData> >::Iterator it = m_pool.begin();
-	while (it != m_pool.end())
-	{
-		QSharedPointer<ScColorTransformData> ref = it->toStrongRef();
-		if ((info == ref->transformInfo()) || ref.isNull())
-		{
-			it = m_pool.erase(it);
-			continue;
-		}
-		++it;
-	}
+	QHash<ScColorTransformInfo, PoolEntry>::Iterator it = m_pool.find(info);
+	if (it == m_pool.end())
+		return;
+	if (!it->recent.isNull())
+		--m_recentCount;
+	m_pool.erase(it);
 }
 
 ScColorTransform ScColorTransformPool::findTransform(const ScColorTransformInfo& info) const
 {
 	ScColorTransform transform(NULL);
-	QList< QWeakPointer<ScColorTransformData> >::ConstIterator it = m_pool.begin();
-	for ( ; it != m_pool.end(); ++it)
+	QHash<ScColorTransformInfo, PoolEntry>::Iterator it = m_pool.find(info);
+	if (it == m_pool.end())
+		return transform;
+	QSharedPointer<ScColorTransformData> ref = it->transform.toStrongRef();
+	if (ref.isNull())
+	{
+		m_pool.erase(it);
+		return transform;
+	}
+	// Transforms released from the recent list are taken back when used again,
+	// the list is trimmed on the next addTransform()
+	if (it->recent.isNull())
 	{
-		QSharedPointer<ScColorTransformData> ref = it->toStrongRef();
-		if (!ref.isNull())
+		it->recent = ref;
+		++m_recentCount;
+	}
+	it->lastUse = ++m_useCounter;
+	transform = ScColorTransform(ref);
+	return transform;
+}
+
+void ScColorTransformPool::releaseOldest(void)
+{
+	// Called only when a new transform is created, which is much more
+	// expensive than this scan, so no separate LRU list is maintained.
+	while (m_recentCount > MaxRecentTransforms)
+	{
+		QHash<ScColorTransformInfo, PoolEntry>::Iterator oldest = m_pool.end();
+		QHash<ScColorTransformInfo, PoolEntry>::Iterator it = m_pool.begin();
+		while (it != m_pool.end())
 		{
-			if (info == ref->transformInfo())
+			if (it->transform.isNull())
 			{
-				transform = ScColorTransform(ref);
-				break;
+				if (!it->recent.isNull())
+					--m_recentCount;
+				it = m_pool.erase(it);
+				continue;
 			}
+			if (!it->recent.isNull() && ((oldest == m_pool.end()) || (it->lastUse < oldest->lastUse)))
+				oldest = it;
+			++it;
 		}
+		if (oldest == m_pool.end())
+			break;
+		oldest->recent.clear();
+		--m_recentCount;
 	}
-	return transform;
-}
\ No newline at end of file
+}
@@ -8,11 +8,18 @@ for which a new license (GPL+exception) is in place.
 #ifndef SCCOLORTRANSFORMPOOL_H
 #define SCCOLORTRANSFORMPOOL_H
 
-#include <QList>
+#include <QHash>
+#include <QSharedPointer>
 #include <QWeakPointer>
 #include "sccolormgmtstructs.h"
 #include "sccolortransform.h"
 
+/*
+ Transforms are indexed by their ScColorTransformInfo. The most recently
+ used ones are additionally kept alive by the pool, so that a transform
+ needed again and again by short lived objects (image loading, color
+ conversion during export) is not rebuilt each time its last user dies.
+*/
 class ScColorTransformPool
 {
 	friend class ScColorMgmtEngineData;
@@ -27,9 +34,23 @@ public:
 
 	ScColorTransform findTransform(const ScColorTransformInfo& info) const;
 
+	/// Maximum number of transforms kept alive by the pool itself
+	static const int MaxRecentTransforms = 64;
+
 protected:
+	struct PoolEntry
+	{
+		QWeakPointer<ScColorTransformData>   transform;
+		QSharedPointer<ScColorTransformData> recent;
+		quint64 lastUse;
+	};
+
 	int m_engineID;
-	QList< QWeakPointer<ScColorTransformData> > m_pool;
+	mutable QHash<ScColorTransformInfo, PoolEntry> m_pool;
+	mutable quint64 m_useCounter;
+	mutable int m_recentCount;
+
+	void releaseOldest(void);
 };
 
 #endif
@@ -24,10 +24,53 @@ for which a new license (GPL+exception) is in place.
 #ifndef DOCUMENTCHECKER_H
 #define DOCUMENTCHECKER_H
 
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMap>
+
 #include "scribusapi.h"
 #include "scribusstructs.h"
 
+class PageItem;
 class ScribusDoc;
+struct CheckerPrefs;
+
+/*! \brief Item results of the last preflight check of a document.
+Each document owns one. Items drop their result when they report a change
+(item updates, selection edits, undo, image loading, text layout),
+so the next DocumentChecker::checkItems() run evaluates only those again.
+A result is also not reused when the page the item belongs to changed,
+as OwnPage is assigned in many places without notifying the item.
+All results are dropped when the check profile, the color management
+settings or the document colors differ from the last run, and when
+the pages are laid out again (ScribusDoc::reformPages()).
+*/
+class SCRIBUS_API DocumentCheckerCache
+{
+	friend class DocumentChecker;
+
+	public:
+		DocumentCheckerCache() : m_suspended(false) {}
+		//! Forget the result of item, it is checked again by the next run
+		void itemChanged(PageItem* item) { if (!m_suspended) m_items.remove(item); }
+		//! Ignore item changes, for temporary moves which are undone right away
+		void setSuspended(bool suspended) { m_suspended = suspended; }
+		//! Forget all results
+		void clear() { m_items.clear(); m_signature.clear(); }
+
+	private:
+		struct Entry
+		{
+			Entry() : uniqueNr(0), ownPage(-1) {}
+			uint uniqueNr; // guards against a new item allocated at the address of a deleted one
+			int ownPage;
+			errorCodes errors;
+		};
+		QHash<PageItem*, Entry> m_items;
+		QByteArray m_signature;
+		bool m_suspended;
+};
 
 /*! \brief It create a error/warning list for CheckDocument GUI class.
 All errors and/or warnings are stored in errorCodes (inheritted QMap
@@ -41,7 +84,14 @@ class SCRIBUS_API DocumentChecker
 		static bool checkDocument(ScribusDoc *currDoc);
 		static void checkPages(ScribusDoc *currDoc, struct CheckerPrefs checkerSettings);
 		static void checkLayers(ScribusDoc *currDoc, struct CheckerPrefs checkerSettings);
+		//! Check items which changed since the last run, see DocumentCheckerCache
 		static void checkItems(ScribusDoc *currDoc, struct CheckerPrefs checkerSettings);
+		//! Check one item, errors found are stored in itemError
+		static void checkItem(ScribusDoc *currDoc, PageItem *currItem, const CheckerPrefs& checkerSettings, errorCodes& itemError);
+
+	private:
+		static void checkItemList(ScribusDoc *currDoc, const CheckerPrefs& checkerSettings, const QList<PageItem*>& items, QMap<PageItem*, errorCodes>& itemErrors, QHash<PageItem*, DocumentCheckerCache::Entry>& checkedItems);
+		static QByteArray checkerSignature(ScribusDoc *currDoc, const CheckerPrefs& checkerSettings);
 };
 
 #endif
@@ -289,6 +289,17 @@ bool FileLoader::saveFile(const QString& fileName, ScribusDoc *doc, QString *sav
 	return ret;
 }
 
+bool FileLoader::saveToBuffer(const QString& fileName, ScribusDoc *doc, QByteArray& data)
+{
+	QList<FileFormat>::const_iterator it;
+	if (findFormat(FORMATID_SLA150EXPORT, it))
+	{
+		it->setupTargets(doc, doc->view(), doc->scMW(), doc->scMW()->mainWindowProgressBar, &(m_prefsManager->appPrefs.fontPrefs.AvailFonts));
+		return it->saveToBuffer(fileName, data);
+	}
+	return false;
+}
+
 bool FileLoader::readStyles(ScribusDoc* doc, StyleSet<ParagraphStyle> &docParagraphStyles)
 {
 	QList<FileFormat>::const_iterator it;
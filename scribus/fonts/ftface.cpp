@@ -130,6 +130,20 @@ void FtFace::load() const
 //FIXME:	FT_Set_Charmap(m_face, m_face->charmaps[m_encoding]);
 	setBestEncoding(m_face);
 	
+	// the glyph check below loads every glyph, skip it if the font didn't change
+	if (!m_glyphCache.isOpen())
+		m_glyphCache.open(fontFile, faceIndex);
+	ScFace::gid_type cachedMaxGlyph = 0;
+	bool cachedStroked = false, cachedBroken = false;
+	if (m_glyphCache.faceInfo(cachedMaxGlyph, cachedStroked, cachedBroken))
+	{
+		const_cast<FtFace*>(this)->maxGlyph = qMax(maxGlyph, cachedMaxGlyph);
+		const_cast<FtFace*>(this)->isStroked = cachedStroked;
+		if (cachedBroken)
+			status = ScFace::BROKENGLYPHS;
+		return;
+	}
+
 	FT_UInt gindex = 0;
 	FT_ULong charcode = FT_Get_First_Char( m_face, &gindex );
 	int goodGlyph = 0;
@@ -158,6 +172,7 @@ void FtFace::load() const
 	if (invalidGlyph > 0) {
 		status = ScFace::BROKENGLYPHS;
 	}
+	m_glyphCache.setFaceInfo(maxGlyph, isStroked, invalidGlyph > 0);
 }
 
 
@@ -167,6 +182,7 @@ void FtFace::unload() const
 		FT_Done_Face( m_face );
 		m_face = NULL;
 	}
+	m_glyphCache.close();
 	// clear caches
 	ScFaceData::unload();
 }
@@ -187,6 +203,18 @@ void FtFace::loadGlyph(ScFace::gid_type gl) const
 		return;
 
 	ScFace::GlyphData GRec;
+	qreal cachedWidth;
+	if (!m_glyphCache.isOpen())
+		m_glyphCache.open(fontFile, faceIndex);
+	if (m_glyphCache.glyph(gl, cachedWidth, GRec))
+	{
+		m_glyphWidth[gl] = cachedWidth;
+		m_glyphOutline[gl] = GRec;
+		if (GRec.broken && status < ScFace::BROKENGLYPHS)
+			status = ScFace::BROKENGLYPHS;
+		return;
+	}
+
 	FT_Face face = ftFace();
 	if (FT_Load_Glyph( face, gl, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP ))
 	{
@@ -224,6 +252,7 @@ void FtFace::loadGlyph(ScFace::gid_type gl) const
 		}
 	}
 	m_glyphOutline[gl] = GRec;
+	m_glyphCache.addGlyph(gl, m_glyphWidth[gl], GRec);
 	if (GRec.broken && status < ScFace::BROKENGLYPHS)
 		status = ScFace::BROKENGLYPHS;
 }
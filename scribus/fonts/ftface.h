@@ -14,6 +14,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusapi.h"
 
 #include "fonts/scface.h"
+#include "fonts/scglyphcache.h"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -96,6 +97,8 @@ struct SCRIBUS_API FtFace : public ScFace::ScFaceData
 
 protected:
 	mutable FT_Face m_face;
+	/// glyphs and face checks from previous sessions
+	mutable ScGlyphCache m_glyphCache;
 
 	static FT_Library m_library;
 
@@ -0,0 +1,260 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "fonts/scglyphcache.h"
+
+#include <cstring>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMap>
+#include <QSaveFile>
+
+#include "scpaths.h"
+
+ScGlyphCache::ScGlyphCache()
+	: m_faceIndex(0),
+	  m_modified(0),
+	  m_size(0),
+	  m_map(NULL),
+	  m_mapSize(0),
+	  m_glyphCount(0),
+	  m_maxGlyph(0),
+	  m_flags(0),
+	  m_dirty(false)
+{
+}
+
+ScGlyphCache::~ScGlyphCache()
+{
+	close();
+}
+
+QString ScGlyphCache::cacheFileName() const
+{
+	QByteArray key = QFile::encodeName(m_fontFile) + ':' + QByteArray::number(m_faceIndex);
+	QByteArray hash = QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex();
+	return ScPaths::getGlyphCacheDir() + QString::fromLatin1(hash) + ".sgc";
+}
+
+void ScGlyphCache::open(const QString& fontFile, int faceIndex)
+{
+	close();
+	QFileInfo fi(fontFile);
+	m_fontFile = fontFile;
+	m_faceIndex = faceIndex;
+	m_modified = fi.lastModified().toMSecsSinceEpoch();
+	m_size = fi.size();
+
+	m_file.setFileName(cacheFileName());
+	if (!m_file.open(QIODevice::ReadOnly))
+		return;
+	qint64 fileSize = m_file.size();
+	if (fileSize < static_cast<qint64>(sizeof(Header)))
+	{
+		m_file.close();
+		return;
+	}
+	m_map = m_file.map(0, fileSize);
+	if (!m_map)
+	{
+		m_file.close();
+		return;
+	}
+	m_mapSize = fileSize;
+
+	Header header;
+	memcpy(&header, m_map, sizeof(Header));
+	qint64 indexEnd = sizeof(Header) + static_cast<qint64>(header.glyphCount) * sizeof(IndexEntry);
+	if (memcmp(header.magic, "SGCF", 4) != 0 || header.version != Version
+		|| header.modified != m_modified || header.size != m_size || indexEnd > m_mapSize)
+	{
+		// font file changed or cache from another version, rebuild it
+		unmap();
+		return;
+	}
+	m_glyphCount = header.glyphCount;
+	m_maxGlyph = header.maxGlyph;
+	m_flags = header.flags;
+}
+
+void ScGlyphCache::unmap()
+{
+	if (m_map)
+		m_file.unmap(m_map);
+	m_file.close();
+	m_map = NULL;
+	m_mapSize = 0;
+	m_glyphCount = 0;
+}
+
+void ScGlyphCache::close()
+{
+	if (m_dirty)
+	{
+		// merge with the glyphs already on disk, sorted by glyph id for lookup
+		QMap<ScFace::gid_type, QPair<qreal, ScFace::GlyphData> > glyphs;
+		for (quint32 i = 0; i < m_glyphCount; ++i)
+		{
+			ScFace::gid_type gl;
+			qreal width;
+			ScFace::GlyphData data;
+			if (readMapped(i, gl, width, data))
+				glyphs.insert(gl, qMakePair(width, data));
+		}
+		QHash<ScFace::gid_type, QPair<qreal, ScFace::GlyphData> >::const_iterator it;
+		for (it = m_added.constBegin(); it != m_added.constEnd(); ++it)
+			glyphs.insert(it.key(), it.value());
+		unmap();
+
+		QDir().mkpath(ScPaths::getGlyphCacheDir());
+		QSaveFile out(cacheFileName());
+		if (out.open(QIODevice::WriteOnly))
+		{
+			Header header;
+			memcpy(header.magic, "SGCF", 4);
+			header.version = Version;
+			header.modified = m_modified;
+			header.size = m_size;
+			header.maxGlyph = m_maxGlyph;
+			header.flags = m_flags;
+			header.glyphCount = glyphs.count();
+			header.reserved = 0;
+			out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+			quint32 offset = sizeof(Header) + glyphs.count() * sizeof(IndexEntry);
+			QMap<ScFace::gid_type, QPair<qreal, ScFace::GlyphData> >::const_iterator git;
+			for (git = glyphs.constBegin(); git != glyphs.constEnd(); ++git)
+			{
+				IndexEntry entry;
+				entry.glyph = git.key();
+				entry.offset = offset;
+				out.write(reinterpret_cast<const char*>(&entry), sizeof(IndexEntry));
+				offset += sizeof(GlyphRecord) + git.value().second.Outlines.size() * 2 * sizeof(double);
+			}
+			for (git = glyphs.constBegin(); git != glyphs.constEnd(); ++git)
+			{
+				const ScFace::GlyphData& data(git.value().second);
+				GlyphRecord record;
+				record.width = git.value().first;
+				record.bboxWidth = data.bbox_width;
+				record.bboxAscent = data.bbox_ascent;
+				record.bboxDescent = data.bbox_descent;
+				record.x = data.x;
+				record.y = data.y;
+				record.broken = data.broken;
+				record.pointCount = data.Outlines.size();
+				out.write(reinterpret_cast<const char*>(&record), sizeof(GlyphRecord));
+				for (int i = 0; i < data.Outlines.size(); ++i)
+				{
+					const FPoint& p(data.Outlines.point(i));
+					double xy[2] = { p.x(), p.y() };
+					out.write(reinterpret_cast<const char*>(xy), sizeof(xy));
+				}
+			}
+			out.commit();
+		}
+	}
+	unmap();
+	m_fontFile.clear();
+	m_added.clear();
+	m_maxGlyph = 0;
+	m_flags = 0;
+	m_dirty = false;
+}
+
+bool ScGlyphCache::faceInfo(ScFace::gid_type& maxGlyph, bool& stroked, bool& brokenGlyphs) const
+{
+	if (!(m_flags & FaceInfo))
+		return false;
+	maxGlyph = m_maxGlyph;
+	stroked = m_flags & Stroked;
+	brokenGlyphs = m_flags & BrokenGlyphs;
+	return true;
+}
+
+void ScGlyphCache::setFaceInfo(ScFace::gid_type maxGlyph, bool stroked, bool brokenGlyphs)
+{
+	if (!isOpen())
+		return;
+	m_maxGlyph = maxGlyph;
+	m_flags = FaceInfo;
+	if (stroked)
+		m_flags |= Stroked;
+	if (brokenGlyphs)
+		m_flags |= BrokenGlyphs;
+	m_dirty = true;
+}
+
+bool ScGlyphCache::readMapped(int index, ScFace::gid_type& gl, qreal& width, ScFace::GlyphData& data) const
+{
+	IndexEntry entry;
+	memcpy(&entry, m_map + sizeof(Header) + index * sizeof(IndexEntry), sizeof(IndexEntry));
+	if (entry.offset + static_cast<qint64>(sizeof(GlyphRecord)) > m_mapSize)
+		return false;
+	GlyphRecord record;
+	memcpy(&record, m_map + entry.offset, sizeof(GlyphRecord));
+	const uchar* points = m_map + entry.offset + sizeof(GlyphRecord);
+	if (points - m_map + static_cast<qint64>(record.pointCount) * 2 * sizeof(double) > m_mapSize)
+		return false;
+
+	gl = entry.glyph;
+	width = record.width;
+	data.bbox_width = record.bboxWidth;
+	data.bbox_ascent = record.bboxAscent;
+	data.bbox_descent = record.bboxDescent;
+	data.x = record.x;
+	data.y = record.y;
+	data.broken = record.broken;
+	data.Outlines.resize(record.pointCount);
+	for (quint32 i = 0; i < record.pointCount; ++i)
+	{
+		double xy[2];
+		memcpy(xy, points + i * sizeof(xy), sizeof(xy));
+		data.Outlines.setPoint(i, xy[0], xy[1]);
+	}
+	return true;
+}
+
+bool ScGlyphCache::glyph(ScFace::gid_type gl, qreal& width, ScFace::GlyphData& data) const
+{
+	QHash<ScFace::gid_type, QPair<qreal, ScFace::GlyphData> >::const_iterator it = m_added.constFind(gl);
+	if (it != m_added.constEnd())
+	{
+		width = it.value().first;
+		data = it.value().second;
+		return true;
+	}
+	int lo = 0;
+	int hi = m_glyphCount;
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
+		IndexEntry entry;
+		memcpy(&entry, m_map + sizeof(Header) + mid * sizeof(IndexEntry), sizeof(IndexEntry));
+		if (entry.glyph == gl)
+		{
+			ScFace::gid_type found;
+			return readMapped(mid, found, width, data);
+		}
+		if (entry.glyph < gl)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return false;
+}
+
+void ScGlyphCache::addGlyph(ScFace::gid_type gl, qreal width, const ScFace::GlyphData& data)
+{
+	if (!isOpen())
+		return;
+	m_added.insert(gl, qMakePair(width, data));
+	m_dirty = true;
+}
@@ -0,0 +1,103 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCGLYPHCACHE_H
+#define SCGLYPHCACHE_H
+
+#include <QFile>
+#include <QHash>
+#include <QPair>
+#include <QString>
+
+#include "scribusapi.h"
+#include "fonts/scface.h"
+
+/*! \brief On disk cache of glyph metrics and outlines for one font face.
+
+The cache file is memory mapped and glyphs are decoded only when a face asks
+for them, so opening a document doesn't depend on the size of the cache.
+Like the checkedFonts cache in SCFonts, the file is tied to the font file's
+path and modification date and silently discarded when the font changes.
+Glyphs loaded from FreeType are collected in memory and merged into the file
+by close().
+
+File layout, in native byte order:
+  header, glyphCount index entries sorted by glyph id, glyph records.
+A glyph record holds width, bbox and origin followed by its outline points.
+*/
+class SCRIBUS_API ScGlyphCache
+{
+public:
+	ScGlyphCache();
+	~ScGlyphCache();
+
+	/// Maps the cache of face faceIndex in fontFile, if there is a valid one.
+	void open(const QString& fontFile, int faceIndex);
+	/// Writes glyphs added since open() back to disk and unmaps the file.
+	void close();
+	bool isOpen() const { return !m_fontFile.isEmpty(); }
+
+	/// Face information computed by FtFace::load(), returns false if not cached.
+	bool faceInfo(ScFace::gid_type& maxGlyph, bool& stroked, bool& brokenGlyphs) const;
+	void setFaceInfo(ScFace::gid_type maxGlyph, bool stroked, bool brokenGlyphs);
+
+	/// Looks up glyph gl, returns false if it is not cached.
+	bool glyph(ScFace::gid_type gl, qreal& width, ScFace::GlyphData& data) const;
+	void addGlyph(ScFace::gid_type gl, qreal width, const ScFace::GlyphData& data);
+
+private:
+	struct Header
+	{
+		char    magic[4];
+		quint32 version;
+		qint64  modified;
+		qint64  size;
+		quint32 maxGlyph;
+		quint32 flags;
+		quint32 glyphCount;
+		quint32 reserved;
+	};
+	struct IndexEntry
+	{
+		quint32 glyph;
+		quint32 offset;
+	};
+	struct GlyphRecord
+	{
+		double  width;
+		double  bboxWidth;
+		double  bboxAscent;
+		double  bboxDescent;
+		double  x;
+		double  y;
+		quint32 broken;
+		quint32 pointCount;
+	};
+	enum Flags { FaceInfo = 1, Stroked = 2, BrokenGlyphs = 4 };
+	static const quint32 Version = 1;
+
+	QString cacheFileName() const;
+	bool readMapped(int index, ScFace::gid_type& gl, qreal& width, ScFace::GlyphData& data) const;
+	void unmap();
+
+	QString m_fontFile;
+	int     m_faceIndex;
+	qint64  m_modified;
+	qint64  m_size;
+
+	QFile   m_file;
+	uchar*  m_map;
+	qint64  m_mapSize;
+	quint32 m_glyphCount;
+
+	ScFace::gid_type m_maxGlyph;
+	quint32 m_flags;
+	bool    m_dirty;
+	QHash<ScFace::gid_type, QPair<qreal, ScFace::GlyphData> > m_added;
+};
+
+#endif
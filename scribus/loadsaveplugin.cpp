@@ -219,6 +219,12 @@ bool LoadSavePlugin::saveFile(const QString & /* fileName */,
 	return false;
 }
 
+bool LoadSavePlugin::saveToBuffer(const QString & /* fileName */,
+							  QByteArray & /* data */)
+{
+	return false;
+}
+
 bool LoadSavePlugin::loadElements(const QString & data, QString fileDir, int toLayer, double Xp_in, double Yp_in, bool loc)
 {
 	return false;
@@ -459,6 +465,11 @@ bool FileFormat::saveFile(const QString & fileName) const
 	return (plug && save) ? plug->saveFile(fileName, *this) : false;
 }
 
+bool FileFormat::saveToBuffer(const QString & fileName, QByteArray & data) const
+{
+	return (plug && save) ? plug->saveToBuffer(fileName, data) : false;
+}
+
 bool FileFormat::savePalette(const QString & fileName) const
 {
 	return (plug && save) ? plug->savePalette(fileName) : false;
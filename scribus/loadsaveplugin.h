@@ -86,6 +86,10 @@ class SCRIBUS_API LoadSavePlugin : public ScPlugin
 
 		// Save the requested format to the requested path.
 		virtual bool saveFile(const QString & fileName, const FileFormat & fmt);
+		// Serialize the document as saveFile() would write it to fileName, but into data,
+		// so that the disk can be written without the document (see ScFileWriter).
+		// Default implementation always reports failure.
+		virtual bool saveToBuffer(const QString & fileName, QByteArray & data);
 		virtual bool savePalette(const QString & fileName);
 		virtual QString saveElements(double xp, double yp, double wp, double hp, Selection* selection, QByteArray &prevData);
 
@@ -201,6 +205,7 @@ class SCRIBUS_API FileFormat
 		bool loadPalette(const QString & fileName) const;
 		// Save a file with this format
 		bool saveFile(const QString & fileName) const;
+		bool saveToBuffer(const QString & fileName, QByteArray & data) const;
 		bool savePalette(const QString & fileName) const;
 		QString saveElements(double xp, double yp, double wp, double hp, Selection* selection, QByteArray &prevData) const;
 		// Get last saved file
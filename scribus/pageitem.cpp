@@ -911,6 +911,7 @@ bool PageItem::isTableCell() const
 void PageItem::setXPos(const double newXPos, bool drawingOnly)
 {
 	m_xPos = newXPos;
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -919,6 +920,7 @@ void PageItem::setXPos(const double newXPos, bool drawingOnly)
 void PageItem::setYPos(const double newYPos, bool drawingOnly)
 {
 	m_yPos = newYPos;
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -928,6 +930,7 @@ void PageItem::setXYPos(const double newXPos, const double newYPos, bool drawing
 {
 	m_xPos = newXPos;
 	m_yPos = newYPos;
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -966,6 +969,7 @@ void PageItem::moveBy(const double dX, const double dY, bool drawingOnly)
 		gYpos += dY;
 		BoundingY += dY;
 	}
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	moveWelded(dX, dY);
@@ -976,6 +980,7 @@ void PageItem::setWidth(const double newWidth)
 {
 	m_width = newWidth;
 	updateConstants();
+	m_Doc->itemGeometryChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -985,6 +990,7 @@ void PageItem::setHeight(const double newHeight)
 {
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemGeometryChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -995,6 +1001,7 @@ void PageItem::setWidthHeight(const double newWidth, const double newHeight, boo
 	m_width = newWidth;
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly)
 		return;
 	checkChanges();
@@ -1005,6 +1012,7 @@ void PageItem::setWidthHeight(const double newWidth, const double newHeight)
 	m_width = newWidth;
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemGeometryChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -1019,6 +1027,7 @@ void PageItem::resizeBy(const double dH, const double dW)
 	if (dW!=0.0)
 		m_height+=dW;
 	updateConstants();
+	m_Doc->itemGeometryChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -1029,6 +1038,7 @@ void PageItem::setRotation(const double newRotation, bool drawingOnly)
 	double dR = newRotation - m_rotation;
 	double oldRot = m_rotation;
 	m_rotation = newRotation;
+	m_Doc->itemGeometryChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	rotateWelded(dR, oldRot);
@@ -1040,6 +1050,7 @@ void PageItem::rotateBy(const double dR)
 	if (dR==0.0)
 		return;
 	m_rotation+=dR;
+	m_Doc->itemGeometryChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -2537,6 +2548,20 @@ QString PageItem::ExpandToken(uint base)
 	return chstr;
 }
 
+bool PageItem::hasPageDependentText() const
+{
+	int len = itemText.length();
+	for (int i = 0; i < len; ++i)
+	{
+		QChar ch = itemText.text(i);
+		if ((ch == SpecialChars::PAGENUMBER) || (ch == SpecialChars::PAGECOUNT))
+			return true;
+		if ((ch == SpecialChars::OBJECT) && itemText.hasMark(i))
+			return true;
+	}
+	return false;
+}
+
 void PageItem::SetQColor(QColor *tmp, QString colorName, double shad)
 {
 	if (colorName == CommonStrings::None)
@@ -4150,6 +4175,7 @@ void PageItem::setLineWidth(double newWidth)
 	}
 	Oldm_lineWidth=m_lineWidth;
 	m_lineWidth = newWidth;
+	m_Doc->itemGeometryChanged(this);
 }
 
 void PageItem::setLineEnd(Qt::PenCapStyle newStyle)
@@ -4805,6 +4831,26 @@ void PageItem::moveUndoAction()
 		QString nyString = QString::number(m_yPos * unitRatio, 'f', unitPrecision) + " " + unitSuffix;
 		QString tooltip  =  QString(Um::MoveFromTo).arg(oxString).arg(oyString).arg(oldp)
 			                                        .arg(nxString).arg(nyString).arg(newp);
+		// A move following the previous move of this item within a second, like a
+		// sequence of arrow key nudges, extends that undo state instead of adding one
+		const qint64 moveMergeInterval = 1000;
+		SimpleState *last = undoManager->mergeableState(this, "ITEM_MOVE", moveMergeInterval);
+		if (last && last->getDouble("NEW_XPOS") == oldXpos && last->getDouble("NEW_YPOS") == oldYpos)
+		{
+			double ox = last->getDouble("OLD_XPOS");
+			double oy = last->getDouble("OLD_YPOS");
+			oxString = QString::number(ox * unitRatio, 'f', unitPrecision) + " " + unitSuffix;
+			oyString = QString::number(oy * unitRatio, 'f', unitPrecision) + " " + unitSuffix;
+			last->setDescription(QString(Um::MoveFromTo).arg(oxString).arg(oyString).arg(oldp)
+			                                            .arg(nxString).arg(nyString).arg(newp));
+			last->set("NEW_XPOS", m_xPos);
+			last->set("NEW_YPOS", m_yPos);
+			undoManager->stateMerged(this, last);
+			oldXpos = m_xPos;
+			oldYpos = m_yPos;
+			oldOwnPage = OwnPage;
+			return;
+		}
 		SimpleState *ss = new SimpleState(Um::Move, tooltip, Um::IMove);
 		ss->set("ITEM_MOVE");
 		ss->set("OLD_XPOS", oldXpos);
@@ -4967,6 +5013,7 @@ void PageItem::restore(UndoState *state, bool isUndo)
 	m_Doc->SnapGrid = false;
 	m_Doc->SnapGuides = false;
 	SimpleState *ss = dynamic_cast<SimpleState*>(state);
+	m_Doc->checkerCache().itemChanged(this);
 	bool oldMPMode=m_Doc->masterPageMode();
 	m_Doc->setMasterPageMode(!OnMasterPage.isEmpty());
 	ScPage *oldCurrentPage = m_Doc->currentPage();
@@ -9199,6 +9246,7 @@ bool PageItem::loadImage(const QString& filename, const bool reload, const int g
 	useImage |= (isAnnotation() && annotation().UseIcons());
 	if (!useImage)
 		return false;
+	m_Doc->checkerCache().itemChanged(this);
 	QFileInfo fi(filename);
 	QString clPath(pixm.imgInfo.usedPath);
 	pixm.imgInfo.valid = false;
@@ -10083,6 +10131,7 @@ void PageItem::updateClip(bool updateWelded)
 {
 	if (m_Doc->appMode == modeDrawBezierLine)
 		return;
+	m_Doc->itemGeometryChanged(this);
 	if (ContourLine.size() == 0)
 		ContourLine = PoLine.copy();
 	int ph = static_cast<int>(qMax(1.0, lineWidth() / 2.0));
@@ -419,6 +419,8 @@ public: // Start public functions
 	void SetQColor(QColor *tmp, QString farbe, double shad);
 	void DrawPolyL(QPainter *p, QPolygon pts);
 	QString ExpandToken(uint base);
+	/// True if the text contains page numbers, page counts or marks, which are expanded differently on each page
+	bool hasPageDependentText() const;
 	const FPointArray shape() const { return PoLine; }
 	void setShape(FPointArray val) { PoLine = val; }
 	const FPointArray contour() const { return ContourLine; }
@@ -73,6 +73,10 @@ PageItem_TextFrame::PageItem_TextFrame(ScribusDoc *pa, double x, double y, doubl
 {
 	invalid = true;
 	firstChar = 0;
+	m_pageDependentText = true;
+	m_layoutSerial = 0;
+	m_layoutFirstChar = 0;
+	m_layoutDependsUntil = 0;
 	cursorBiasBackward = false;
 	unicodeTextEditMode = false;
 	unicodeInputCount = 0;
@@ -85,6 +89,10 @@ PageItem_TextFrame::PageItem_TextFrame(ScribusDoc *pa, double x, double y, doubl
 PageItem_TextFrame::PageItem_TextFrame(const PageItem & p) : PageItem(p)
 {
 	invalid = true;
+	m_pageDependentText = true;
+	m_layoutSerial = 0;
+	m_layoutFirstChar = 0;
+	m_layoutDependsUntil = 0;
 	cursorBiasBackward = false;
 	unicodeTextEditMode = false;
 	unicodeInputCount = 0;
@@ -1269,12 +1277,14 @@ void PageItem_TextFrame::layout()
 		if (!invalid)
 			return;
 	}
-	else if (!invalid && OnMasterPage.isEmpty()) {
+	else if (!invalid && (OnMasterPage.isEmpty() || !m_pageDependentText)) {
 //		qDebug() << QString("textframe: len=%1, invalid=%2 OnMasterPage=%3: no relayout").arg(itemText.length()).arg(invalid).arg(OnMasterPage);
 		return;
 	}
 	if (invalid && BackBox == NULL)
 		firstChar = 0;
+	// overflow and the glyphs in this frame may change
+	m_Doc->checkerCache().itemChanged(this);
 
 //	qDebug() << QString("textframe(%1,%2): len=%3, start relayout at %4").arg(Xpos).arg(Ypos).arg(itemText.length()).arg(firstInFrame());
 	QPoint pt1, pt2;
@@ -1306,6 +1316,7 @@ void PageItem_TextFrame::layout()
 	int    DropLinesCount = 0;
 
 	textLayout.clear();
+	m_layoutSerial = 0;
 	incompleteLines = 0;
 	incompletePositions.clear();
 
@@ -1331,6 +1342,7 @@ void PageItem_TextFrame::layout()
 */
 
 	setShadow();
+	m_pageDependentText = !OnMasterPage.isEmpty() && hasPageDependentText();
 	int itLen = itemText.length();
 	//fast validate empty frames
 	if (itLen == 0 || firstInFrame() == itLen)
@@ -1339,6 +1351,8 @@ void PageItem_TextFrame::layout()
 		while (next != NULL)
 		{
 			next->invalid = false;
+			if (next->isTextFrame())
+				next->asTextFrame()->m_layoutSerial = 0;
 			next = next->nextInChain();
 		}
 		// TODO layout() shouldn't delete any frame here, as it breaks any loop
@@ -1536,7 +1550,9 @@ void PageItem_TextFrame::layout()
 					else if (charStyle.name() != style.peCharStyleName())
 						newStyle.setParent(m_Doc->charStyle(style.peCharStyleName()).name());
 					charStyle.setStyle(newStyle);
-					itemText.setCharStyle(a, 1 , charStyle);
+					// unchanged styles are not written back, so relayouts don't look like edits
+					if (!charStyle.equiv(itemText.charStyle(a)))
+						itemText.setCharStyle(a, 1 , charStyle);
 				}
 				else if (!style.peCharStyleName().isEmpty())
 				//par effect is cleared but is set dcCharStyleName = clear drop cap char style
@@ -1544,7 +1560,8 @@ void PageItem_TextFrame::layout()
 					const QString& curParent(style.hasParent() ? style.parent() : style.name());
 					charStyle.eraseCharStyle(m_Doc->charStyle(style.peCharStyleName()));
 					charStyle.setParent(m_Doc->paragraphStyle(curParent).charStyle().name());
-					itemText.setCharStyle(a, 1,charStyle);
+					if (!charStyle.equiv(itemText.charStyle(a)))
+						itemText.setCharStyle(a, 1,charStyle);
 				}
 			}
 
@@ -2958,6 +2975,7 @@ void PageItem_TextFrame::layout()
 		}
 	}
 	invalid = false;
+	rememberLayout();
 	if (!isNoteFrame() && (!m_Doc->notesList().isEmpty() || m_Doc->notesChanged()))
 	{ //if notes are used
 		UndoManager::instance()->setUndoEnabled(false);
@@ -2987,6 +3005,7 @@ NoRoom:
 	invalid = false;
 
 	adjustParagraphEndings ();
+	rememberLayout();
 
 	if (!isNoteFrame() && (!m_Doc->notesList().isEmpty() || m_Doc->notesChanged()))
 	{
@@ -3001,6 +3020,21 @@ NoRoom:
 	}
 
 	PageItem_TextFrame * next = dynamic_cast<PageItem_TextFrame*>(NextBox);
+	if (next != NULL && next->invalid && next->reuseLayout(this))
+	{
+		// line breaks converged, the rest of the chain only needs its positions moved
+		PageItem_TextFrame* prev = next;
+		next = dynamic_cast<PageItem_TextFrame*>(next->NextBox);
+		while (next != NULL && next->invalid && next->reuseLayout(prev))
+		{
+			prev = next;
+			next = dynamic_cast<PageItem_TextFrame*>(next->NextBox);
+		}
+		if (next != NULL && next->invalid)
+			next->firstChar = prev->MaxChars;
+		itemText.blockSignals(false);
+		return;
+	}
 	if (next != NULL)
 	{
 		next->invalid = true;
@@ -3031,18 +3065,23 @@ void PageItem_TextFrame::invalidateLayout(bool wholeChain)
 {
 	//const bool wholeChain = true;
 	invalid = true;
+	m_layoutSerial = 0;
 	if (wholeChain)
 	{
 		PageItem *prevFrame = this->prevInChain();
 		while (prevFrame != 0)
 		{
 			prevFrame->invalid = true;
+			if (prevFrame->isTextFrame())
+				prevFrame->asTextFrame()->m_layoutSerial = 0;
 			prevFrame = prevFrame->prevInChain();
 		}
 		PageItem *nextFrame = this->nextInChain();
 		while (nextFrame != 0)
 		{
 			nextFrame->invalid = true;
+			if (nextFrame->isTextFrame())
+				nextFrame->asTextFrame()->m_layoutSerial = 0;
 			nextFrame = nextFrame->nextInChain();
 		}
 	}
@@ -3050,7 +3089,95 @@ void PageItem_TextFrame::invalidateLayout(bool wholeChain)
 
 void PageItem_TextFrame::slotInvalidateLayout()
 {
-	invalidateLayout(true);
+	// frames before the modified text keep their layout, the others are
+	// laid out again and may take the shortcut in reuseLayout()
+	PageItem* frame = firstInChain();
+	int delta = 0;
+	while (frame != NULL && !frame->invalid && frame->isTextFrame()
+		   && frame->asTextFrame()->layoutUnchanged(delta) && delta == 0)
+		frame = frame->nextInChain();
+	while (frame != NULL)
+	{
+		frame->invalid = true;
+		frame = frame->nextInChain();
+	}
+}
+
+QVector<double> PageItem_TextFrame::layoutGeometry() const
+{
+	QVector<double> geometry;
+	geometry << m_xPos << m_yPos << m_width << m_height << m_rotation;
+	geometry << Cols << ColGap << verticalAlign;
+	geometry << m_textDistanceMargins.left() << m_textDistanceMargins.top();
+	geometry << m_textDistanceMargins.right() << m_textDistanceMargins.bottom();
+	geometry << (lineColor() != CommonStrings::None ? m_lineWidth : 0.0);
+	geometry << imageFlippedH() << imageFlippedV();
+	return geometry;
+}
+
+void PageItem_TextFrame::rememberLayout()
+{
+	m_layoutSerial = itemText.changeSerial();
+	m_layoutFirstChar = firstChar;
+	m_layoutDependsUntil = itemText.nextParagraph(MaxChars);
+	m_layoutGeometry = layoutGeometry();
+}
+
+// Checks whether the text and frame geometry the layout was made for are
+// unchanged, except for delta characters inserted or removed before them.
+// The paragraph following the frame is included for widow/orphan control.
+bool PageItem_TextFrame::layoutUnchanged(int& delta)
+{
+	if (m_layoutSerial == 0 || firstChar != m_layoutFirstChar)
+		return false;
+	if (!OnMasterPage.isEmpty() || isNoteFrame() || !m_Doc->notesList().isEmpty())
+		return false;
+	if (m_layoutGeometry != layoutGeometry())
+		return false;
+	int first = qMax(static_cast<int>(firstChar) - 1, 0);
+	int last = m_layoutDependsUntil;
+	if (!itemText.mapUnchangedRange(m_layoutSerial, first, last))
+		return false;
+	delta = last - m_layoutDependsUntil;
+	return true;
+}
+
+// Called when prev has been laid out again and this frame is next in the
+// chain: if this frame would start with the same character as before, its
+// line breaks are still valid and only the character positions move.
+bool PageItem_TextFrame::reuseLayout(PageItem_TextFrame* prev)
+{
+	int delta = 0;
+	if (!layoutUnchanged(delta) || static_cast<int>(firstChar) + delta != static_cast<int>(prev->MaxChars))
+		return false;
+	// same check as moveLinesFromPreviousFrame(), prev may now need to give us lines
+	bool releasePrev = false;
+	if (prev->incompleteLines > 0)
+	{
+		for (uint i = 0; i < textLayout.lines(); ++i)
+		{
+			int pos = textLayout.line(i)->lastChar() + delta;
+			if ((pos != itemText.length() - 1) && (!SpecialChars::isBreak(itemText.text(pos), true)))
+				continue;
+			if (static_cast<int>(i) + 1 < itemText.paragraphStyle(pos).keepLinesEnd() + 1)
+				return false;
+			releasePrev = true;
+			break;
+		}
+	}
+	if (releasePrev)
+		prev->incompleteLines = 0;
+
+	firstChar = prev->MaxChars;
+	MaxChars += delta;
+	textLayout.moveChars(delta);
+	for (int i = 0; i < incompletePositions.count(); ++i)
+		incompletePositions[i] += delta;
+	m_layoutSerial = itemText.changeSerial();
+	m_layoutFirstChar = firstChar;
+	m_layoutDependsUntil += delta;
+	invalid = false;
+	return true;
 }
 
 bool PageItem_TextFrame::isValidChainFromBegin()
@@ -26,11 +26,13 @@ for which a new license (GPL+exception) is in place.
 #include <QRectF>
 #include <QString>
 #include <QKeyEvent>
+#include <QVector>
 
 #include "scribusapi.h"
 #include "pageitem.h"
 #include "marks.h"
 #include "notesstyles.h"
+#include "text/textshaper.h"
 
 class PageItem_NoteFrame;
 class ScPainter;
@@ -70,10 +72,12 @@ public:
 	
 	//for speed up updates when changed was only one frame from chain
 	virtual void invalidateLayout(bool wholeChain);
-	using PageItem::invalidateLayout;
+	virtual void invalidateLayout() { invalidateLayout(false); }
 	virtual void layout();
 	//return true if all previouse frames from chain are valid (including that one)
 	bool isValidChainFromBegin();
+	//glyph shaping results reused between layouts
+	ShapingCache& shapingCache() { return m_shapingCache; }
 	//simplify conditions checking if frame is in chain
 	//FIX: use it in other places
 	bool isInChain() { return ((prevInChain() != NULL) || (nextInChain() != NULL)); }
@@ -115,9 +119,24 @@ private:
 	// This holds the line splitting positions
 	QList<int> incompletePositions;
 
+	// The text range and frame geometry textLayout was made for. Edits elsewhere
+	// in the story only invalidate the frames whose text they touch, following
+	// frames just get their positions moved once the line breaks converge.
+	uint m_layoutSerial;
+	uint m_layoutFirstChar;
+	int m_layoutDependsUntil;
+	QVector<double> m_layoutGeometry;
+	QVector<double> layoutGeometry() const;
+	void rememberLayout();
+	bool layoutUnchanged(int& delta);
+	bool reuseLayout(PageItem_TextFrame* prev);
+
 	void setShadow();
 	QString m_currentShadow;
+	// Master page frames without page numbers or marks lay out the same on every page
+	bool m_pageDependentText;
 	QMap<QString,StoryText> m_shadows;
+	ShapingCache m_shapingCache;
 	bool checkKeyIsShortcut(QKeyEvent *k);
 	QRectF m_origAnnotPos;
 	
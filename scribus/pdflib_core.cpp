@@ -55,6 +55,7 @@ for which a new license (GPL+exception) is in place.
 #include <QString>
 #include <QTemporaryFile>
 #include <QTextCodec>
+#include <QThread>
 #include <QtXml>
 #include <QUuid>
 
@@ -107,10 +108,9 @@ using namespace TableUtils;
 
 static inline QByteArray FToStr(double c)
 {
-	double v = c;
-	if (fabs(c) < 0.0000001)
-		v = 0.0;
-	return QByteArray::number(v, 'f', 5);
+	QByteArray result;
+	appendDecimal(result, c, 5);
+	return result;
 }
 
 class PdfPainter: public TextLayoutPainter
@@ -475,6 +475,63 @@ public:
 	}
 };
 
+/**
+ * A page content stream whose Flate compression runs on the export's
+ * worker pool while the next pages are being generated. The object
+ * number is allocated up front on the GUI thread so that numbering is
+ * identical to a sequential export.
+ */
+class PdfPendingContent : public QRunnable
+{
+public:
+	PdfPendingContent(PdfId objNum, const QByteArray& content) :
+		ObjNum(objNum),
+		Content(content),
+		Compressed(false)
+	{
+		setAutoDelete(false);
+	}
+
+	void run()
+	{
+		QByteArray compressed = CompressArray(Content);
+		if (compressed.size() > 0 || Content.isEmpty())
+		{
+			Content = compressed;
+			Compressed = true;
+		}
+	}
+
+	PdfId ObjNum;
+	QByteArray Content;
+	bool Compressed;
+};
+
+/**
+ * Reads an image file ahead of the page that uses it, so that the later
+ * ScImage::loadPicture() call finds the data in the OS file cache instead
+ * of waiting for the disk or a network share.
+ */
+class PdfImagePrefetch : public QRunnable
+{
+public:
+	PdfImagePrefetch(const QString& fileName) : m_fileName(fileName) {}
+
+	void run()
+	{
+		QFile file(m_fileName);
+		if (!file.open(QIODevice::ReadOnly))
+			return;
+		char buffer[65536];
+		while (file.read(buffer, sizeof(buffer)) > 0)
+			;
+		file.close();
+	}
+
+private:
+	QString m_fileName;
+};
+
 PDFLibCore::PDFLibCore(ScribusDoc & docu)
 	: QObject(&docu),
 	doc(docu),
@@ -501,7 +558,12 @@ PDFLibCore::PDFLibCore(ScribusDoc & docu)
 	abortExport(false),
 	usingGUI(ScCore->usingGUI()),
 	bleedDisplacementX(0),
-	bleedDisplacementY(0)
+	bleedDisplacementY(0),
+	parallelContent(false),
+	prefetchPosition(0),
+	contentSpool(0),
+	contentSpoolFilter(0),
+	spoolAllowed(false)
 {
 //	KeyGen.resize(32);
 //	OwnerKey.resize(32);
@@ -534,10 +596,20 @@ PDFLibCore::PDFLibCore(ScribusDoc & docu)
 		progressDialog->addExtraProgressBars(barNames, barTexts, barsNumeric);
 		connect(progressDialog, SIGNAL(canceled()), this, SLOT(cancelRequested()));
 	}
+	// Compressing page contents in the background only pays off with
+	// more than one core and when there is something to compress
+	parallelContent = Options.Compress && (QThread::idealThreadCount() > 1);
+	if (parallelContent)
+		contentPool.setMaxThreadCount(QThread::idealThreadCount());
+	imagePool.setMaxThreadCount(2);
 }
 
 PDFLibCore::~PDFLibCore()
 {
+	imagePool.clear();
+	imagePool.waitForDone();
+	PDF_DiscardPageContents();
+	PDF_DiscardSpooledContent();
 	delete progressDialog;
 }
 
@@ -591,6 +663,13 @@ bool PDFLibCore::doExport(const QString& fn, const QString& nam, int Components,
 		{
 			pageNsMpa.insert(doc.MasterNames[doc.DocPages.at(pageNs[a]-1)->MPageNam], 0);
 		}
+		QList<PageItem*> allItems = doc.getAllItems(doc.DocItems);
+		for (int i = 0; i < allItems.count(); ++i)
+		{
+			PageItem* item = allItems.at(i);
+			if (item->isImageFrame() && item->imageIsAvailable && !item->Pfile.isEmpty())
+				pageImageFiles[item->OwnPage].append(item->Pfile);
+		}
 		if (usingGUI)
 		{
 			progressDialog->setOverallTotalSteps(pageNsMpa.count()+pageNs.size());
@@ -620,6 +699,7 @@ bool PDFLibCore::doExport(const QString& fn, const QString& nam, int Components,
 		}
 		for (uint a = 0; a < pageNs.size() && !abortExport; ++a)
 		{
+			PDF_PrefetchImages(pageNs, a);
 			if (doc.pdfOptions().Thumbnails)
 				pm = thumbs[pageNs[a]];
 			qApp->processEvents();
@@ -757,6 +837,29 @@ static QByteArray blendMode(int code)
 			return "";
 	}
 }
+
+// Content address of an image as it is about to be written: the decoded,
+// colour managed and effect processed pixels, the soft mask, and every
+// setting that influences how PDF_Image encodes them.
+static QByteArray imageDigest(ScImage& img, const QByteArray& mask, const ScImageEffectList& effects,
+							  const QString& profile, int intent, bool realCMYK, bool grayProfile, const PageItem* item)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	QByteArray settings;
+	QDataStream ds(&settings, QIODevice::WriteOnly);
+	ds << img.width() << img.height() << static_cast<int>(img.imgInfo.colorspace);
+	ds << profile << intent << realCMYK << grayProfile;
+	ds << item->OverrideCompressionMethod << item->CompressionMethodIndex;
+	ds << item->OverrideCompressionQuality << item->CompressionQualityIndex;
+	ds << static_cast<int>(item->pixm.imgInfo.type) << effects.count();
+	for (int i = 0; i < effects.count(); ++i)
+		ds << effects.at(i).effectCode << effects.at(i).effectParameters;
+	hash.addData(settings);
+	const QImage& pixels = img.qImage();
+	hash.addData(reinterpret_cast<const char*>(pixels.constBits()), pixels.byteCount());
+	hash.addData(mask);
+	return hash.result();
+}
 //
 //QByteArray PDFLibCore::EncodeUTF16(const QString &in)
 //{
@@ -3274,6 +3377,7 @@ void PDFLibCore::PDF_Begin_Page(const ScPage* pag, QPixmap pm)
 {
 	ActPageP = pag;
 	Content = "";
+	spoolAllowed = true;
 	pageData.AObjects.clear();
 	pageData.radioButtonList.clear();
 	if (Options.Thumbnails)
@@ -3501,7 +3605,14 @@ void PDFLibCore::PDF_End_Page(int physPage)
 			PutPage("Q\n");
 		}
 	}
-	pageData.ObjNum = WritePDFStream(Content);
+	if (contentSpoolFilter)
+		pageData.ObjNum = PDF_WriteSpooledContent();
+	else if (parallelContent)
+		pageData.ObjNum = PDF_QueuePageContent(Content);
+	else
+		pageData.ObjNum = WritePDFStream(Content);
+	Content = QByteArray();
+	spoolAllowed = false;
 	int Gobj = 0;
 	if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
 	{
@@ -3826,6 +3937,30 @@ bool PDFLibCore::PDF_ProcessMasterElements(const ScLayer& layer, const ScPage* p
 				else
 					PutPage(name + " Do\n");
 			}
+			else if (!ite->asTable() && !ite->isAnnotation() && !ite->isBookmark && !ite->hasPageDependentText())
+			{
+				// Text without page numbers or marks is the same on all pages of this
+				// size using the master, so it is written once and shared
+				double bleedRight = 0.0;
+				double bleedLeft  = 0.0;
+				getBleeds(pag, bleedLeft, bleedRight);
+				// everything PDF_MasterTextObject() puts in the BBox
+				QByteArray geometry = FToStr(pag->width()) + " " + FToStr(pag->height()) + " " + FToStr(bleedLeft) + " " + FToStr(bleedRight)
+				                      + " " + FToStr(Options.bleeds.top()) + " " + FToStr(Options.bleeds.bottom());
+				QPair<PageItem*, QByteArray> textKey(ite, geometry);
+				QByteArray textName = MasterTextObjects.value(textKey);
+				if (textName.isEmpty())
+				{
+					textName = "master_text_obj_" + Pdf::toPdf(MasterTextObjects.count());
+					if (!PDF_MasterTextObject(ite, mPage, pag, textName))
+						return false;
+					MasterTextObjects.insert(textKey, textName);
+				}
+				if (((layer.transparency != 1) || (layer.blendMode != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
+					content += ("/" + textName + " Do\n");
+				else
+					PutPage("/" + textName + " Do\n");
+			}
 			else
 			{
 				double oldX = ite->xPos();
@@ -3893,6 +4028,55 @@ bool PDFLibCore::PDF_ProcessMasterElements(const ScLayer& layer, const ScPage* p
 	return true;
 }
 
+bool PDFLibCore::PDF_MasterTextObject(PageItem* ite, const ScPage* mPage, const ScPage* pag, const QByteArray& name)
+{
+	QByteArray output;
+	double oldX = ite->xPos();
+	double oldY = ite->yPos();
+	double OldBX = ite->BoundingX;
+	double OldBY = ite->BoundingY;
+	ite->setXPos(ite->xPos() - mPage->xOffset() + pag->xOffset(), true);
+	ite->setYPos(ite->yPos() - mPage->yOffset() + pag->yOffset(), true);
+	bool processed = PDF_ProcessItem(output, ite, pag, pag->pageNr());
+	ite->setXYPos(oldX, oldY, true);
+	ite->BoundingX = OldBX;
+	ite->BoundingY = OldBY;
+	if (!processed)
+		return false;
+
+	PdfId textObject = writer.newObject();
+	writer.startObj(textObject);
+	PutDoc("<<\n/Type /XObject\n/Subtype /Form\n/FormType 1\n");
+	double bleedRight = 0.0;
+	double bleedLeft  = 0.0;
+	getBleeds(pag, bleedLeft, bleedRight);
+	double maxBoxX = pag->width()+bleedRight+bleedLeft;
+	double maxBoxY = pag->height()+Options.bleeds.top()+Options.bleeds.bottom();
+	PutDoc("/BBox [ "+FToStr(-bleedLeft)+" "+FToStr(-Options.bleeds.bottom())+" "+FToStr(maxBoxX)+" "+FToStr(maxBoxY)+" ]\n");
+
+	Pdf::ResourceDictionary dict;
+	dict.XObject.unite(pageData.ImgObjects);
+	dict.XObject.unite(pageData.XObjects);
+	dict.Font = pageData.FObjects;
+	dict.Shading = Shadings;
+	dict.Pattern = Patterns;
+	dict.ExtGState = Transpar;
+	dict.ColorSpace.append(asColorSpace(ICCProfiles.values()));
+	dict.ColorSpace.append(asColorSpace(spotMap.values()));
+	writer.write("/Resources ");
+	writer.write(dict);
+
+	if (Options.Compress)
+		output = CompressArray(output);
+	PutDoc("/Length "+Pdf::toPdf(output.length()+1));
+	if (Options.Compress)
+		PutDoc("\n/Filter /FlateDecode");
+	PutDoc(" >>\nstream\n"+EncStream(output, textObject)+"\nendstream");
+	writer.endObj(textObject);
+	pageData.XObjects[name] = textObject;
+	return true;
+}
+
 bool PDFLibCore::PDF_ProcessPageElements(const ScLayer& layer, const ScPage* pag, uint PNr)
 {
 	PageItem* ite;
@@ -9623,6 +9807,163 @@ PdfId PDFLibCore::WritePDFStream(const QByteArray& cc)
 	return result;
 }
 
+void PDFLibCore::PutPage(const QByteArray& in)
+{
+	if (contentSpoolFilter)
+	{
+		if (!contentSpoolFilter->writeData(in))
+			PDF_Error_WriteFailure();
+		return;
+	}
+	Content += in;
+	if (spoolAllowed && (Content.size() > MaxPageContentBuffer))
+		PDF_SpoolPageContent();
+}
+
+void PDFLibCore::PDF_SpoolPageContent()
+{
+	contentSpool = new QTemporaryFile(QDir::toNativeSeparators(ScPaths::getTempFileDir() + "scpdfpage_XXXXXX"));
+	if (!contentSpool->open())
+	{
+		// Keep the page in memory rather than failing the export
+		delete contentSpool;
+		contentSpool = 0;
+		spoolAllowed = false;
+		return;
+	}
+	contentSpoolStream.setDevice(contentSpool);
+	if (Options.Compress)
+		contentSpoolFilter = new ScFlateEncodeFilter(&contentSpoolStream);
+	else
+		contentSpoolFilter = new ScNullEncodeFilter(&contentSpoolStream);
+	if (!contentSpoolFilter->openFilter())
+	{
+		PDF_DiscardSpooledContent();
+		spoolAllowed = false;
+		return;
+	}
+	if (!contentSpoolFilter->writeData(Content))
+		PDF_Error_WriteFailure();
+	Content = QByteArray();
+}
+
+PdfId PDFLibCore::PDF_WriteSpooledContent()
+{
+	bool succeed = contentSpoolFilter->closeFilter();
+	delete contentSpoolFilter;
+	contentSpoolFilter = 0;
+	contentSpoolStream.setDevice(0);
+	contentSpool->close();
+
+	PdfId result = writer.newObject();
+	writer.startObj(result);
+	PutDoc("<< /Length "+Pdf::toPdf(contentSpool->size()));
+	if (Options.Compress)
+		PutDoc("\n/Filter /FlateDecode");
+	PutDoc(" >>\nstream\n");
+	if (Options.Encrypt)
+	{
+		ScStreamFilter* rc4Encode = writer.openStreamFilter(true, result);
+		if (rc4Encode->openFilter())
+		{
+			succeed &= copyFileToFilter(contentSpool->fileName(), *rc4Encode);
+			succeed &= rc4Encode->closeFilter();
+		}
+		else
+			succeed = false;
+		delete rc4Encode;
+	}
+	else
+		succeed &= copyFileToStream(contentSpool->fileName(), writer.getOutStream());
+	PutDoc("\nendstream");
+	writer.endObj(result);
+	if (!succeed)
+		PDF_Error_WriteFailure();
+	delete contentSpool;
+	contentSpool = 0;
+	return result;
+}
+
+void PDFLibCore::PDF_DiscardSpooledContent()
+{
+	delete contentSpoolFilter;
+	contentSpoolFilter = 0;
+	contentSpoolStream.setDevice(0);
+	delete contentSpool;
+	contentSpool = 0;
+}
+
+void PDFLibCore::PDF_PrefetchImages(const std::vector<int>& pageNs, uint current)
+{
+	// Forget about pages already exported, what they read is either
+	// consumed or evicted by now
+	qint64 outstanding = 0;
+	QMap<uint, qint64>::iterator it = prefetchedBytes.begin();
+	while (it != prefetchedBytes.end())
+	{
+		if (it.key() < current)
+			it = prefetchedBytes.erase(it);
+		else
+		{
+			outstanding += it.value();
+			++it;
+		}
+	}
+	while ((prefetchPosition < pageNs.size()) && (prefetchPosition <= current + ImagePrefetchPages) && (outstanding < ImagePrefetchBudget))
+	{
+		QStringList files = pageImageFiles.value(pageNs[prefetchPosition] - 1);
+		qint64 bytes = 0;
+		for (int i = 0; i < files.count(); ++i)
+		{
+			if (prefetchedImages.contains(files.at(i)))
+				continue;
+			prefetchedImages.insert(files.at(i));
+			bytes += QFileInfo(files.at(i)).size();
+			imagePool.start(new PdfImagePrefetch(files.at(i)));
+		}
+		prefetchedBytes.insert(prefetchPosition, bytes);
+		outstanding += bytes;
+		++prefetchPosition;
+	}
+}
+
+PdfId PDFLibCore::PDF_QueuePageContent(const QByteArray& content)
+{
+	PdfId result = writer.newObject();
+	PdfPendingContent* pending = new PdfPendingContent(result, content);
+	pendingContents.append(pending);
+	contentPool.start(pending);
+	// Flush at a fixed depth rather than when workers happen to finish,
+	// so the object order in the file does not depend on thread timing
+	if (pendingContents.count() >= MaxPendingContents)
+		PDF_FlushPageContents();
+	return result;
+}
+
+void PDFLibCore::PDF_FlushPageContents()
+{
+	contentPool.waitForDone();
+	for (int i = 0; i < pendingContents.count(); ++i)
+	{
+		PdfPendingContent* pending = pendingContents.at(i);
+		writer.startObj(pending->ObjNum);
+		PutDoc("<< /Length "+Pdf::toPdf(pending->Content.length()));
+		if (pending->Compressed)
+			PutDoc("\n/Filter /FlateDecode");
+		PutDoc(" >>\nstream\n"+EncStream(pending->Content, pending->ObjNum)+"\nendstream");
+		writer.endObj(pending->ObjNum);
+		delete pending;
+	}
+	pendingContents.clear();
+}
+
+void PDFLibCore::PDF_DiscardPageContents()
+{
+	contentPool.waitForDone();
+	qDeleteAll(pendingContents);
+	pendingContents.clear();
+}
+
 PdfId PDFLibCore::WritePDFString(const QString& cc)
 {
 	QByteArray tmp;
@@ -10517,90 +10858,113 @@ bool PDFLibCore::PDF_Image(PageItem* c, const QString& fn, double sx, double sy,
 				ImInfo.sxa = sx * (1.0 / ImInfo.reso);
 				ImInfo.sya = sy * (1.0 / ImInfo.reso);
 			}
-			PdfId maskObj = 0;
-			if (alphaM)
+			QByteArray rasterKey = imageDigest(img, im2, c->effectsInUse, profInUse, Intent, realCMYK, hasGrayProfile, c);
+			if (SharedRasters.contains(rasterKey))
+				ImInfo.ResNum = SharedRasters[rasterKey];
+			else
 			{
-				bool compAlphaAvail = false;
-				maskObj = writer.newObject();
-				writer.startObj(maskObj);
-				PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
-				if (Options.CompressMethod != PDFOptions::Compression_None)
+				PdfId maskObj = 0;
+				if (alphaM)
 				{
-					QByteArray compAlpha = CompressArray(im2);
-					if (compAlpha.size() > 0)
+					bool compAlphaAvail = false;
+					maskObj = writer.newObject();
+					writer.startObj(maskObj);
+					PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
+					if (Options.CompressMethod != PDFOptions::Compression_None)
+					{
+						QByteArray compAlpha = CompressArray(im2);
+						if (compAlpha.size() > 0)
+						{
+							im2 = compAlpha;
+							compAlphaAvail = true;
+						}
+					}
+					if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
+					{
+						PutDoc("/Width "+Pdf::toPdf(origWidth)+"\n");
+						PutDoc("/Height "+Pdf::toPdf(origHeight)+"\n");
+						PutDoc("/ColorSpace /DeviceGray\n");
+						PutDoc("/BitsPerComponent 8\n");
+						PutDoc("/Length "+Pdf::toPdf(im2.size())+"\n");
+					}
+					else
 					{
-						im2 = compAlpha;
-						compAlphaAvail = true;
+						PutDoc("/Width "+Pdf::toPdf(origWidth)+"\n");
+						PutDoc("/Height "+Pdf::toPdf(origHeight)+"\n");
+						PutDoc("/ImageMask true\n/BitsPerComponent 1\n");
+						PutDoc("/Length "+Pdf::toPdf(im2.size())+"\n");
 					}
+					if ((Options.CompressMethod != PDFOptions::Compression_None) && compAlphaAvail)
+						PutDoc("/Filter /FlateDecode\n");
+					PutDoc(">>\nstream\n");
+					EncodeArrayToStream(im2, maskObj);
+					PutDoc("\nendstream");
+					writer.endObj(maskObj);
+					pageData.ImgObjects[ResNam+"I"+Pdf::toPdf(ResCount)] = maskObj;
+					ResCount++;
 				}
-				if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
+				PdfId imageObj = writer.newObject();
+				writer.startObj(imageObj);
+				PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
+				PutDoc("/Width "+Pdf::toPdf(img.width())+"\n");
+				PutDoc("/Height "+Pdf::toPdf(img.height())+"\n");
+				enum PDFOptions::PDFCompression compress_method = Options.CompressMethod;
+	 			enum PDFOptions::PDFCompression cm = Options.CompressMethod;
+				bool exportToCMYK = false, exportToGrayscale = false, jpegUseOriginal = false;
+				if (!Options.UseRGB && !(doc.HasCMS && Options.UseProfiles2 && !realCMYK))
 				{
-					PutDoc("/Width "+Pdf::toPdf(origWidth)+"\n");
-					PutDoc("/Height "+Pdf::toPdf(origHeight)+"\n");
-					PutDoc("/ColorSpace /DeviceGray\n");
-					PutDoc("/BitsPerComponent 8\n");
-					PutDoc("/Length "+Pdf::toPdf(im2.size())+"\n");
+					exportToGrayscale = Options.isGrayscale;
+					if (exportToGrayscale)
+						exportToCMYK      = !Options.isGrayscale;
+					else
+						exportToCMYK      = !Options.UseRGB;
 				}
-				else
+				if (c->OverrideCompressionMethod)
+					compress_method = cm = (enum PDFOptions::PDFCompression) c->CompressionMethodIndex;
+				if (img.imgInfo.colorspace == ColorSpaceMonochrome && (c->effectsInUse.count() == 0))
 				{
-					PutDoc("/Width "+Pdf::toPdf(origWidth)+"\n");
-					PutDoc("/Height "+Pdf::toPdf(origHeight)+"\n");
-					PutDoc("/ImageMask true\n/BitsPerComponent 1\n");
-					PutDoc("/Length "+Pdf::toPdf(im2.size())+"\n");
+					compress_method = (compress_method != PDFOptions::Compression_None) ? PDFOptions::Compression_ZIP : compress_method;
+					cm = compress_method;
 				}
-				if ((Options.CompressMethod != PDFOptions::Compression_None) && compAlphaAvail)
-					PutDoc("/Filter /FlateDecode\n");
-				PutDoc(">>\nstream\n");
-				EncodeArrayToStream(im2, maskObj);
-				PutDoc("\nendstream");
-				writer.endObj(maskObj);
-				pageData.ImgObjects[ResNam+"I"+Pdf::toPdf(ResCount)] = maskObj;
-				ResCount++;
-			}
-			PdfId imageObj = writer.newObject();
-			writer.startObj(imageObj);
-			PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
-			PutDoc("/Width "+Pdf::toPdf(img.width())+"\n");
-			PutDoc("/Height "+Pdf::toPdf(img.height())+"\n");
-			enum PDFOptions::PDFCompression compress_method = Options.CompressMethod;
- 			enum PDFOptions::PDFCompression cm = Options.CompressMethod;
-			bool exportToCMYK = false, exportToGrayscale = false, jpegUseOriginal = false;
-			if (!Options.UseRGB && !(doc.HasCMS && Options.UseProfiles2 && !realCMYK))
-			{
-				exportToGrayscale = Options.isGrayscale;
-				if (exportToGrayscale)
-					exportToCMYK      = !Options.isGrayscale;
-				else
-					exportToCMYK      = !Options.UseRGB;
-			}
-			if (c->OverrideCompressionMethod)
-				compress_method = cm = (enum PDFOptions::PDFCompression) c->CompressionMethodIndex;
-			if (img.imgInfo.colorspace == ColorSpaceMonochrome && (c->effectsInUse.count() == 0))
-			{
-				compress_method = (compress_method != PDFOptions::Compression_None) ? PDFOptions::Compression_ZIP : compress_method;
-				cm = compress_method;
-			}
-			if (extensionIndicatesJPEG(ext) && (cm != PDFOptions::Compression_None))
-			{
-				if (((Options.UseRGB || Options.UseProfiles2) && (cm == PDFOptions::Compression_Auto) && (c->effectsInUse.count() == 0) && (img.imgInfo.colorspace == ColorSpaceRGB)) && (!img.imgInfo.progressive) && (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale()))))))
+				if (extensionIndicatesJPEG(ext) && (cm != PDFOptions::Compression_None))
 				{
-					// #12961 : we must not rely on PDF viewers taking exif infos into account
-					// So if JPEG orientation is non default, do not use the original file
-					jpegUseOriginal = (img.imgInfo.exifInfo.orientation == 1);
-					cm = PDFOptions::Compression_JPEG;
+					if (((Options.UseRGB || Options.UseProfiles2) && (cm == PDFOptions::Compression_Auto) && (c->effectsInUse.count() == 0) && (img.imgInfo.colorspace == ColorSpaceRGB)) && (!img.imgInfo.progressive) && (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale()))))))
+					{
+						// #12961 : we must not rely on PDF viewers taking exif infos into account
+						// So if JPEG orientation is non default, do not use the original file
+						jpegUseOriginal = (img.imgInfo.exifInfo.orientation == 1);
+						cm = PDFOptions::Compression_JPEG;
+					}
+					// We can't unfortunately use directly cmyk jpeg files. Otherwise we have to use the /Decode argument in image
+					// dictionary, which we do not quite want as this argument is simply ignored by some rips and software
+					// amongst which photoshop and illustrator
+					/*else if (((!Options.UseRGB) && (!Options.isGrayscale) && (!Options.UseProfiles2)) && (cm== 0) && (c->effectsInUse.count() == 0) && (img.imgInfo.colorspace == ColorSpaceCMYK) && (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale()))))) && (!img.imgInfo.progressive))
+					{
+						jpegUseOriginal = false;
+						exportToCMYK = true;
+						cm = PDFOptions::Compression_JPEG;
+					}*/
+					else
+					{
+						if (compress_method == PDFOptions::Compression_JPEG)
+						{
+							if (realCMYK || !((Options.UseRGB) || (Options.UseProfiles2)))
+							{
+								exportToGrayscale = Options.isGrayscale;
+								if (exportToGrayscale)
+									exportToCMYK      = !Options.isGrayscale;
+								else
+									exportToCMYK      = !Options.UseRGB;
+							}
+							cm = PDFOptions::Compression_JPEG;
+						}
+						else
+							cm = PDFOptions::Compression_ZIP;
+					}
 				}
-				// We can't unfortunately use directly cmyk jpeg files. Otherwise we have to use the /Decode argument in image
-				// dictionary, which we do not quite want as this argument is simply ignored by some rips and software
-				// amongst which photoshop and illustrator
-				/*else if (((!Options.UseRGB) && (!Options.isGrayscale) && (!Options.UseProfiles2)) && (cm== 0) && (c->effectsInUse.count() == 0) && (img.imgInfo.colorspace == ColorSpaceCMYK) && (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / c->imageXScale(), 72.0 / c->imageYScale()))))) && (!img.imgInfo.progressive))
-				{
-					jpegUseOriginal = false;
-					exportToCMYK = true;
-					cm = PDFOptions::Compression_JPEG;
-				}*/
 				else
 				{
-					if (compress_method == PDFOptions::Compression_JPEG)
+					if ((compress_method == PDFOptions::Compression_JPEG) || (compress_method == PDFOptions::Compression_Auto))
 					{
 						if (realCMYK || !((Options.UseRGB) || (Options.UseProfiles2)))
 						{
@@ -10611,111 +10975,95 @@ bool PDFLibCore::PDF_Image(PageItem* c, const QString& fn, double sx, double sy,
 								exportToCMYK      = !Options.UseRGB;
 						}
 						cm = PDFOptions::Compression_JPEG;
+						/*if (compress_method == PDFOptions::Compression_Auto)
+						{
+							QFileInfo fi(tmpFile);
+							if (fi.size() < im.size())
+							{
+								im.resize(0);
+								if (!loadRawBytes(tmpFile, im))
+									return false;
+								cm = PDFOptions::Compression_JPEG;
+							}
+							else
+								cm = PDFOptions::Compression_ZIP;
+						}*/
 					}
-					else
-						cm = PDFOptions::Compression_ZIP;
 				}
-			}
-			else
-			{
-				if ((compress_method == PDFOptions::Compression_JPEG) || (compress_method == PDFOptions::Compression_Auto))
+				if ((hasGrayProfile) && (doc.HasCMS) && (Options.UseProfiles2) && (!hasColorEffect))
+					exportToGrayscale = true;
+				int bytesWritten = 0;
+				// Fixme: outType variable should be set directly in the if/else maze above.
+				ColorSpaceEnum outType;
+				if (img.imgInfo.colorspace == ColorSpaceMonochrome && c->effectsInUse.count() == 0)
+					outType = ColorSpaceMonochrome;
+				else
+					outType = getOutputType(exportToGrayscale, exportToCMYK);
+				if ((outType != ColorSpaceMonochrome) && (doc.HasCMS) && (Options.UseProfiles2))
+				{
+					PutDoc("/ColorSpace "+ICCProfiles[profInUse].ICCArray+"\n");
+					PutDoc("/Intent /");
+					int inte2 = Intent;
+					if (Options.EmbeddedI)
+						inte2 = Options.Intent2;
+					static const QByteArray cmsmode[] = {"Perceptual", "RelativeColorimetric", "Saturation", "AbsoluteColorimetric"};
+					PutDoc(cmsmode[inte2] + "\n");
+				}
+				else
 				{
-					if (realCMYK || !((Options.UseRGB) || (Options.UseProfiles2)))
+					switch (outType)
 					{
-						exportToGrayscale = Options.isGrayscale;
-						if (exportToGrayscale)
-							exportToCMYK      = !Options.isGrayscale;
-						else
-							exportToCMYK      = !Options.UseRGB;
+						case ColorSpaceMonochrome :
+						case ColorSpaceGray : PutDoc("/ColorSpace /DeviceGray\n"); break;
+						case ColorSpaceCMYK : PutDoc("/ColorSpace /DeviceCMYK\n"); break;
+						default : PutDoc("/ColorSpace /DeviceRGB\n"); break;
 					}
-					cm = PDFOptions::Compression_JPEG;
-					/*if (compress_method == PDFOptions::Compression_Auto)
-					{
-						QFileInfo fi(tmpFile);
-						if (fi.size() < im.size())
-						{
-							im.resize(0);
-							if (!loadRawBytes(tmpFile, im))
-								return false;
-							cm = PDFOptions::Compression_JPEG;
-						}
-						else
-							cm = PDFOptions::Compression_ZIP;
-					}*/
 				}
-			}
-			if ((hasGrayProfile) && (doc.HasCMS) && (Options.UseProfiles2) && (!hasColorEffect))
-				exportToGrayscale = true;
-			int bytesWritten = 0;
-			// Fixme: outType variable should be set directly in the if/else maze above.
-			ColorSpaceEnum outType;
-			if (img.imgInfo.colorspace == ColorSpaceMonochrome && c->effectsInUse.count() == 0)
-				outType = ColorSpaceMonochrome;
-			else
-				outType = getOutputType(exportToGrayscale, exportToCMYK);
-			if ((outType != ColorSpaceMonochrome) && (doc.HasCMS) && (Options.UseProfiles2))
-			{
-				PutDoc("/ColorSpace "+ICCProfiles[profInUse].ICCArray+"\n");
-				PutDoc("/Intent /");
-				int inte2 = Intent;
-				if (Options.EmbeddedI)
-					inte2 = Options.Intent2;
-				static const QByteArray cmsmode[] = {"Perceptual", "RelativeColorimetric", "Saturation", "AbsoluteColorimetric"};
-				PutDoc(cmsmode[inte2] + "\n");
-			}
-			else
-			{
-				switch (outType)
+				if (outType == ColorSpaceMonochrome)
+					PutDoc("/BitsPerComponent 1\n");
+				else
+					PutDoc("/BitsPerComponent 8\n");
+				PdfId lengthObj = writer.newObject();
+				PutDoc("/Length "+Pdf::toPdf(lengthObj)+" 0 R\n");
+				if (cm == PDFOptions::Compression_JPEG)
+					PutDoc("/Filter /DCTDecode\n");
+				else if (cm != PDFOptions::Compression_None)
+					PutDoc("/Filter /FlateDecode\n");
+	//			if (exportToCMYK && (cm == PDFOptions::Compression_JPEG))
+	//				PutDoc("/Decode [1 0 1 0 1 0 1 0]\n");
+				if (alphaM)
 				{
-					case ColorSpaceMonochrome :
-					case ColorSpaceGray : PutDoc("/ColorSpace /DeviceGray\n"); break;
-					case ColorSpaceCMYK : PutDoc("/ColorSpace /DeviceCMYK\n"); break;
-					default : PutDoc("/ColorSpace /DeviceRGB\n"); break;
+					if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
+						PutDoc("/SMask "+Pdf::toPdf(maskObj)+" 0 R\n");
+					else
+						PutDoc("/Mask "+Pdf::toPdf(maskObj)+" 0 R\n");
 				}
-			}
-			if (outType == ColorSpaceMonochrome)
-				PutDoc("/BitsPerComponent 1\n");
-			else
-				PutDoc("/BitsPerComponent 8\n");
-			PdfId lengthObj = writer.newObject();
-			PutDoc("/Length "+Pdf::toPdf(lengthObj)+" 0 R\n");
-			if (cm == PDFOptions::Compression_JPEG)
-				PutDoc("/Filter /DCTDecode\n");
-			else if (cm != PDFOptions::Compression_None)
-				PutDoc("/Filter /FlateDecode\n");
-//			if (exportToCMYK && (cm == PDFOptions::Compression_JPEG))
-//				PutDoc("/Decode [1 0 1 0 1 0 1 0]\n");
-			if (alphaM)
-			{
-				if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
-					PutDoc("/SMask "+Pdf::toPdf(maskObj)+" 0 R\n");
+				PutDoc(">>\nstream\n");
+				if (cm == PDFOptions::Compression_JPEG) // Fixme: should not do this with monochrome images?
+				{
+					int quality = c->OverrideCompressionQuality ? c->CompressionQualityIndex : Options.Quality;
+					if (c->OverrideCompressionQuality)
+						jpegUseOriginal = false;
+					bytesWritten = WriteJPEGImageToStream(img, fn, imageObj, quality, outType, jpegUseOriginal, (!hasColorEffect && hasGrayProfile));
+				}
+				else if (cm == PDFOptions::Compression_ZIP)
+					bytesWritten = WriteFlateImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
 				else
-					PutDoc("/Mask "+Pdf::toPdf(maskObj)+" 0 R\n");
-			}
-			PutDoc(">>\nstream\n");
-			if (cm == PDFOptions::Compression_JPEG) // Fixme: should not do this with monochrome images?
-			{
-				int quality = c->OverrideCompressionQuality ? c->CompressionQualityIndex : Options.Quality;
-				if (c->OverrideCompressionQuality)
-					jpegUseOriginal = false;
-				bytesWritten = WriteJPEGImageToStream(img, fn, imageObj, quality, outType, jpegUseOriginal, (!hasColorEffect && hasGrayProfile));
-			}
-			else if (cm == PDFOptions::Compression_ZIP)
-				bytesWritten = WriteFlateImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
-			else
-				bytesWritten = WriteImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
-			PutDoc("\nendstream");
-			writer.endObj(imageObj);
-			if (bytesWritten <= 0)
-			{
-				PDF_Error_ImageWriteFailure(fn);
-				return false;
+					bytesWritten = WriteImageToStream(img, imageObj, outType, (!hasColorEffect && hasGrayProfile));
+				PutDoc("\nendstream");
+				writer.endObj(imageObj);
+				if (bytesWritten <= 0)
+				{
+					PDF_Error_ImageWriteFailure(fn);
+					return false;
+				}
+				writer.startObj(lengthObj);
+				PutDoc("    " + Pdf::toPdf(bytesWritten));
+				writer.endObj(lengthObj);
+				pageData.ImgObjects[ResNam+"I"+Pdf::toPdf(ResCount)] = imageObj;
+				ImInfo.ResNum = ResCount;
+				SharedRasters.insert(rasterKey, ResCount);
 			}
-			writer.startObj(lengthObj);
-			PutDoc("    " + Pdf::toPdf(bytesWritten));
-			writer.endObj(lengthObj);
-			pageData.ImgObjects[ResNam+"I"+Pdf::toPdf(ResCount)] = imageObj;
-			ImInfo.ResNum = ResCount;
 			ImInfo.Width = img.width();
 			ImInfo.Height = img.height();
 			ImInfo.xa = sx;
@@ -10790,6 +11138,7 @@ bool PDFLibCore::PDF_Image(PageItem* c, const QString& fn, double sx, double sy,
 
 bool PDFLibCore::PDF_End_Doc(const QString& PrintPr, const QString& Name, int Components)
 {
+	PDF_FlushPageContents();
 	PDF_End_Bookmarks();
 	PDF_End_Resources();
 	PDF_End_Outlines();
@@ -11382,11 +11731,16 @@ void PDFLibCore::PDF_Error_InsufficientMemory(void)
 
 bool PDFLibCore::closeAndCleanup()
 {
+	PDF_DiscardSpooledContent();
+	imagePool.clear();
+	imagePool.waitForDone();
+	PDF_DiscardPageContents();
 	bool writeSucceed = writer.close(abortExport);
 	if (!writeSucceed)
 		PDF_Error_WriteFailure();
 
 	pageData.XObjects.clear();
+	MasterTextObjects.clear();
 	pageData.ImgObjects.clear();
 	pageData.FObjects.clear();
 	pageData.AObjects.clear();
@@ -12,13 +12,16 @@ for which a new license (GPL+exception) is in place.
 #include <QDataStream>
 #include <QPixmap>
 #include <QList>
+#include <QSet>
 #include <QStack>
+#include <QThreadPool>
 #include <string>
 #include <vector>
 
 class QImage;
 class QRect;
 class QString;
+class QTemporaryFile;
 class QTextCodec;
 class PageItem;
 class BookMItem;
@@ -44,6 +47,7 @@ class ScText;
 #include "pdfwriter.h"
 
 class PdfPainter;
+class PdfPendingContent;
 
 /**
  * PDFLibCore provides Scribus's implementation of PDF export functionality.
@@ -119,6 +123,7 @@ private:
 	bool PDF_TemplatePage(const ScPage* pag, bool clip = false);
 	bool PDF_ProcessPage(const ScPage* pag, uint PNr, bool clip = false);
 	bool PDF_ProcessMasterElements(const ScLayer& layer, const ScPage* page, uint PNr);
+	bool PDF_MasterTextObject(PageItem* ite, const ScPage* mPage, const ScPage* pag, const QByteArray& name);
 	bool PDF_ProcessPageElements(const ScLayer& layer, const ScPage* page, uint PNr);
 	
 	bool PDF_End_Doc(const QString& PrintPr = "", const QString& Name = "", int Components = 0);
@@ -185,10 +190,25 @@ private:
 //	void PutDoc(const char* in) { outStream.writeRawData(in, strlen(in)); }
 //	void PutDoc(const std::string & in) { outStream.writeRawData(in.c_str(), in.length()); }
 
-	void       PutPage(const QByteArray & in) { Content += in; }
+	/**
+	 * Append to the content stream of the current page. Page contents are
+	 * buffered in memory up to MaxPageContentBuffer bytes. A page growing
+	 * past that is streamed through a flate filter into a temporary file
+	 * and copied into the PDF by PDF_End_Page, so the memory held for one
+	 * page is bounded by MaxPageContentBuffer plus the 32 KB of flate
+	 * buffers plus the output of the single item being written.
+	 */
+	void       PutPage(const QByteArray & in);
+	void       PDF_SpoolPageContent();
+	PdfId      PDF_WriteSpooledContent();
+	void       PDF_DiscardSpooledContent();
 //	void       StartObj(PdfId nr);
 //	uint       newObject() { return ObjCounter++; }
 	uint       WritePDFStream(const QByteArray& cc);
+	void       PDF_PrefetchImages(const std::vector<int>& pageNs, uint current);
+	PdfId      PDF_QueuePageContent(const QByteArray& content);
+	void       PDF_FlushPageContents();
+	void       PDF_DiscardPageContents();
 	uint       WritePDFString(const QString& cc);
 	void       writeXObject(uint objNr, QByteArray dictionary, QByteArray stream);
 	uint       writeObject(QByteArray type, QByteArray dictionary);
@@ -252,6 +272,9 @@ private:
 	BookMView* Bvie;
 	//int Dokument;
 	QMap<QString,ShIm> SharedImages;
+	QHash<QByteArray, int> SharedRasters;
+	/// XObject names of shared master text, by item and page geometry
+	QMap<QPair<PageItem*, QByteArray>, QByteArray> MasterTextObjects;
 	QList<PdfDest> NamedDest;
 	QList<PdfId> Threads;
 	QList<PdfBead> Beads;
@@ -293,6 +316,25 @@ private:
 	QByteArray xmpPacket;
 	QStack<QPointF> groupStackPos;
 	QStack<QPointF> patternStackPos;
+	/// compress page contents on contentPool, writing them back in page order
+	bool parallelContent;
+	QThreadPool contentPool;
+	QList<PdfPendingContent*> pendingContents;
+	static const int MaxPendingContents = 16;
+	/// read image files of upcoming pages on imagePool, bounded by ImagePrefetchBudget bytes
+	QThreadPool imagePool;
+	QMap<int, QStringList> pageImageFiles;
+	QSet<QString> prefetchedImages;
+	QMap<uint, qint64> prefetchedBytes;
+	uint prefetchPosition;
+	static const uint ImagePrefetchPages = 8;
+	static const qint64 ImagePrefetchBudget = Q_INT64_C(256) * 1024 * 1024;
+	/// page contents past MaxPageContentBuffer go through contentSpoolFilter into contentSpool
+	QTemporaryFile* contentSpool;
+	QDataStream contentSpoolStream;
+	ScStreamFilter* contentSpoolFilter;
+	bool spoolAllowed;
+	static const int MaxPageContentBuffer = 4 * 1024 * 1024;
 
 protected slots:
 	void cancelRequested();
@@ -11,6 +11,7 @@ for which a new license (GPL+exception) is in place.
 #include "rc4.h"
 #include "scstreamfilter_rc4.h"
 #include "util.h"
+#include "util_math.h"
 
 namespace Pdf
 {
@@ -293,7 +294,9 @@ namespace Pdf
 	
 	QByteArray toPdf(double v)
 	{
-		return QByteArray::number(v, 'f');
+		QByteArray result;
+		appendDecimal(result, v, 6);
+		return result;
 	}
 	
 	QByteArray toObjRef(PdfId id)
@@ -489,7 +492,7 @@ namespace Pdf
 	{
 		if (encrypted)
 		{
-			QByteArray step1 = ComputeRC4Key(m_ObjCounter);
+			QByteArray step1 = ComputeRC4Key(objId);
 			return new ScRC4EncodeFilter(&m_outStream, step1.data(), qMin(m_KeyLen+5, 16));
 		}
 		else
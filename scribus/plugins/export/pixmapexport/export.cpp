@@ -12,6 +12,7 @@ for which a new license (GPL+exception) is in place.
 #include <QMessageBox>
 #include <QPixmap>
 #include <QString>
+#include <QScopedPointer>
 #include <QSharedPointer>
 
 #include "scribus.h"
@@ -22,6 +23,8 @@ for which a new license (GPL+exception) is in place.
 #include "util.h"
 #include "commonstrings.h"
 #include "scpaths.h"
+#include "scimagebandwriter.h"
+#include "scimagefilewriter.h"
 
 int scribusexportpixmap_getPluginAPIVersion()
 {
@@ -173,9 +176,55 @@ ExportBitmap::~ExportBitmap()
 {
 }
 
-bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool background, bool single = true)
+bool ExportBitmap::confirmOverwrite(ScribusDoc* doc, const QString& fileName, bool single)
+{
+	if (!QFile::exists(fileName) || overwrite)
+		return true;
+	bool doFileSave = false;
+	QString fn = QDir::toNativeSeparators(fileName);
+//	QApplication::restoreOverrideCursor();
+	QApplication::changeOverrideCursor(Qt::ArrowCursor);
+	uint over = ScMessageBox::question(doc->scMW(), tr("File exists. Overwrite?"),
+			fn +"\n"+ tr("exists already. Overwrite?"),
+			// hack for multiple overwriting (petr) 
+			(single == true) ? QMessageBox::Yes | QMessageBox::No : QMessageBox::Yes | QMessageBox::No | QMessageBox::YesToAll,
+			QMessageBox::NoButton,	// GUI default
+			QMessageBox::YesToAll);	// batch default
+	QApplication::changeOverrideCursor(QCursor(Qt::WaitCursor));
+	if (over == QMessageBox::Yes || over == QMessageBox::YesToAll)
+		doFileSave = true;
+	if (over == QMessageBox::YesToAll)
+		overwrite = true;
+	return doFileSave;
+}
+
+bool ExportBitmap::exportPageBanded(ScribusDoc* doc, uint pageNr, int maxGr, bool background, bool single, int bandBytes)
+{
+	QString fileName(getFileName(doc, pageNr));
+	if (!confirmOverwrite(doc, fileName, single))
+		return false;
+
+	ScPage* page = doc->Pages->at(pageNr);
+	double pixmapSize = (page->height() > page->width()) ? page->height() : page->width();
+	double sc = maxGr / pixmapSize;
+	int width = qRound(page->width() * sc);
+	int height = qRound(page->height() * sc);
+	int bandHeight = qMax(1, bandBytes / qMax(1, width * 4));
+	QScopedPointer<ScImageBandWriter> writer(ScImageBandWriter::create(bitmapType));
+	bool saved = writer->open(fileName, width, height, pageDPI, quality);
+	if (saved)
+		saved = doc->view()->PageToBands(pageNr, maxGr, bandHeight, background, writer.data());
+	saved = writer->close() && saved;
+	if (!saved)
+	{
+		ScMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Error writing the output file(s)."));
+		doc->scMW()->setStatusBarInfoText( tr("Error writing the output file(s)."));
+	}
+	return saved;
+}
+
+bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool background, bool single, ScImageFileWriter* writer)
 {
-	uint over   = 0;
 	bool saved = false, doFileSave = true;
 	QString fileName(getFileName(doc, pageNr));
 
@@ -188,7 +237,14 @@ bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool background, boo
 	* portrait and user defined sizes.
 	*/
 	double pixmapSize = (page->height() > page->width()) ? page->height() : page->width();
-	QImage im(doc->view()->PageToPixmap(pageNr, qRound(pixmapSize * enlargement * (pageDPI / 72.0) / 100.0), false, background));
+	int maxGr = qRound(pixmapSize * enlargement * (pageDPI / 72.0) / 100.0);
+	// images above 256 MB are rendered in bands of 32 MB and streamed to the file if the format allows it
+	double sc = maxGr / pixmapSize;
+	qint64 imageBytes = static_cast<qint64>(qRound(page->width() * sc)) * qRound(page->height() * sc) * 4;
+	if ((imageBytes > 256 * 1024 * 1024) && ScImageBandWriter::canWrite(bitmapType))
+		return exportPageBanded(doc, pageNr, maxGr, background, single, 32 * 1024 * 1024);
+
+	QImage im(doc->view()->PageToPixmap(pageNr, maxGr, false, background));
 	if (im.isNull())
 	{
 		ScMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Insufficient memory for this image size."));
@@ -198,23 +254,11 @@ bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool background, boo
 	int dpm = qRound(100.0 / 2.54 * pageDPI);
 	im.setDotsPerMeterY(dpm);
 	im.setDotsPerMeterX(dpm);
-	if (QFile::exists(fileName) && !overwrite)
+	doFileSave = confirmOverwrite(doc, fileName, single);
+	if (doFileSave && writer)
 	{
-		doFileSave = false;
-		QString fn = QDir::toNativeSeparators(fileName);
-//		QApplication::restoreOverrideCursor();
-		QApplication::changeOverrideCursor(Qt::ArrowCursor);
-		over = ScMessageBox::question(doc->scMW(), tr("File exists. Overwrite?"),
-				fn +"\n"+ tr("exists already. Overwrite?"),
-				// hack for multiple overwriting (petr) 
-				(single == true) ? QMessageBox::Yes | QMessageBox::No : QMessageBox::Yes | QMessageBox::No | QMessageBox::YesToAll,
-				QMessageBox::NoButton,	// GUI default
-				QMessageBox::YesToAll);	// batch default
-		QApplication::changeOverrideCursor(QCursor(Qt::WaitCursor));
-		if (over == QMessageBox::Yes || over == QMessageBox::YesToAll)
-			doFileSave = true;
-		if (over == QMessageBox::YesToAll)
-			overwrite = true;
+		writer->save(im, fileName, bitmapType.toLocal8Bit(), quality);
+		return true;
 	}
 	if (doFileSave)
 		saved = im.save(fileName, bitmapType.toLocal8Bit().constData(), quality);
@@ -233,12 +277,24 @@ bool ExportBitmap::exportCurrent(ScribusDoc* doc,  bool background)
 
 bool ExportBitmap::exportInterval(ScribusDoc* doc, std::vector<int> &pageNs, bool background)
 {
+	// pages are rendered one after another, encoding runs on the other cores meanwhile
+	ScImageFileWriter writer;
+	bool res = true;
 	doc->scMW()->mainWindowProgressBar->setMaximum(pageNs.size());
 	for (uint a = 0; a < pageNs.size(); ++a)
 	{
 		doc->scMW()->mainWindowProgressBar->setValue(a);
-		if (!exportPage(doc, pageNs[a]-1, background, false))
-			return false;
+		if (!exportPage(doc, pageNs[a]-1, background, false, &writer))
+		{
+			res = false;
+			break;
+		}
 	}
-	return true;
+	if (!writer.waitForDone())
+	{
+		ScMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Error writing the output file(s)."));
+		doc->scMW()->setStatusBarInfoText( tr("Error writing the output file(s)."));
+		res = false;
+	}
+	return res;
 }
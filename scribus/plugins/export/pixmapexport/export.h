@@ -14,6 +14,7 @@ for which a new license (GPL+exception) is in place.
 #include <vector>
 
 class ScrAction;
+class ScImageFileWriter;
 
 class PLUGIN_API PixmapExportPlugin : public ScActionPlugin
 {
@@ -77,9 +78,19 @@ private:
 	/*! \brief export one specified page
 	\param pageNr number of the page
 	\param single bool TRUE if only the one page is exported
+	\param writer if set, the image is queued there instead of being saved before returning
 	\retval bool true on success
 	*/
-	bool exportPage(ScribusDoc* doc, uint pageNr, bool background, bool single);
+	bool exportPage(ScribusDoc* doc, uint pageNr, bool background, bool single, ScImageFileWriter* writer = 0);
+	/*! \brief export one page too large for a single image, rendered and written in bands
+	\param maxGr size of the longer page side in pixels
+	\param bandBytes memory used by one band
+	\retval bool true on success
+	*/
+	bool exportPageBanded(ScribusDoc* doc, uint pageNr, int maxGr, bool background, bool single, int bandBytes);
+	/*! \brief ask the user whether an existing file may be overwritten
+	\retval bool true if the file may be written */
+	bool confirmOverwrite(ScribusDoc* doc, const QString& fileName, bool single);
 };
 
 #endif
@@ -47,7 +47,66 @@ for which a new license (GPL+exception) is in place.
 // #include <QDebug>
 #include <QFileInfo>
 #include <QList>
+#include <QRunnable>
 #include <QScopedPointer>
+#include <QSet>
+
+namespace {
+
+/**
+ * Decodes the payload of an inline image into its temporary file on the
+ * loader's image pool, while the rest of the document is being parsed.
+ */
+class InlineImageDecoder : public QRunnable
+{
+public:
+	InlineImageDecoder(const QByteArray& base64Data, const QString& fileName) :
+		m_data(base64Data),
+		m_fileName(fileName)
+	{}
+
+	void run()
+	{
+		QByteArray imageData = qUncompress(QByteArray::fromBase64(m_data));
+		m_data = QByteArray();
+		QFile outFil(m_fileName);
+		if (outFil.open(QIODevice::WriteOnly))
+		{
+			outFil.write(imageData);
+			outFil.close();
+		}
+	}
+
+private:
+	QByteArray m_data;
+	QString m_fileName;
+};
+
+/**
+ * Reads an image file ahead of loadDeferredImages(), so that the later
+ * ScImage::loadPicture() call finds the data in the OS file cache.
+ */
+class ImageFilePrefetch : public QRunnable
+{
+public:
+	ImageFilePrefetch(const QString& fileName) : m_fileName(fileName) {}
+
+	void run()
+	{
+		QFile file(m_fileName);
+		if (!file.open(QIODevice::ReadOnly))
+			return;
+		char buffer[65536];
+		while (file.read(buffer, sizeof(buffer)) > 0)
+			;
+		file.close();
+	}
+
+private:
+	QString m_fileName;
+};
+
+}
 
 // See scplugin.h and pluginmanager.{cpp,h} for detail on what these methods
 // do. That documentatation is not duplicated here.
@@ -55,7 +114,8 @@ for which a new license (GPL+exception) is in place.
 // in scribus150formatimpl.h and scribus150formatimpl.cpp .
 
 Scribus150Format::Scribus150Format() :
-	LoadSavePlugin()
+	LoadSavePlugin(),
+	deferImageLoading(false)
 {
 	// Set action info in languageChange, so we only have to do
 	// it in one place. This includes registering file formats.
@@ -1294,6 +1354,10 @@ bool Scribus150Format::loadFile(const QString & fileName, const FileFormat & /*
 	bool hasPageSets = false;
 	int  progress = 0;
 
+	// images are loaded once the document is parsed, see loadDeferredImages()
+	deferImageLoading = true;
+	deferredImages.clear();
+
 	ScXmlStreamReader reader(ioDevice.data());
 	ScXmlStreamAttributes attrs;
 	while(!reader.atEnd() && !reader.hasError())
@@ -1582,6 +1646,9 @@ bool Scribus150Format::loadFile(const QString & fileName, const FileFormat & /*
 		}
 	}
 
+	loadDeferredImages(m_Doc);
+	deferImageLoading = false;
+
 	if (reader.hasError())
 	{
 		setDomParsingError(reader.errorString(), reader.lineNumber(), reader.columnNumber());
@@ -4109,21 +4176,16 @@ bool Scribus150Format::readObject(ScribusDoc* doc, ScXmlStreamReader& reader, It
 	{
 		if (!newItem->Pfile.isEmpty())
 		{
-			doc->loadPict(newItem->Pfile, newItem, false);
-			if (newItem->pixm.imgInfo.PDSpathData.contains(clipPath))
+			if (deferImageLoading)
 			{
-				newItem->imageClip = newItem->pixm.imgInfo.PDSpathData[clipPath].copy();
-				newItem->pixm.imgInfo.usedPath = clipPath;
-				QTransform cl;
-				cl.translate(newItem->imageXOffset()*newItem->imageXScale(), newItem->imageYOffset()*newItem->imageYScale());
-				cl.scale(newItem->imageXScale(), newItem->imageYScale());
-				newItem->imageClip.map(cl);
-			}
-			if (layerFound)
-			{
-				newItem->pixm.imgInfo.isRequest = true;
-				doc->loadPict(newItem->Pfile, newItem, true);
+				DeferredImage image;
+				image.item = newItem;
+				image.clipPath = clipPath;
+				image.layerFound = layerFound;
+				deferredImages.append(image);
 			}
+			else
+				loadItemImage(doc, newItem, clipPath, layerFound);
 		}
 	}
 	if (!loadPage)
@@ -4131,6 +4193,53 @@ bool Scribus150Format::readObject(ScribusDoc* doc, ScXmlStreamReader& reader, It
 	return !reader.hasError();
 }
 
+void Scribus150Format::loadItemImage(ScribusDoc* doc, PageItem* item, const QString& itemClipPath, bool itemLayerFound)
+{
+	doc->loadPict(item->Pfile, item, false);
+	if (item->pixm.imgInfo.PDSpathData.contains(itemClipPath))
+	{
+		item->imageClip = item->pixm.imgInfo.PDSpathData[itemClipPath].copy();
+		item->pixm.imgInfo.usedPath = itemClipPath;
+		QTransform cl;
+		cl.translate(item->imageXOffset()*item->imageXScale(), item->imageYOffset()*item->imageYScale());
+		cl.scale(item->imageXScale(), item->imageYScale());
+		item->imageClip.map(cl);
+	}
+	if (itemLayerFound)
+	{
+		item->pixm.imgInfo.isRequest = true;
+		doc->loadPict(item->Pfile, item, true);
+	}
+}
+
+void Scribus150Format::loadDeferredImages(ScribusDoc* doc)
+{
+	// inline images must be written to their temporary files first
+	imagePool.waitForDone();
+	if (deferredImages.isEmpty())
+		return;
+	// keep the pool a few files ahead of the images being loaded
+	int window = qMax(4, 2 * imagePool.maxThreadCount());
+	int next = 0;
+	QSet<QString> prefetched;
+	for (int i = 0; i < deferredImages.count(); ++i)
+	{
+		for (; (next < deferredImages.count()) && (next < i + window); ++next)
+		{
+			const PageItem* item = deferredImages.at(next).item;
+			if (item->isInlineImage || prefetched.contains(item->Pfile))
+				continue;
+			prefetched.insert(item->Pfile);
+			imagePool.start(new ImageFilePrefetch(item->Pfile));
+		}
+		const DeferredImage& image = deferredImages.at(i);
+		loadItemImage(doc, image.item, image.clipPath, image.layerFound);
+	}
+	deferredImages.clear();
+	imagePool.clear();
+	imagePool.waitForDone();
+}
+
 bool Scribus150Format::readPattern(ScribusDoc* doc, ScXmlStreamReader& reader, const QString& baseDir)
 {
 	ScPattern pat;
@@ -4383,6 +4492,8 @@ bool Scribus150Format::readPattern(ScribusDoc* doc, ScXmlStreamReader& reader, c
 			newItem->gYpos += pat.yoffset;
 			pat.items.append(newItem);
 		}
+		// the preview needs the images of the pattern items
+		loadDeferredImages(doc);
 		pat.createPreview();
 	}
 	doc->docPatterns.insert(patternName, pat);
@@ -4758,28 +4869,30 @@ PageItem* Scribus150Format::pasteItem(ScribusDoc *doc, ScXmlStreamAttributes& at
 #endif
 		{
 			bool inlineF = attrs.valueAsBool("isInlineImage", false);
-			QString dat  = attrs.valueAsString("ImageData", "");
-			QByteArray inlineImageData;
-			inlineImageData.append(dat);
 			QString inlineImageExt = attrs.valueAsString("inlineImageExt", "");
 			if (inlineF)
 			{
+				// base64 is plain ASCII, convert straight from the parser's buffer
+				QByteArray inlineImageData = attrs.value(QLatin1String("ImageData")).toLatin1();
 				if (inlineImageData.size() > 0)
 				{
 					QTemporaryFile *tempFile = new QTemporaryFile(QDir::tempPath() + "/scribus_temp_XXXXXX." + inlineImageExt);
 					tempFile->setAutoRemove(false);
-					tempFile->open();
-					QString fileName = getLongPathName(tempFile->fileName());
-					tempFile->close();
-					inlineImageData = qUncompress(QByteArray::fromBase64(inlineImageData));
-					QFile outFil(fileName);
-					if (outFil.open(QIODevice::WriteOnly))
+					if (tempFile->open())
 					{
-						outFil.write(inlineImageData);
-						outFil.close();
+						QString fileName = getLongPathName(tempFile->fileName());
+						tempFile->close();
 						currItem->isInlineImage = true;
 						currItem->Pfile = fileName;
 						currItem->isTempFile = true;
+						InlineImageDecoder* decoder = new InlineImageDecoder(inlineImageData, fileName);
+						if (deferImageLoading)
+							imagePool.start(decoder);
+						else
+						{
+							decoder->run();
+							delete decoder;
+						}
 					}
 					delete tempFile;
 				}
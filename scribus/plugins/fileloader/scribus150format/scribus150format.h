@@ -19,6 +19,7 @@ for which a new license (GPL+exception) is in place.
 #include <QMap>
 #include <QProgressBar>
 #include <QString>
+#include <QThreadPool>
 
 class QIODevice;
 
@@ -49,6 +50,7 @@ class PLUGIN_API Scribus150Format : public LoadSavePlugin
 
 		virtual bool loadFile(const QString & fileName, const FileFormat & fmt, int flags, int index = 0);
 		virtual bool saveFile(const QString & fileName, const FileFormat & fmt);
+		virtual bool saveToBuffer(const QString & fileName, QByteArray & data);
 		virtual bool savePalette(const QString & fileName);
 		virtual QString saveElements(double xp, double yp, double wp, double hp, Selection* selection, QByteArray &prevData);
 		virtual bool loadPalette(const QString & fileName);
@@ -156,6 +158,19 @@ class PLUGIN_API Scribus150Format : public LoadSavePlugin
 
 		PageItem* pasteItem(ScribusDoc *doc, ScXmlStreamAttributes& attrs, const QString& baseDir, PageItem::ItemKind itemKind, int pagenr = -2 /* currentPage*/);
 
+		//image loading is deferred until the whole document is parsed when loading a file
+		struct DeferredImage {
+			PageItem* item;
+			QString clipPath;
+			bool layerFound;
+		};
+		void loadItemImage(ScribusDoc *doc, PageItem* item, const QString& itemClipPath, bool itemLayerFound);
+		void loadDeferredImages(ScribusDoc *doc);
+		bool deferImageLoading;
+		QList<DeferredImage> deferredImages;
+		//decodes inline images and reads image files ahead of loadDeferredImages()
+		QThreadPool imagePool;
+
 		void writeCheckerProfiles(ScXmlStreamWriter& docu);
 		void writeLinestyles(ScXmlStreamWriter& docu);
 		void writeJavascripts(ScXmlStreamWriter& docu);
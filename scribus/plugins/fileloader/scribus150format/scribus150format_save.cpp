@@ -7,7 +7,6 @@ for which a new license (GPL+exception) is in place.
 #include "scribus150format.h"
 #include "scribus150formatimpl.h"
 
-#include <ctime>
 #include <memory>
 
 #include "../../formatidlist.h"
@@ -18,6 +17,7 @@ for which a new license (GPL+exception) is in place.
 #include "resourcecollection.h"
 #include "scconfig.h"
 #include "scpattern.h"
+#include "scfilewriter.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
 #include "hyphenator.h"
@@ -36,6 +36,7 @@ for which a new license (GPL+exception) is in place.
 #include "util.h"
 #include "util_math.h"
 #include "util_color.h"
+#include <QBuffer>
 #include <QCursor>
 #include <QFileInfo>
 #include <QList>
@@ -160,6 +161,20 @@ bool Scribus150Format::saveFile(const QString & fileName, const FileFormat & /*
 {
 	m_lastSavedFile = "";
 
+	// Serialize first, then compress and write on a worker thread from the
+	// serialized copy while the GUI keeps repainting
+	QByteArray data;
+	if (!saveToBuffer(fileName, data))
+		return false;
+	ScFileWriter writer(fileName, data);
+	writer.setPermissions(m_Doc->filePermissions());
+	bool writeSucceed = writer.writeAndWait();
+	m_lastSavedFile = writer.writtenFile();
+	return writeSucceed;
+}
+
+bool Scribus150Format::saveToBuffer(const QString & fileName, QByteArray & data)
+{
 	// #11279: Image links get corrupted when symlinks involved
 	// We have to proceed in tow steps here as QFileInfo::canonicalPath()
 	// may no return correct result if fileName does not exists
@@ -168,36 +183,14 @@ bool Scribus150Format::saveFile(const QString & fileName, const FileFormat & /*
 	if (!canonicalPath.isEmpty())
 		fileDir = canonicalPath;
 
-	// Create a random temporary file name
-	srand(time(NULL)); // initialize random sequence each time
-	long     randt = 0, randn = 1 + (int) (((double) rand() / ((double) RAND_MAX + 1)) * 10000);
-	QString  tmpFileName  = QString("%1.%2").arg(fileName).arg(randn);
-	while (QFile::exists(tmpFileName) && (randt < 100))
-	{
-		randn = 1 + (int) (((double) rand() / ((double) RAND_MAX + 1)) * 10000);
-		tmpFileName = QString("%1.%2").arg(fileName).arg(randn);
-		++randt;
-	}
-	if (QFile::exists(tmpFileName))
-		return false;
-
-	std::auto_ptr<QIODevice> outputFile;
-	if (fileName.toLower().right(2) == "gz")
-	{
-		aFile.setFileName(tmpFileName);
-		QtIOCompressor *compressor = new QtIOCompressor(&aFile);
-		compressor->setStreamFormat(QtIOCompressor::GzipFormat);
-		outputFile.reset(compressor);
-	}
-	else
-		outputFile.reset( new QFile(tmpFileName) );
-
-	if (!outputFile->open(QIODevice::WriteOnly))
+	data.clear();
+	QBuffer outputBuffer(&data);
+	if (!outputBuffer.open(QIODevice::WriteOnly))
 		return false;
 
 	ScXmlStreamWriter docu;
 	docu.setAutoFormatting(true);
-	docu.setDevice(outputFile.get());
+	docu.setDevice(&outputBuffer);
 	docu.writeStartDocument();
 	docu.writeStartElement("SCRIBUSUTF8NEW");
 	docu.writeAttribute("Version", QString(VERSION));
@@ -422,31 +415,8 @@ bool Scribus150Format::saveFile(const QString & fileName, const FileFormat & /*
 	docu.writeEndElement();
 	docu.writeEndDocument();
 
-	bool  writeSucceed = false;
-	const QFile* qFile = dynamic_cast<QFile*>(outputFile.get());
-	if (qFile)
-		writeSucceed = (qFile->error() == QFile::NoError);
-	else
-		writeSucceed = true;
-	outputFile->close();
-
-	if (writeSucceed)
-	{
-		if (QFile::exists(fileName))
-			writeSucceed = QFile::remove(fileName) ? QFile::rename(tmpFileName, fileName) : false;
-		else
-			writeSucceed = QFile::rename(tmpFileName, fileName);
-		m_lastSavedFile = writeSucceed ? fileName : tmpFileName;
-	}
-	else if (QFile::exists(tmpFileName))
-		QFile::remove(tmpFileName);
-	if (writeSucceed)
-		QFile::remove(tmpFileName);
-#ifdef Q_OS_UNIX
-	if (writeSucceed)
-		QFile::setPermissions(fileName, m_Doc->filePermissions());
-#endif
-	return writeSucceed;
+	outputBuffer.close();
+	return !docu.hasError();
 }
 
 void Scribus150Format::writeCheckerProfiles(ScXmlStreamWriter & docu) 
@@ -2767,6 +2767,7 @@ void SlaOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int widt
 //	qDebug() << "Image Components" << colorMap->getNumPixelComps() << "Mask" << maskColors;
 	imgStr->reset();
 	QImage * image = 0;
+	int nComps = colorMap->getNumPixelComps();
 	if (maskColors)
 	{
 		image = new QImage(width, height, QImage::Format_ARGB32);
@@ -2774,15 +2775,12 @@ void SlaOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int widt
 		{
 			QRgb *s = (QRgb*)(image->scanLine(y));
 			Guchar *pix = imgStr->getLine();
+			// whole scanlines at once, poppler converts them through its lookup tables
+			colorMap->getRGBLine(pix, (unsigned int *) s, width);
 			for (int x = 0; x < width; x++)
 			{
-				GfxRGB rgb;
-				colorMap->getRGB(pix, &rgb);
-				int Rc = qRound(colToDbl(rgb.r) * 255);
-				int Gc = qRound(colToDbl(rgb.g) * 255);
-				int Bc = qRound(colToDbl(rgb.b) * 255);
-				*s = qRgba(Rc, Gc, Bc, 255);
-				for (int i = 0; i < colorMap->getNumPixelComps(); ++i)
+				*s = *s | 0xff000000;
+				for (int i = 0; i < nComps; ++i)
 				{
 					if (pix[i] < maskColors[2*i] * 255 || pix[i] > maskColors[2*i+1] * 255)
 					{
@@ -2791,11 +2789,11 @@ void SlaOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int widt
 					}
 				}
 				s++;
-				pix += colorMap->getNumPixelComps();
+				pix += nComps;
 			}
 		}
 	}
-	else
+	else if (nComps == 4)
 	{
 		image = new QImage(width, height, QImage::Format_ARGB32);
 		for (int y = 0; y < height; y++)
@@ -2804,30 +2802,30 @@ void SlaOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int widt
 			Guchar *pix = imgStr->getLine();
 			for (int x = 0; x < width; x++)
 			{
-				if (colorMap->getNumPixelComps() == 4)
-				{
-					GfxCMYK cmyk;
-					colorMap->getCMYK(pix, &cmyk);
-					int Cc = qRound(colToDbl(cmyk.c) * 255);
-					int Mc = qRound(colToDbl(cmyk.m) * 255);
-					int Yc = qRound(colToDbl(cmyk.y) * 255);
-					int Kc = qRound(colToDbl(cmyk.k) * 255);
-					*s = qRgba(Yc, Mc, Cc, Kc);
-				}
-				else
-				{
-					GfxRGB rgb;
-					colorMap->getRGB(pix, &rgb);
-					int Rc = qRound(colToDbl(rgb.r) * 255);
-					int Gc = qRound(colToDbl(rgb.g) * 255);
-					int Bc = qRound(colToDbl(rgb.b) * 255);
-					*s = qRgba(Rc, Gc, Bc, 255);
-				}
+				GfxCMYK cmyk;
+				colorMap->getCMYK(pix, &cmyk);
+				int Cc = qRound(colToDbl(cmyk.c) * 255);
+				int Mc = qRound(colToDbl(cmyk.m) * 255);
+				int Yc = qRound(colToDbl(cmyk.y) * 255);
+				int Kc = qRound(colToDbl(cmyk.k) * 255);
+				*s = qRgba(Yc, Mc, Cc, Kc);
 				s++;
-				pix += colorMap->getNumPixelComps();
+				pix += nComps;
 			}
 		}
 	}
+	else
+	{
+		image = new QImage(width, height, QImage::Format_ARGB32);
+		for (int y = 0; y < height; y++)
+		{
+			QRgb *s = (QRgb*)(image->scanLine(y));
+			Guchar *pix = imgStr->getLine();
+			colorMap->getRGBLine(pix, (unsigned int *) s, width);
+			for (int x = 0; x < width; x++)
+				s[x] |= 0xff000000;
+		}
+	}
 	if (image == NULL || image->isNull())
 	{
 		delete imgStr;
@@ -2845,7 +2843,10 @@ void SlaOutputDev::drawImage(GfxState *state, Object *ref, Stream *str, int widt
 	QRectF trect = m_ctm.mapRect(crect);
 	double sx = m_ctm.m11();
 	double sy = m_ctm.m22();
-	QImage img = image->copy();
+	// share the pixels instead of copying them, img is the only user from here on
+	QImage img = *image;
+	delete image;
+	image = NULL;
 	QTransform mm = QTransform(ctm[0] / width, ctm[1] / width, -ctm[2] / height, -ctm[3] / height, 0, 0);
 	int z = m_doc->itemAdd(PageItem::ImageFrame, PageItem::Rectangle, xCoor + trect.x(), yCoor + trect.y(), trect.width(), trect.height(), 0, CommonStrings::None, CommonStrings::None);
 	PageItem* ite = m_doc->Items->at(z);
@@ -3571,85 +3572,109 @@ void SlaOutputDev::drawChar(GfxState *state, double x, double y, double dx, doub
 {
 	double x1, y1, x2, y2;
 	int render;
-	updateFont(state);
-	if (!m_font)
-		return;
 	// check for invisible text -- this is used by Acrobat Capture
 	render = state->getRender();
 	if (render == 3)
 		return;
 	if (!(render & 1))
 	{
-		SplashPath * fontPath;
-		fontPath = m_font->getGlyphPath(code);
-		if (fontPath)
+		GfxFont *gfxFont = state->getFont();
+		if (!gfxFont)
+			return;
+		// the same key as the scaled font updateFont() would create
+		double *textMat = state->getTextMat();
+		double fontSize = state->getFontSize();
+		SlaGlyphKey key;
+		key.fontNum = gfxFont->getID()->num;
+		key.fontGen = gfxFont->getID()->gen;
+		key.code = code;
+		key.mat[0] = textMat[0] * fontSize * state->getHorizScaling();
+		key.mat[1] = -textMat[1] * fontSize * state->getHorizScaling();
+		key.mat[2] = textMat[2] * fontSize;
+		key.mat[3] = -textMat[3] * fontSize;
+		FPointArray textPath;
+		QHash<SlaGlyphKey, FPointArray>::const_iterator cached = m_glyphCache.constFind(key);
+		if (cached != m_glyphCache.constEnd())
+			textPath = cached.value();
+		else
 		{
-			QPainterPath qPath;
-			qPath.setFillRule(Qt::WindingFill);
-			for (int i = 0; i < fontPath->getLength(); ++i)
+			updateFont(state);
+			if (!m_font)
+				return;
+			SplashPath * fontPath;
+			fontPath = m_font->getGlyphPath(code);
+			if (fontPath)
 			{
-				Guchar f;
-				fontPath->getPoint(i, &x1, &y1, &f);
-				if (f & splashPathFirst)
-					qPath.moveTo(x1,y1);
-				else if (f & splashPathCurve)
+				QPainterPath qPath;
+				qPath.setFillRule(Qt::WindingFill);
+				for (int i = 0; i < fontPath->getLength(); ++i)
 				{
-					double x3, y3;
-					++i;
-					fontPath->getPoint(i, &x2, &y2, &f);
-					++i;
-					fontPath->getPoint(i, &x3, &y3, &f);
-					qPath.cubicTo(x1,y1,x2,y2,x3,y3);
+					Guchar f;
+					fontPath->getPoint(i, &x1, &y1, &f);
+					if (f & splashPathFirst)
+						qPath.moveTo(x1,y1);
+					else if (f & splashPathCurve)
+					{
+						double x3, y3;
+						++i;
+						fontPath->getPoint(i, &x2, &y2, &f);
+						++i;
+						fontPath->getPoint(i, &x3, &y3, &f);
+						qPath.cubicTo(x1,y1,x2,y2,x3,y3);
+					}
+					else
+						qPath.lineTo(x1,y1);
+					if (f & splashPathLast)
+						qPath.closeSubpath();
 				}
-				else
-					qPath.lineTo(x1,y1);
-				if (f & splashPathLast)
-					qPath.closeSubpath();
+				textPath.fromQPainterPath(qPath);
+				delete fontPath;
 			}
-			double *ctm;
-			ctm = state->getCTM();
-			m_ctm = QTransform(ctm[0], ctm[1], ctm[2], ctm[3], ctm[4], ctm[5]);
-			double xCoor = m_doc->currentPage()->xOffset();
-			double yCoor = m_doc->currentPage()->yOffset();
-			FPointArray textPath;
-			textPath.fromQPainterPath(qPath);
-			FPoint wh = textPath.WidthHeight();
-			if ((textPath.size() > 3) && ((wh.x() != 0.0) || (wh.y() != 0.0)))
+			// text on a path or with varying sizes would let the cache grow without bound
+			if (m_glyphCache.count() >= 20000)
+				m_glyphCache.clear();
+			m_glyphCache.insert(key, textPath);
+		}
+		double *ctm;
+		ctm = state->getCTM();
+		m_ctm = QTransform(ctm[0], ctm[1], ctm[2], ctm[3], ctm[4], ctm[5]);
+		double xCoor = m_doc->currentPage()->xOffset();
+		double yCoor = m_doc->currentPage()->yOffset();
+		FPoint wh = textPath.WidthHeight();
+		if ((textPath.size() > 3) && ((wh.x() != 0.0) || (wh.y() != 0.0)))
+		{
+			CurrColorFill = getColor(state->getFillColorSpace(), state->getFillColor(), &CurrFillShade);
+			int z = m_doc->itemAdd(PageItem::Polygon, PageItem::Unspecified, xCoor, yCoor, 10, 10, 0, CurrColorFill, CommonStrings::None);
+			PageItem* ite = m_doc->Items->at(z);
+			QTransform mm;
+			mm.scale(1, -1);
+			mm.translate(x, -y);
+			textPath.map(mm);
+			textPath.map(m_ctm);
+			ite->PoLine = textPath.copy();
+			ite->ClipEdited = true;
+			ite->FrameType = 3;
+			ite->setFillShade(CurrFillShade);
+			ite->setFillEvenOdd(false);
+			ite->setFillTransparency(1.0 - state->getFillOpacity());
+			ite->setFillBlendmode(getBlendMode(state));
+			ite->setLineEnd(PLineEnd);
+			ite->setLineJoin(PLineJoin);
+			ite->setTextFlowMode(PageItem::TextFlowDisabled);
+			m_doc->adjustItemSize(ite);
+			if ((render & 3) == 1 || (render & 3) == 2)
 			{
-				CurrColorFill = getColor(state->getFillColorSpace(), state->getFillColor(), &CurrFillShade);
-				int z = m_doc->itemAdd(PageItem::Polygon, PageItem::Unspecified, xCoor, yCoor, 10, 10, 0, CurrColorFill, CommonStrings::None);
-				PageItem* ite = m_doc->Items->at(z);
-				QTransform mm;
-				mm.scale(1, -1);
-				mm.translate(x, -y);
-				textPath.map(mm);
-				textPath.map(m_ctm);
-				ite->PoLine = textPath.copy();
-				ite->ClipEdited = true;
-				ite->FrameType = 3;
-				ite->setFillShade(CurrFillShade);
-				ite->setFillEvenOdd(false);
-				ite->setFillTransparency(1.0 - state->getFillOpacity());
-				ite->setFillBlendmode(getBlendMode(state));
-				ite->setLineEnd(PLineEnd);
-				ite->setLineJoin(PLineJoin);
-				ite->setTextFlowMode(PageItem::TextFlowDisabled);
-				m_doc->adjustItemSize(ite);
-				if ((render & 3) == 1 || (render & 3) == 2)
-				{
-					ite->setLineColor(CurrColorStroke);
-					ite->setLineWidth(state->getTransformedLineWidth());
-					ite->setLineTransparency(1.0 - state->getStrokeOpacity());
-					ite->setLineBlendmode(getBlendMode(state));
-					ite->setLineShade(CurrStrokeShade);
-				}
-				m_Elements->append(ite);
-				if (m_groupStack.count() != 0)
-				{
-					m_groupStack.top().Items.append(ite);
-					applyMask(ite);
-				}
-				delete fontPath;
+				ite->setLineColor(CurrColorStroke);
+				ite->setLineWidth(state->getTransformedLineWidth());
+				ite->setLineTransparency(1.0 - state->getStrokeOpacity());
+				ite->setLineBlendmode(getBlendMode(state));
+				ite->setLineShade(CurrStrokeShade);
+			}
+			m_Elements->append(ite);
+			if (m_groupStack.count() != 0)
+			{
+				m_groupStack.top().Items.append(ite);
+				applyMask(ite);
 			}
 		}
 	}
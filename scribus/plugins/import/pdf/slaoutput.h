@@ -14,6 +14,7 @@ for which a new license (GPL+exception) is in place.
 #include <QColor>
 #include <QBrush>
 #include <QPen>
+#include <QHash>
 #include <QImage>
 #include <QList>
 #include <QTransform>
@@ -141,6 +142,29 @@ private:
 };
 
 
+/// Identifies the outline SplashFont::getGlyphPath() returns: font, scaling matrix and char code
+struct SlaGlyphKey
+{
+	int fontNum;
+	int fontGen;
+	CharCode code;
+	double mat[4];
+
+	bool operator==(const SlaGlyphKey& other) const
+	{
+		return (fontNum == other.fontNum) && (fontGen == other.fontGen) && (code == other.code)
+			&& (mat[0] == other.mat[0]) && (mat[1] == other.mat[1]) && (mat[2] == other.mat[2]) && (mat[3] == other.mat[3]);
+	}
+};
+
+inline uint qHash(const SlaGlyphKey& key)
+{
+	uint h = qHash(key.fontNum) ^ (qHash(key.fontGen) << 8) ^ (key.code * 2654435761U);
+	for (int i = 0; i < 4; ++i)
+		h = h * 31 + qHash(key.mat[i]);
+	return h;
+}
+
 class SlaOutputDev : public OutputDev
 {
 public:
@@ -318,6 +342,8 @@ private:
 	Catalog *catalog;
 	SplashFontEngine *m_fontEngine;
 	SplashFont *m_font;
+	/// outlines of the glyphs drawn so far, repeated chars skip updateFont() and the path conversion
+	QHash<SlaGlyphKey, FPointArray> m_glyphCache;
 	FormPageWidgets *m_formWidgets;
 	QHash<QString, QList<int> > m_radioMap;
 	QHash<int, PageItem*> m_radioButtons;
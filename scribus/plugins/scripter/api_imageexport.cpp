@@ -8,6 +8,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusview.h"
 #include "utils.h"
 #include "util.h"
+#include "scimagefilewriter.h"
 
 ImageExport::ImageExport() : QObject(COLLECTOR)
 {
@@ -110,7 +111,7 @@ QString ImageExport::getFileName(ScribusDoc* doc, uint pageNr)
 	return QDir::cleanPath(QDir::toNativeSeparators(_name + "/" + getFileNameByPage(doc, pageNr, _type.toLower())));
 }
 
-bool ImageExport::exportPage(ScribusDoc* doc, uint pageNr, bool single = true)
+bool ImageExport::exportPage(ScribusDoc* doc, uint pageNr, bool single, ScImageFileWriter* writer)
 {
 	uint over   = 0;
 	bool saved = false, doFileSave = true;
@@ -138,6 +139,11 @@ bool ImageExport::exportPage(ScribusDoc* doc, uint pageNr, bool single = true)
 	{
 		RAISE("File exists and overwrite is set to false");
 	}
+	if (doFileSave && writer)
+	{
+		writer->save(im, fileName, _type.toLocal8Bit(), _quality);
+		return true;
+	}
 	if (doFileSave)
 		saved = im.save(fileName, _type.toLocal8Bit().constData(), _quality);
 	if (!saved && doFileSave)
@@ -149,12 +155,22 @@ bool ImageExport::exportPage(ScribusDoc* doc, uint pageNr, bool single = true)
 
 bool ImageExport::exportInterval(ScribusDoc* doc, std::vector< int > &pageNs)
 {
+	ScImageFileWriter writer;
+	bool res = true;
 	for (uint a = 0; a < pageNs.size(); ++a)
 	{
-		if (!exportPage(doc, pageNs[a]-1, false))
-			return false;
+		if (!exportPage(doc, pageNs[a]-1, false, &writer))
+		{
+			res = false;
+			break;
+		}
+	}
+	if (!writer.waitForDone())
+	{
+		RAISE("Error writing the output file(s).");
+		res = false;
 	}
-	return true;
+	return res;
 }
 
 void ImageExport::setOverWrite(bool value)
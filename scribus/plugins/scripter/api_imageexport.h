@@ -13,6 +13,8 @@ for which a new license (GPL+exception) is in place.
 
 #include "scripterimpl.h"
 
+class ScImageFileWriter;
+
 class ImageExport : public QObject
 {
 	Q_OBJECT
@@ -50,7 +52,7 @@ private:
 	double _quality; //quality 0 - 100
 	double _dpi; //dpi
 	bool _overwrite;
-	bool exportPage(ScribusDoc* doc, uint pageNr, bool single);
+	bool exportPage(ScribusDoc* doc, uint pageNr, bool single, ScImageFileWriter* writer = 0);
 	QString getFileName(ScribusDoc* doc, uint pageNr);
 };
 
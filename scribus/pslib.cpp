@@ -24,6 +24,7 @@ for which a new license (GPL+exception) is in place.
 #include "pslib.h"
 
 #include <cstdlib>
+#include <cstring>
 
 #include <QFileInfo>
 #include <QImage>
@@ -221,6 +222,9 @@ PSLib::PSLib(PrintOptions &options, bool psart, SCFonts &AllFonts, QMap<QString,
 	Titel = "";
 	FillColor = "0.0 0.0 0.0 0.0";
 	StrokeColor = "0.0 0.0 0.0 0.0";
+	// reserved, so that resize(0) keeps the memory
+	m_lineBuffer.reserve(256);
+	m_numberBuffer.reserve(32);
 	Header = psart ? "%!PS-Adobe-3.0\n" : "%!PS-Adobe-3.0 EPSF-3.0\n";
 	BBox = "";
 	BBoxH = "";
@@ -418,6 +422,16 @@ void PSLib::PutStream(const QString& c)
 	spoolStream.writeRawData(utf8Array.data(), utf8Array.length());
 }
 
+void PSLib::PutStream(const char* c)
+{
+	spoolStream.writeRawData(c, strlen(c));
+}
+
+void PSLib::PutStream(const QByteArray& array)
+{
+	spoolStream.writeRawData(array.data(), array.size());
+}
+
 void PSLib::PutStream(const QByteArray& array, bool hexEnc)
 {
 	if(hexEnc)
@@ -527,10 +541,18 @@ void PSLib::WriteASCII85Bytes(const unsigned char* array, int length)
 	filter.closeFilter();
 }
 
+void PSLib::PutOperator(const double* values, int count, const char* op)
+{
+	m_lineBuffer.resize(0);
+	appendOperator(m_lineBuffer, values, count, 5, op);
+	spoolStream.writeRawData(m_lineBuffer.constData(), m_lineBuffer.size());
+}
+
 QString PSLib::ToStr(double c)
 {
-	QString cc;
-	return cc.setNum(c);
+	m_numberBuffer.resize(0);
+	appendDecimal(m_numberBuffer, c, 5);
+	return QString::fromLatin1(m_numberBuffer.constData(), m_numberBuffer.size());
 }
 
 QString PSLib::IToStr(int c)
@@ -541,8 +563,17 @@ QString PSLib::IToStr(int c)
 
 QString PSLib::MatrixToStr(double m11, double m12, double m21, double m22, double x, double y)
 {
-	QString cc("[%1 %2 %3 %4 %5 %6]");
-	return  cc.arg(m11).arg(m12).arg(m21).arg(m22).arg(x).arg(y);
+	double values[] = { m11, m12, m21, m22, x, y };
+	m_numberBuffer.resize(0);
+	m_numberBuffer.append('[');
+	for (int i = 0; i < 6; ++i)
+	{
+		if (i > 0)
+			m_numberBuffer.append(' ');
+		appendDecimal(m_numberBuffer, values[i], 5);
+	}
+	m_numberBuffer.append(']');
+	return QString::fromLatin1(m_numberBuffer.constData(), m_numberBuffer.size());
 }
 
 void PSLib::PS_set_Info(QString art, QString was)
@@ -936,17 +967,20 @@ void PSLib::PS_end_page()
 
 void PSLib::PS_curve(double x1, double y1, double x2, double y2, double x3, double y3)
 {
-	PutStream(ToStr(x1) + " " + ToStr(y1) + " " + ToStr(x2) + " " + ToStr(y2) + " " + ToStr(x3) + " " + ToStr(y3) + " cu\n");
+	double values[] = { x1, y1, x2, y2, x3, y3 };
+	PutOperator(values, 6, "cu");
 }
 
 void PSLib::PS_moveto(double x, double y)
 {
-	PutStream(ToStr(x) + " " + ToStr(y) + " m\n");
+	double values[] = { x, y };
+	PutOperator(values, 2, "m");
 }
 
 void PSLib::PS_lineto(double x, double y)
 {
-	PutStream(ToStr(x) + " " + ToStr(y) + " li\n");
+	double values[] = { x, y };
+	PutOperator(values, 2, "li");
 }
 
 void PSLib::PS_closepath()
@@ -956,17 +990,19 @@ void PSLib::PS_closepath()
 
 void PSLib::PS_translate(double x, double y)
 {
-	PutStream(ToStr(x) + " " + ToStr(y) + " tr\n");
+	double values[] = { x, y };
+	PutOperator(values, 2, "tr");
 }
 
 void PSLib::PS_scale(double x, double y)
 {
-	PutStream(ToStr(x) + " " + ToStr(y) + " sc\n");
+	double values[] = { x, y };
+	PutOperator(values, 2, "sc");
 }
 
 void PSLib::PS_rotate(double x)
 {
-	PutStream(ToStr(x) + " ro\n");
+	PutOperator(&x, 1, "ro");
 }
 
 void PSLib::PS_clip(bool mu)
@@ -986,7 +1022,14 @@ void PSLib::PS_restore()
 
 void PSLib::PS_setcmykcolor_fill(double c, double m, double y, double k)
 {
-	FillColor = ToStr(c) + " " + ToStr(m) + " " + ToStr(y) + " " + ToStr(k);
+	FillColor.resize(0);
+	appendDecimal(FillColor, c, 5);
+	FillColor.append(' ');
+	appendDecimal(FillColor, m, 5);
+	FillColor.append(' ');
+	appendDecimal(FillColor, y, 5);
+	FillColor.append(' ');
+	appendDecimal(FillColor, k, 5);
 }
 
 void PSLib::PS_setcmykcolor_dummy()
@@ -996,12 +1039,19 @@ void PSLib::PS_setcmykcolor_dummy()
 
 void PSLib::PS_setcmykcolor_stroke(double c, double m, double y, double k)
 {
-	StrokeColor = ToStr(c) + " " + ToStr(m) + " " + ToStr(y) + " " + ToStr(k);
+	StrokeColor.resize(0);
+	appendDecimal(StrokeColor, c, 5);
+	StrokeColor.append(' ');
+	appendDecimal(StrokeColor, m, 5);
+	StrokeColor.append(' ');
+	appendDecimal(StrokeColor, y, 5);
+	StrokeColor.append(' ');
+	appendDecimal(StrokeColor, k, 5);
 }
 
 void PSLib::PS_setlinewidth(double w)
 {
-	PutStream(ToStr(w) + " sw\n");
+	PutOperator(&w, 1, "sw");
 	LineW = w;
 }
 
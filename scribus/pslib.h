@@ -149,6 +149,8 @@ class SCRIBUS_API PSLib : public QObject
 	private:
 
 		void PutStream (const QString& c);
+		void PutStream (const char* c);
+		void PutStream (const QByteArray& array);
 		void PutStream (const QByteArray& array, bool hexEnc);
 		void PutStream (const char* in, int length, bool hexEnc);
 
@@ -165,6 +167,9 @@ class SCRIBUS_API PSLib : public QObject
 
 		Optimization optimization;
 
+		/// writes count numbers followed by the operator op and a newline, without any QString
+		void PutOperator(const double* values, int count, const char* op);
+
 		QString ToStr(double c);
 		QString IToStr(int c);
 		QString MatrixToStr(double m11, double m12, double m21, double m22, double x, double y);
@@ -183,8 +188,8 @@ class SCRIBUS_API PSLib : public QObject
 		QString GrayCalc;
 		bool GraySc;
 		int Seiten;
-		QString FillColor;
-		QString StrokeColor;
+		QByteArray FillColor;
+		QByteArray StrokeColor;
 		double LineW;
 		QString Fonts;
 		QString FontDesc;
@@ -194,6 +199,8 @@ class SCRIBUS_API PSLib : public QObject
 		bool isPDF;
 		QFile Spool;
 		QDataStream spoolStream;
+		QByteArray m_lineBuffer;
+		QByteArray m_numberBuffer;
 		int  Plate;
 		bool DoSep;
 		bool useSpotColors;
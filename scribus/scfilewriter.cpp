@@ -0,0 +1,99 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "scfilewriter.h"
+
+#include <cstdlib>
+#include <ctime>
+
+#include <QCoreApplication>
+#include <QScopedPointer>
+
+#include "qtiocompressor.h"
+
+ScFileWriter::ScFileWriter(const QString& fileName, const QByteArray& data, QObject* parent)
+	: QThread(parent),
+	  m_fileName(fileName),
+	  m_data(data),
+	  m_setPermissions(false),
+	  m_succeeded(false)
+{
+	// Create a random temporary file name, here as rand() is not thread safe
+	srand(time(NULL)); // initialize random sequence each time
+	long     randt = 0, randn = 1 + (int) (((double) rand() / ((double) RAND_MAX + 1)) * 10000);
+	m_tmpFileName = QString("%1.%2").arg(fileName).arg(randn);
+	while (QFile::exists(m_tmpFileName) && (randt < 100))
+	{
+		randn = 1 + (int) (((double) rand() / ((double) RAND_MAX + 1)) * 10000);
+		m_tmpFileName = QString("%1.%2").arg(fileName).arg(randn);
+		++randt;
+	}
+}
+
+void ScFileWriter::setPermissions(QFile::Permissions permissions)
+{
+	m_permissions = permissions;
+	m_setPermissions = true;
+}
+
+bool ScFileWriter::write()
+{
+	m_succeeded = false;
+	m_writtenFile.clear();
+	if (QFile::exists(m_tmpFileName))
+		return false;
+
+	QFile file(m_tmpFileName);
+	QScopedPointer<QtIOCompressor> compressor;
+	QIODevice* outputFile = &file;
+	if (m_fileName.toLower().right(2) == "gz")
+	{
+		compressor.reset(new QtIOCompressor(&file));
+		compressor->setStreamFormat(QtIOCompressor::GzipFormat);
+		outputFile = compressor.data();
+	}
+	if (!outputFile->open(QIODevice::WriteOnly))
+		return false;
+
+	bool writeSucceed = (outputFile->write(m_data) == m_data.size());
+	outputFile->close();
+	writeSucceed = writeSucceed && (file.error() == QFile::NoError);
+
+	if (writeSucceed)
+	{
+		if (QFile::exists(m_fileName))
+			writeSucceed = QFile::remove(m_fileName) ? QFile::rename(m_tmpFileName, m_fileName) : false;
+		else
+			writeSucceed = QFile::rename(m_tmpFileName, m_fileName);
+		m_writtenFile = writeSucceed ? m_fileName : m_tmpFileName;
+	}
+	else if (QFile::exists(m_tmpFileName))
+		QFile::remove(m_tmpFileName);
+#ifdef Q_OS_UNIX
+	if (writeSucceed && m_setPermissions)
+		QFile::setPermissions(m_fileName, m_permissions);
+#endif
+	m_succeeded = writeSucceed;
+	return writeSucceed;
+}
+
+bool ScFileWriter::writeAndWait()
+{
+	if (!QCoreApplication::instance())
+		return write();
+	start();
+	// no user input while waiting, the caller relies on the document staying as saved
+	while (!wait(50))
+		QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+	return m_succeeded;
+}
+
+void ScFileWriter::run()
+{
+	write();
+	emit fileWritten(m_succeeded);
+}
@@ -0,0 +1,64 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCFILEWRITER_H
+#define SCFILEWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QThread>
+
+#include "scribusapi.h"
+
+/*! \brief Writes a serialized document to disk.
+
+The data is written to a temporary file next to the target, gzip compressed
+if the target name ends with "gz", and renamed over the target once it is
+complete, so an interrupted save never leaves a truncated document behind.
+
+The data is an immutable copy of the document, so writing doesn't need the
+document any more and may run on a background thread with start(). The
+fileWritten() signal is emitted from that thread once it is done.
+*/
+class SCRIBUS_API ScFileWriter : public QThread
+{
+	Q_OBJECT
+
+public:
+	ScFileWriter(const QString& fileName, const QByteArray& data, QObject* parent = 0);
+
+	/// Permissions applied to the written file on Unix
+	void setPermissions(QFile::Permissions permissions);
+
+	/// Writes the file on the calling thread, returns true on success.
+	bool write();
+	/// Writes the file on a worker thread, repainting the GUI until it is done.
+	bool writeAndWait();
+
+	const QString& fileName() const { return m_fileName; }
+	bool succeeded() const { return m_succeeded; }
+	/// The target on success, the temporary file if only the final rename failed, empty otherwise
+	const QString& writtenFile() const { return m_writtenFile; }
+
+signals:
+	void fileWritten(bool success);
+
+protected:
+	virtual void run();
+
+private:
+	QString    m_fileName;
+	QString    m_tmpFileName;
+	QByteArray m_data;
+	QFile::Permissions m_permissions;
+	bool       m_setPermissions;
+	bool       m_succeeded;
+	QString    m_writtenFile;
+};
+
+#endif
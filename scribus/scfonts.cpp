@@ -24,7 +24,12 @@ for which a new license (GPL+exception) is in place.
 #include <QGlobalStatic>
 #include <QMap>
 #include <QRegExp>
+#include <QRunnable>
+#include <QSet>
 #include <QString>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
 
 
 #include <cstdlib>
@@ -115,90 +120,101 @@ void SCFonts::AddPath(QString p)
 		FontPath.insert(FontPath.count(),p);
 }
 
-void SCFonts::AddScalableFonts(const QString &path, QString DocName)
+/* Collects the font files below path in directory order. Subdirectories
+   are only searched when recurse is true, symlinks pointing back to a
+   parent directory are skipped to avoid infinite recursion.
+*/
+static void findFontFiles(const QString& path, bool recurse, QStringList& files)
 {
-	//Make sure this is not empty or we will scan the whole drive on *nix
-	//QString::null+/ is / of course.
-	if (path.isEmpty())
-		return;
-	FT_Library library = NULL;
 	QString pathfile, fullpath;
-//	bool error;
-//	error =
-	FT_Init_FreeType( &library );
 	QString pathname(path);
 	if ( !pathname.endsWith("/") )
 		pathname += "/";
 	pathname=QDir::toNativeSeparators(pathname);
 	QDir d(pathname, "*", QDir::Name, QDir::Dirs | QDir::Files | QDir::Readable);
-	if ((d.exists()) && (d.count() != 0))
+	if ((!d.exists()) || (d.count() == 0))
+		return;
+	for (uint dc = 0; dc < d.count(); ++dc)
 	{
-		for (uint dc = 0; dc < d.count(); ++dc)
+		// readdir may return . or .., which we don't want to recurse
+		// over. Skip 'em.
+		if (d[dc] == "." || d[dc] == "..")
+			continue;
+		fullpath = pathname+d[dc];
+		QFileInfo fi(fullpath);
+		if (!fi.exists())      // Sanity check for broken Symlinks
+			continue;
+
+		qApp->processEvents();
+
+		bool symlink = fi.isSymLink();
+		if (symlink)
 		{
-			// readdir may return . or .., which we don't want to recurse
-			// over. Skip 'em.
-			if (d[dc] == "." || d[dc] == "..")
-				continue;
-			fullpath = pathname+d[dc];
-			QFileInfo fi(fullpath);
-			if (!fi.exists())      // Sanity check for broken Symlinks
-				continue;
-			
-			qApp->processEvents();
-			
-			bool symlink = fi.isSymLink();
-			if (symlink)
-			{
-				QFileInfo fi3(fi.readLink());
-				if (fi3.isRelative())
-					pathfile = pathname+fi.readLink();
-				else
-					pathfile = fi3.absoluteFilePath();
-			}
+			QFileInfo fi3(fi.readLink());
+			if (fi3.isRelative())
+				pathfile = pathname+fi.readLink();
 			else
-				pathfile = fullpath;
-			QFileInfo fi2(pathfile);
-			if (fi2.isDir()) 
+				pathfile = fi3.absoluteFilePath();
+		}
+		else
+			pathfile = fullpath;
+		QFileInfo fi2(pathfile);
+		if (fi2.isDir())
+		{
+			if (symlink)
 			{
-				if (symlink)
+				// Check if symlink points to a parent directory
+				// in order to avoid infinite recursion
+				QString fullpath2 = fullpath, pathfile2 = pathfile;
+				if (ScCore->isWinGUI())
 				{
-					// Check if symlink points to a parent directory
-					// in order to avoid infinite recursion
-					QString fullpath2 = fullpath, pathfile2 = pathfile;
-					if (ScCore->isWinGUI())
-					{
-						// Ensure both path use same separators on Windows
-						fullpath2 = QDir::toNativeSeparators(fullpath2.toLower());
-						pathfile2 = QDir::toNativeSeparators(pathfile2.toLower());
-					}
-					if (fullpath2.startsWith(pathfile2))
-						continue;
+					// Ensure both path use same separators on Windows
+					fullpath2 = QDir::toNativeSeparators(fullpath2.toLower());
+					pathfile2 = QDir::toNativeSeparators(pathfile2.toLower());
 				}
-				if (DocName.isEmpty())
-					AddScalableFonts(pathfile);
-				continue;
-			}
-			QString ext = fi.suffix().toLower();
-			QString ext2 = fi2.suffix().toLower();
-			if ((ext != ext2) && (ext.isEmpty())) 
-				ext = ext2;
-			if ((ext == "ttc") || (ext == "dfont") || (ext == "pfa") || (ext == "pfb") || (ext == "ttf") || (ext == "otf"))
-			{
-				AddScalableFont(pathfile, library, DocName);
+				if (fullpath2.startsWith(pathfile2))
+					continue;
 			}
-#ifdef Q_OS_MAC
-			else if (ext.isEmpty() && DocName.isEmpty())
-			{
-				bool error = AddScalableFont(pathfile, library, DocName);
-				if (error)
-					error = AddScalableFont(pathfile + "/..namedfork/rsrc",library, DocName);
-			}
-#endif				
+			if (recurse)
+				findFontFiles(pathfile, recurse, files);
+			continue;
 		}
+		QString ext = fi.suffix().toLower();
+		QString ext2 = fi2.suffix().toLower();
+		if ((ext != ext2) && (ext.isEmpty()))
+			ext = ext2;
+		if ((ext == "ttc") || (ext == "dfont") || (ext == "pfa") || (ext == "pfb") || (ext == "ttf") || (ext == "otf"))
+			files.append(pathfile);
+#ifdef Q_OS_MAC
+		else if (ext.isEmpty() && recurse)
+			files.append(pathfile);
+#endif
 	}
-	FT_Done_FreeType(library);
 }
 
+void SCFonts::AddScalableFonts(const QString &path, QString DocName)
+{
+	//Make sure this is not empty or we will scan the whole drive on *nix
+	//QString::null+/ is / of course.
+	if (path.isEmpty())
+		return;
+	QStringList files;
+	findFontFiles(path, DocName.isEmpty(), files);
+	QStringList failed = AddScalableFontFiles(files, DocName);
+#ifdef Q_OS_MAC
+	// Fonts without extension may keep their data in the resource fork
+	QStringList forks;
+	for (int i = 0; i < failed.count(); ++i)
+	{
+		if (QFileInfo(failed[i]).suffix().isEmpty())
+			forks.append(failed[i] + "/..namedfork/rsrc");
+	}
+	if (!forks.isEmpty())
+		AddScalableFontFiles(forks, DocName);
+#else
+	Q_UNUSED(failed);
+#endif
+}
 
 /*****
    What to do with font files:
@@ -428,58 +444,70 @@ ScFace SCFonts::LoadScalableFont(const QString &filename)
 	return t;
 }
 
-// Load a single font into the library from the passed filename. Returns true on error.
-bool SCFonts::AddScalableFont(QString filename, FT_Library &library, QString DocName)
+/**
+ * Scans a share of the pending font files on a worker thread. Each task
+ * owns its FreeType library since an FT_Library must not be used from
+ * several threads at once.
+ */
+class SCFonts::ScanTask : public QRunnable
 {
-	static bool firstRun;
-	bool Subset = false;
-	char *buf[50];
-	QString glyName = "";
-	ScFace::FontFormat format;
-	ScFace::FontType   type;
-	FT_Face         face = NULL;
-	struct testCache foCache;
-	QFileInfo fic(filename);
-	QDateTime lastMod = fic.lastModified();
-	QTime lastModTime = lastMod.time();
-	if (lastModTime.msec() != 0)  //Sometime file time is stored with precision up to msecs
+public:
+	ScanTask(ScanJob* jobs, int count, int first, int step) :
+		m_jobs(jobs),
+		m_count(count),
+		m_first(first),
+		m_step(step)
 	{
-		lastModTime.setHMS(lastModTime.hour(), lastModTime.minute(), lastModTime.second());
-		lastMod.setTime(lastModTime);
 	}
-	foCache.isOK = false;
-	foCache.isChecked = true;
-	foCache.lastMod = lastMod;
-	if (checkedFonts.count() == 0)
+
+	void run()
 	{
-		firstRun = true;
-		ScCore->setSplashStatus( QObject::tr("Creating Font Cache") );
+		FT_Library library = NULL;
+		if (FT_Init_FreeType(&library))
+			return;
+		for (int i = m_first; i < m_count; i += m_step)
+			SCFonts::scanFontFile(library, m_jobs[i]);
+		FT_Done_FreeType(library);
 	}
-	bool error = FT_New_Face( library, QFile::encodeName(filename), 0, &face );
-	if (error || (face == NULL)) 
+
+private:
+	ScanJob* m_jobs;
+	int m_count;
+	int m_first;
+	int m_step;
+};
+
+// Extracts everything SCFonts needs about the faces of a font file. Runs on worker threads.
+void SCFonts::scanFontFile(FT_Library library, ScanJob& job)
+{
+	testCache& foCache(job.result);
+	foCache.isOK = false;
+	foCache.isChecked = true;
+	foCache.faces.clear();
+	FT_Face face = NULL;
+	bool error = FT_New_Face( library, QFile::encodeName(job.fileName), 0, &face );
+	if (error || (face == NULL))
 	{
 		if (face != NULL)
 			FT_Done_Face(face);
-		checkedFonts.insert(filename, foCache);
-		if (showFontInformation)
-			sDebug(QObject::tr("Font %1 is broken, discarding it").arg(filename));
-		return true;
+		job.messages.append(QObject::tr("Font %1 is broken, discarding it").arg(job.fileName));
+		return;
 	}
+	ScFace::FontFormat format;
+	ScFace::FontType   type;
 	getFontFormat(face, format, type);
-	if (format == ScFace::UNKNOWN_FORMAT) 
+	if (format == ScFace::UNKNOWN_FORMAT)
 	{
-		if (showFontInformation)
-			sDebug(QObject::tr("Failed to load font %1 - font type unknown").arg(filename));
+		job.messages.append(QObject::tr("Failed to load font %1 - font type unknown").arg(job.fileName));
 		FT_Done_Face(face);
-		checkedFonts.insert(filename, foCache);
-		return true;
+		return;
 	}
 	bool HasNames = FT_HAS_GLYPH_NAMES(face);
-
-	if (!checkedFonts.contains(filename))
+	bool Subset = false;
+	if (job.checkGlyphs)
 	{
-		if (!firstRun)
-			ScCore->setSplashStatus( QObject::tr("New Font found, checking...") );
+		char buf[50];
+		QString glyName = "";
 		FT_UInt gindex = 0;
 		FT_ULong charcode = FT_Get_First_Char( face, &gindex );
 		while ( gindex != 0 )
@@ -487,14 +515,12 @@ bool SCFonts::AddScalableFont(QString filename, FT_Library &library, QString Doc
 			error = FT_Load_Glyph(face, gindex, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP);
 			if (error)
 			{
-				if (showFontInformation)
-					sDebug(QObject::tr("Font %1 has broken glyph %2 (charcode %3)").arg(filename).arg(gindex).arg(charcode));
+				job.messages.append(QObject::tr("Font %1 has broken glyph %2 (charcode %3)").arg(job.fileName).arg(gindex).arg(charcode));
 				FT_Done_Face(face);
-				checkedFonts.insert(filename, foCache);
-				return true;
+				return;
 			}
 			FT_Get_Glyph_Name(face, gindex, buf, 50);
-			QString newName = QString(reinterpret_cast<char*>(buf));
+			QString newName = QString(buf);
 			if (newName == glyName)
 			{
 				HasNames = false;
@@ -503,85 +529,173 @@ bool SCFonts::AddScalableFont(QString filename, FT_Library &library, QString Doc
 			glyName = newName;
 			charcode = FT_Get_Next_Char( face, charcode, &gindex );
 		}
-		foCache.isOK = true;
-		checkedFonts.insert(filename, foCache);
-	}
-	else
-	{
-		if (!checkedFonts[filename].isOK)
-		{
-			checkedFonts[filename].isChecked = true;
-			FT_Done_Face(face);
-			return true;
-		}
-		if (checkedFonts[filename].lastMod != foCache.lastMod)
-		{
-			ScCore->setSplashStatus( QObject::tr("Modified Font found, checking...") );
-			FT_UInt gindex = 0;
-			FT_ULong charcode = FT_Get_First_Char( face, &gindex );
-			while ( gindex != 0 )
-			{
-				error = FT_Load_Glyph(face, gindex, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP);
-				if (error)
-				{
-					if (showFontInformation)
-						sDebug(QObject::tr("Font %1 has broken glyph %2 (charcode %3)").arg(filename).arg(gindex).arg(charcode));
-					FT_Done_Face(face);
-					checkedFonts.insert(filename, foCache);
-					return true;
-				}
-				FT_Get_Glyph_Name(face, gindex, buf, 50);
-				QString newName = QString(reinterpret_cast<char*>(buf));
-				if (newName == glyName)
-				{
-					HasNames = false;
-					Subset = true;
-				}
-				glyName = newName;
-				charcode = FT_Get_Next_Char( face, charcode, &gindex );
-			}
-			foCache.isOK = true;
-			checkedFonts[filename] = foCache;
-		}
-		else
-		{
-			checkedFonts[filename].isOK = true;
-			checkedFonts[filename].isChecked = true;
-		}
 	}
+	foCache.isOK = true;
 
 	int faceIndex = 0;
 	while (!error)
 	{
-		QString fam(face->family_name);
-		QString sty(face->style_name);
-		if (sty == "Regular")
+		cachedFace info;
+		info.family = QString(face->family_name);
+		info.style = QString(face->style_name);
+		if (info.style == "Regular")
 		{
 			switch (face->style_flags)
 			{
 				case 0:
 					break;
 				case 1:
-					sty = "Italic";
+					info.style = "Italic";
 					break;
 				case 2:
-					sty = "Bold";
+					info.style = "Bold";
 					break;
 				case 3:
-					sty = "Bold Italic";
+					info.style = "Bold Italic";
 					break;
 				default:
 					break;
 			}
 		}
-		QString ts(fam + " " + sty);
-		QString alt("");
 		const char* psName = FT_Get_Postscript_Name(face);
-		QString qpsName;
 		if (psName)
-			qpsName = QString(psName);
+			info.psName = QString(psName);
+		else
+			info.psName = info.family + " " + info.style;
+		info.faceIndex = faceIndex;
+		info.format = format;
+		info.type = type;
+		info.subset = Subset;
+		switch (format)
+		{
+			case ScFace::PFA:
+			case ScFace::PFB:
+				info.type = ScFace::TYPE1;
+				break;
+			case ScFace::SFNT:
+			case ScFace::TYPE42:
+				info.type = ScFace::UNKNOWN_TYPE;
+				getSFontType(face, info.type);
+				if (info.type == ScFace::OTF)
+					info.subset = true;
+				break;
+			case ScFace::TTCF:
+				info.type = ScFace::TTF;
+				break;
+			default:
+				break;
+		}
+		if (face->num_glyphs > 2048)
+			info.subset = true;
+		info.hasGlyphNames = HasNames;
+		foCache.faces.append(info);
+		if ((++faceIndex) >= face->num_faces)
+			break;
+		FT_Done_Face(face);
+		face = NULL;
+		error = FT_New_Face(library, QFile::encodeName(job.fileName), faceIndex, &face);
+	} //while
+
+	if (face != 0)
+		FT_Done_Face(face);
+}
+
+/* Loads font files into the library. Files whose faces are in the font
+   cache and unchanged are added without touching FreeType, the others are
+   scanned in parallel first. Faces are registered in the order of files,
+   so name clashes are resolved as if the files were loaded one by one.
+   Returns the files that could not be loaded.
+*/
+QStringList SCFonts::AddScalableFontFiles(const QStringList& files, const QString& DocName)
+{
+	static bool firstRun;
+	QStringList failed;
+	QVector<ScanJob> jobs;
+	QSet<QString> pending;
+	bool modifiedFound = false;
+	if (checkedFonts.count() == 0)
+		firstRun = true;
+	for (int i = 0; i < files.count(); ++i)
+	{
+		const QString& filename(files[i]);
+		if (pending.contains(filename))
+			continue;
+		QFileInfo fic(filename);
+		QDateTime lastMod = fic.lastModified();
+		QTime lastModTime = lastMod.time();
+		if (lastModTime.msec() != 0)  //Sometime file time is stored with precision up to msecs
+		{
+			lastModTime.setHMS(lastModTime.hour(), lastModTime.minute(), lastModTime.second());
+			lastMod.setTime(lastModTime);
+		}
+		QMap<QString, testCache>::Iterator it = checkedFonts.find(filename);
+		bool unchanged = (it != checkedFonts.end()) && (it.value().lastMod == lastMod);
+		if (unchanged && (!it.value().isOK || !it.value().faces.isEmpty()))
+		{
+			it.value().isChecked = true;
+			continue;
+		}
+		ScanJob job;
+		job.fileName = filename;
+		// caches written by older versions only know that the glyphs are fine
+		job.checkGlyphs = !(unchanged && it.value().isOK);
+		job.result.lastMod = lastMod;
+		jobs.append(job);
+		pending.insert(filename);
+		if (it != checkedFonts.end())
+			modifiedFound = true;
+	}
+
+	if (!jobs.isEmpty())
+	{
+		if (firstRun)
+			ScCore->setSplashStatus( QObject::tr("Creating Font Cache") );
+		else if (modifiedFound)
+			ScCore->setSplashStatus( QObject::tr("Modified Font found, checking...") );
 		else
-			qpsName = ts;
+			ScCore->setSplashStatus( QObject::tr("New Font found, checking...") );
+		int threads = qBound(1, QThread::idealThreadCount(), jobs.count());
+		QThreadPool pool;
+		pool.setMaxThreadCount(threads);
+		for (int i = 0; i < threads; ++i)
+			pool.start(new ScanTask(jobs.data(), jobs.count(), i, threads));
+		while (!pool.waitForDone(50))
+			qApp->processEvents();
+		for (int i = 0; i < jobs.count(); ++i)
+		{
+			if (showFontInformation)
+			{
+				for (int m = 0; m < jobs[i].messages.count(); ++m)
+					sDebug(jobs[i].messages[m]);
+			}
+			if (jobs[i].result.isChecked)
+				checkedFonts.insert(jobs[i].fileName, jobs[i].result);
+		}
+	}
+
+	for (int i = 0; i < files.count(); ++i)
+	{
+		QMap<QString, testCache>::ConstIterator it = checkedFonts.constFind(files[i]);
+		if ((it == checkedFonts.constEnd()) || !AddCachedFaces(files[i], it.value(), DocName))
+			failed.append(files[i]);
+	}
+	return failed;
+}
+
+// Creates the faces of a scanned font file. Returns false if the file is not usable.
+bool SCFonts::AddCachedFaces(const QString& filename, const testCache& foCache, const QString& DocName)
+{
+	if (!foCache.isOK || foCache.faces.isEmpty())
+		return false;
+	for (int i = 0; i < foCache.faces.count(); ++i)
+	{
+		const cachedFace& info(foCache.faces[i]);
+		int faceIndex = info.faceIndex;
+		QString fam(info.family);
+		QString sty(info.style);
+		QString ts(fam + " " + sty);
+		QString alt("");
+		QString qpsName(info.psName);
 		ScFace t;
 		if (contains(ts))
 		{
@@ -593,79 +707,43 @@ bool SCFonts::AddScalableFont(QString filename, FT_Library &library, QString Doc
 				sty += alt;
 			}
 		}
-		t = (*this)[ts];
+		t = value(ts);
 		if (t.isNone())
 		{
-			switch (format) 
+			switch (info.format)
 			{
 				case ScFace::PFA:
 					t = ScFace(new ScFace_pfa(fam, sty, "", ts, qpsName, filename, faceIndex));
-					t.subset(Subset);
 					break;
 				case ScFace::PFB:
 					t = ScFace(new ScFace_pfb(fam, sty, "", ts, qpsName, filename, faceIndex));
-					t.subset(Subset);
 					break;
 				case ScFace::SFNT:
+				case ScFace::TYPE42:
 					t = ScFace(new ScFace_ttf(fam, sty, "", ts, qpsName, filename, faceIndex));
-					getSFontType(face, t.m_m->typeCode);
-					if (t.type() == ScFace::OTF) 
-					{
-						t.subset(true);
-					}
-					else
-						t.subset(Subset);
+					t.m_m->typeCode = info.type;
 					break;
 				case ScFace::TTCF:
 					t = ScFace(new ScFace_ttf(fam, sty, "", ts, qpsName, filename, faceIndex));
 					t.m_m->formatCode = ScFace::TTCF;
-					t.m_m->typeCode = ScFace::TTF;
-					//getSFontType(face, t.m->typeCode);
-					if (t.type() == ScFace::OTF) 
-					{
-						t.subset(true);
-					}
-					else
-						t.subset(Subset);
-					break;
-				case ScFace::TYPE42:
-					t = ScFace(new ScFace_ttf(fam, sty, "", ts, qpsName, filename, faceIndex));
-					getSFontType(face, t.m_m->typeCode);
-					if (t.type() == ScFace::OTF) 
-					{
-						t.subset(true);
-					}
-					else
-						t.subset(Subset);
+					t.m_m->typeCode = info.type;
 					break;
 				default:
 				/* catching any types not handled above to silence compiler */
-					break;
+					continue;
 			}
 			insert(ts,t);
-			t.m_m->hasGlyphNames = HasNames;
+			t.subset(info.subset);
+			t.m_m->hasGlyphNames = info.hasGlyphNames;
 			t.embedPs(true);
 			t.usable(true);
 			t.m_m->status = ScFace::UNKNOWN;
-			if (face->num_glyphs > 2048)
-				t.subset(true);
 			t.m_m->forDocument = DocName;
 			//setBestEncoding(face); //AV
 			if (showFontInformation)
 				sDebug(QObject::tr("Font %1 loaded from %2(%3)").arg(t.psName()).arg(filename).arg(faceIndex+1));
-
-/*
-//debug
-			QByteArray bb;
-			t->RawData(bb);
-			QFile dump(QString("/tmp/fonts/%1-%2").arg(ts).arg(psName));
-			dump.open(IO_WriteOnly);
-			QDataStream os(&dump);
-			os.writeRawBytes(bb.data(), bb.size());
-			dump.close();
-*/
 		}
-		else 
+		else
 		{
 			if (showFontInformation)
 				sDebug(QObject::tr("Font %1(%2) is duplicate of %3").arg(filename).arg(faceIndex+1).arg(t.fontPath()));
@@ -674,18 +752,9 @@ bool SCFonts::AddScalableFont(QString filename, FT_Library &library, QString Doc
 				break;
 			}
 		}
-		if ((++faceIndex) >= face->num_faces)
-			break;
-		FT_Done_Face(face);
-		face = NULL;
-		error = FT_New_Face(library, QFile::encodeName(filename), faceIndex, &face);
-	} //while
-	
-	if (face != 0)
-		FT_Done_Face(face);
-	return error && faceIndex == 0;
+	}
+	return true;
 }
-
 void SCFonts::removeFont(QString name)
 {
 	remove(name);
@@ -769,11 +838,8 @@ void SCFonts::AddFontconfigFonts()
 	FcFontSet* fs = FcFontList(config, pat, os);
 	FcObjectSetDestroy(os);
 	FcPatternDestroy(pat);
-	// Create the Freetype library
-//	bool error;
-	FT_Library library = NULL;
-	FT_Init_FreeType( &library );
-	// Now iterate over the font files and load them
+	// Now collect the font files and load them
+	QStringList files;
 	int i;
 	for (i = 0; i < fs->nfont; i++) 
 	{
@@ -782,13 +848,13 @@ void SCFonts::AddFontconfigFonts()
 		{
 			if (showFontInformation)
 				sDebug(QObject::tr("Loading font %1 (found using fontconfig)").arg(QString((char*)file)));
-			AddScalableFont(QString((char*)file), library, "");
+			files.append(QString((char*)file));
 		}
 		else
 			if (showFontInformation)
 				sDebug(QObject::tr("Failed to load a font - freetype2 couldn't find the font file"));
 	}
-	FT_Done_FreeType(library);
+	AddScalableFontFiles(files, "");
 }
 
 #elif defined(Q_OS_LINUX)
@@ -905,6 +971,20 @@ void SCFonts::ReadCacheList(QString pf)
 			foCache.isChecked = false;
 			foCache.isOK = static_cast<bool>(dc.attribute("Status", "1").toInt());
 			foCache.lastMod = QDateTime::fromString(dc.attribute("Modified"), Qt::ISODate);
+			foCache.faces.clear();
+			for (QDomElement fc = dc.firstChildElement("Face"); !fc.isNull(); fc = fc.nextSiblingElement("Face"))
+			{
+				cachedFace info;
+				info.family = fc.attribute("Family");
+				info.style = fc.attribute("Style");
+				info.psName = fc.attribute("PSName");
+				info.faceIndex = fc.attribute("Index", "0").toInt();
+				info.format = static_cast<ScFace::FontFormat>(fc.attribute("Format", QString::number(ScFace::UNKNOWN_FORMAT)).toInt());
+				info.type = static_cast<ScFace::FontType>(fc.attribute("Type", QString::number(ScFace::UNKNOWN_TYPE)).toInt());
+				info.subset = static_cast<bool>(fc.attribute("Subset", "0").toInt());
+				info.hasGlyphNames = static_cast<bool>(fc.attribute("GlyphNames", "0").toInt());
+				foCache.faces.append(info);
+			}
 			checkedFonts.insert(dc.attribute("File"), foCache);
 		}
 		DOC = DOC.nextSibling();
@@ -926,6 +1006,20 @@ void SCFonts::WriteCacheList(QString pf)
 			fosu.setAttribute("File",it.key());
 			fosu.setAttribute("Status",static_cast<int>(it.value().isOK));
 			fosu.setAttribute("Modified",it.value().lastMod.toString(Qt::ISODate));
+			const QList<cachedFace>& faces(it.value().faces);
+			for (int i = 0; i < faces.count(); ++i)
+			{
+				QDomElement fc = docu.createElement("Face");
+				fc.setAttribute("Index", faces[i].faceIndex);
+				fc.setAttribute("Family", faces[i].family);
+				fc.setAttribute("Style", faces[i].style);
+				fc.setAttribute("PSName", faces[i].psName);
+				fc.setAttribute("Format", static_cast<int>(faces[i].format));
+				fc.setAttribute("Type", static_cast<int>(faces[i].type));
+				fc.setAttribute("Subset", static_cast<int>(faces[i].subset));
+				fc.setAttribute("GlyphNames", static_cast<int>(faces[i].hasGlyphNames));
+				fosu.appendChild(fc);
+			}
 			elem.appendChild(fosu);
 		}
 	}
@@ -52,10 +52,41 @@ class SCRIBUS_API SCFonts : public QMap<QString,ScFace>
 		/// maps family name to face variants
 		QMap<QString, QStringList> fontMap;
 	private:
+		/// what SCFonts needs to know to create a face, cached in checkfonts.xml
+		struct cachedFace
+		{
+			QString family;
+			QString style;
+			QString psName;
+			int faceIndex;
+			ScFace::FontFormat format;
+			ScFace::FontType type;
+			bool subset;
+			bool hasGlyphNames;
+		};
+		struct testCache
+		{
+			bool isOK;
+			bool isChecked;
+			QDateTime lastMod;
+			QList<cachedFace> faces;
+		};
+		/// a font file scanned by a worker thread
+		struct ScanJob
+		{
+			QString fileName;
+			bool checkGlyphs;
+			testCache result;
+			QStringList messages;
+		};
+		class ScanTask;
+
 		void ReadCacheList(QString pf);
 		void WriteCacheList(QString pf);
 		void AddPath(QString p);
-		bool AddScalableFont(QString filename, FT_Library &library, QString DocName);
+		static void scanFontFile(FT_Library library, ScanJob& job);
+		QStringList AddScalableFontFiles(const QStringList& files, const QString& DocName);
+		bool AddCachedFaces(const QString& filename, const testCache& foCache, const QString& DocName);
 		void AddUserPath(QString pf);
 #ifdef HAVE_FONTCONFIG
 		void AddFontconfigFonts();
@@ -67,12 +98,6 @@ class SCRIBUS_API SCFonts : public QMap<QString,ScFace>
 #endif
 		QStringList FontPath;
 		QString ExtraPath;
-		struct testCache
-		{
-			bool isOK;
-			bool isChecked;
-			QDateTime lastMod;
-		};
 		QMap<QString, testCache> checkedFonts;
 	protected:
 		bool showFontInformation;
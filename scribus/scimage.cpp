@@ -647,53 +647,54 @@ void ScImage::blur(int radius)
 
 bool ScImage::convolveImage(QImage *dest, const unsigned int order, const double *kernel)
 {
-	long widthk;
-	double red, green, blue, alpha;
-	double normalize, *normal_kernel;
-	register const double *k;
-	register unsigned int *q;
-	int x, y, mx, my, sx, sy;
-	long i;
-	int mcx, mcy;
-	widthk = order;
+	int widthk = order;
 	if((widthk % 2) == 0)
 		return(false);
-	normal_kernel = (double *)malloc(widthk*widthk*sizeof(double));
-	if(!normal_kernel)
-		return(false);
-	*dest = QImage(width(), height(), QImage::Format_ARGB32);
-	normalize=0.0;
-	for(i=0; i < (widthk*widthk); i++)
+	int w = width();
+	int h = height();
+	QVector<double> normal_kernel(widthk*widthk);
+	*dest = QImage(w, h, QImage::Format_ARGB32);
+	double normalize=0.0;
+	for(int i=0; i < (widthk*widthk); i++)
 		normalize += kernel[i];
 	if(fabs(normalize) <= 1.0e-12)
 		normalize=1.0;
 	normalize=1.0/normalize;
-	for(i=0; i < (widthk*widthk); i++)
+	for(int i=0; i < (widthk*widthk); i++)
 		normal_kernel[i] = normalize*kernel[i];
-	for(y=0; y < dest->height(); ++y)
-	{
-		sy = y-(widthk/2);
-		q = (unsigned int *)dest->scanLine(y);
-		for(x=0; x < dest->width(); ++x)
+	// Edge clamping is resolved once per column and once per row
+	// instead of for every kernel tap
+	QVector<int> columns(w + widthk - 1);
+	for(int i=0; i < columns.count(); ++i)
+		columns[i] = qBound(0, i - widthk/2, w-1);
+	QVector<const QRgb*> rows(widthk);
+	for(int y=0; y < h; ++y)
+	{
+		for(int mcy=0; mcy < widthk; ++mcy)
+			rows[mcy] = (const QRgb*)constScanLine(qBound(0, y - widthk/2 + mcy, h-1));
+		QRgb *q = (QRgb*)dest->scanLine(y);
+		for(int x=0; x < w; ++x)
 		{
-			k = normal_kernel;
-			red = green = blue = alpha = 0;
-			sy = y-(widthk/2);
-			for(mcy=0; mcy < widthk; ++mcy, ++sy)
+			const double *k = normal_kernel.constData();
+			const int *cols = columns.constData() + x;
+			double red = 0, green = 0, blue = 0, alpha = 0;
+			for(int mcy=0; mcy < widthk; ++mcy)
 			{
-				my = sy < 0 ? 0 : sy > height()-1 ? height()-1 : sy;
-				sx = x+(-widthk/2);
-				for(mcx=0; mcx < widthk; ++mcx, ++sx)
+				const QRgb *row = rows[mcy];
+				for(int mcx=0; mcx < widthk; ++mcx)
 				{
-					mx = sx < 0 ? 0 : sx > width()-1 ? width()-1 : sx;
-					int px = pixel(mx, my);
-					red += (*k)*(qRed(px)*257);
-					green += (*k)*(qGreen(px)*257);
-					blue += (*k)*(qBlue(px)*257);
-					alpha += (*k)*(qAlpha(px)*257);
-					++k;
+					QRgb px = row[cols[mcx]];
+					red += k[mcx]*qRed(px);
+					green += k[mcx]*qGreen(px);
+					blue += k[mcx]*qBlue(px);
+					alpha += k[mcx]*qAlpha(px);
 				}
+				k += widthk;
 			}
+			red *= 257;
+			green *= 257;
+			blue *= 257;
+			alpha *= 257;
 			red = red < 0 ? 0 : red > 65535 ? 65535 : red+0.5;
 			green = green < 0 ? 0 : green > 65535 ? 65535 : green+0.5;
 			blue = blue < 0 ? 0 : blue > 65535 ? 65535 : blue+0.5;
@@ -704,7 +705,6 @@ bool ScImage::convolveImage(QImage *dest, const unsigned int order, const double
 			             (unsigned char)(alpha/257UL));
 		}
 	}
-	free(normal_kernel);
 	return(true);
 }
 
@@ -761,16 +761,7 @@ void ScImage::sharpen(double radius, double sigma)
 	free(kernel);
 //	liberateMemory((void **) &kernel);
 	for( int yi=0; yi < dest.height(); ++yi )
-	{
-		QRgb *s = (QRgb*)(dest.scanLine( yi ));
-		QRgb *d = (QRgb*)(scanLine( yi ));
-		for(int xi=0; xi < dest.width(); ++xi )
-		{
-			(*d) = (*s);
-			s++;
-			d++;
-		}
-	}
+		memcpy(scanLine(yi), dest.constScanLine(yi), dest.width() * sizeof(QRgb));
 	return;
 }
 
@@ -814,33 +805,32 @@ void ScImage::applyCurve(const QVector<int>& curveTable, bool cmyk)
 {
 	int h = height();
 	int w = width();
-	QRgb *s;
-	QRgb r;
-	int c, m, y, k;
-	unsigned char *p;
-	for( int yi=0; yi < h; ++yi )
+	unsigned char table[256];
+	if (cmyk)
 	{
-		s = (QRgb*)(scanLine( yi ));
-		for( int xi=0; xi < w; ++xi )
+		// all four CMYK channels get the same mapping, so process the
+		// scanline as a flat byte array
+		for (int i = 0; i < 256; ++i)
+			table[i] = 255 - curveTable[255 - i];
+		for( int yi=0; yi < h; ++yi )
 		{
-			r = *s;
-			if (cmyk)
-			{
-				p = (unsigned char *) s;
-				p[0] = 255 - curveTable[255 - p[0]];
-				p[1] = 255 - curveTable[255 - p[1]];
-				p[2] = 255 - curveTable[255 - p[2]];
-				p[3] = 255 - curveTable[255 - p[3]];
-			}
-			else
+			unsigned char *p = scanLine( yi );
+			for( int xi=0; xi < 4 * w; ++xi )
+				p[xi] = table[p[xi]];
+		}
+	}
+	else
+	{
+		for (int i = 0; i < 256; ++i)
+			table[i] = curveTable[i];
+		for( int yi=0; yi < h; ++yi )
+		{
+			QRgb *s = (QRgb*)(scanLine( yi ));
+			for( int xi=0; xi < w; ++xi )
 			{
-				c = curveTable[qRed(r)];
-				m = curveTable[qGreen(r)];
-				y = curveTable[qBlue(r)];
-				k = qAlpha(r);
-				*s = qRgba(c, m, y, k);
+				QRgb r = s[xi];
+				s[xi] = qRgba(table[qRed(r)], table[qGreen(r)], table[qBlue(r)], qAlpha(r));
 			}
-			s++;
 		}
 	}
 }
@@ -1103,57 +1093,58 @@ void ScImage::invert(bool cmyk)
 {
 	int h = height();
 	int w = width();
-	unsigned char *p;
-	QRgb * s;
-	unsigned char c, m, y, k;
+	if (!cmyk)
+	{
+		for( int yi=0; yi < h; ++yi )
+		{
+			QRgb *s = (QRgb*)(scanLine( yi ));
+			for( int xi=0; xi < w; ++xi )
+				s[xi] ^= 0x00ffffff;
+		}
+		return;
+	}
 	for( int yi=0; yi < h; ++yi )
 	{
-		s = (QRgb*)(scanLine( yi ));
-		for( int xi=0; xi < w; ++xi )
+		unsigned char *p = scanLine( yi );
+		for( int xi=0; xi < w; ++xi, p += 4 )
 		{
-			if (cmyk)
-			{
-				p = (unsigned char *) s;
-				c = 255 - qMin(255, p[0] + p[3]);
-				m = 255 - qMin(255, p[1] + p[3]);
-				y = 255 - qMin(255, p[2] + p[3]);
-				k = qMin(qMin(c, m), y);
-				p[0] = c - k;
-				p[1] = m - k;
-				p[2] = y - k;
-				p[3] = k;
-			}
-			else
-				*s ^= 0x00ffffff;
-			s++;
+			unsigned char c = 255 - qMin(255, p[0] + p[3]);
+			unsigned char m = 255 - qMin(255, p[1] + p[3]);
+			unsigned char y = 255 - qMin(255, p[2] + p[3]);
+			unsigned char k = qMin(qMin(c, m), y);
+			p[0] = c - k;
+			p[1] = m - k;
+			p[2] = y - k;
+			p[3] = k;
 		}
 	}
 }
 
+// Integer form of qRound(0.3 * R + 0.59 * G + 0.11 * B), cheap enough to be vectorized
+static inline int grayValue(QRgb r)
+{
+	return (30 * qRed(r) + 59 * qGreen(r) + 11 * qBlue(r) + 50) / 100;
+}
+
 void ScImage::toGrayscale(bool cmyk)
 {
 	int h = height();
 	int w = width();
-	int k;
-	QRgb * s;
-	QRgb r;
 	for( int yi=0; yi < h; ++yi )
 	{
-		s = (QRgb*)(scanLine( yi ));
-		for( int xi=0; xi < w; ++xi )
+		QRgb *s = (QRgb*)(scanLine( yi ));
+		if (cmyk)
 		{
-			r = *s;
-			if (cmyk)
-			{
-				k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
-				*s = qRgba(0, 0, 0, k);
-			}
-			else
+			for( int xi=0; xi < w; ++xi )
+				s[xi] = qRgba(0, 0, 0, qMin(grayValue(s[xi]) + qAlpha(s[xi]), 255));
+		}
+		else
+		{
+			for( int xi=0; xi < w; ++xi )
 			{
-				k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-				*s = qRgba(k, k, k, qAlpha(r));
+				int k = grayValue(s[xi]);
+				s[xi] = qRgba(k, k, k, qAlpha(s[xi]));
 			}
-			s++;
 		}
 	}
 }
@@ -1251,25 +1242,18 @@ QByteArray ScImage::ImageToArray()
 
 void ScImage::convertToGray(void)
 {
-	int k;
 	int h = height();
 	int w = width();
-	QRgb *s, r;
 	for( int yi=0; yi < h; ++yi )
 	{
-		s = (QRgb*)(scanLine( yi ));
+		QRgb *s = (QRgb*)(scanLine( yi ));
 		for( int xi=0; xi < w; ++xi )
-		{
-			r = *s;
-			k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-			*s++ = qRgba(k, 0, 0, 0);
-		}
+			s[xi] = qRgba(grayValue(s[xi]), 0, 0, 0);
 	}
 }
 
 bool ScImage::writeRGBDataToFilter(ScStreamFilter* filter)
 {
-	QRgb r, *s;
 	QByteArray buffer;
 	bool success = true;
 	int  h = height();
@@ -1280,16 +1264,19 @@ bool ScImage::writeRGBDataToFilter(ScStreamFilter* filter)
 	buffer.resize(bufferSize + 16);
 	if (buffer.isNull()) // Memory allocation failure
 		return false;
+	unsigned char *data = (unsigned char*) buffer.data();
 	for( int yi=0; yi < h; ++yi )
 	{
-		s = (QRgb*)(scanLine( yi ));
-		for( int xi=0; xi < w; ++xi )
+		const QRgb *s = (const QRgb*)(constScanLine( yi ));
+		unsigned char *d = data + pending;
+		for( int xi=0; xi < w; ++xi, d += 3 )
 		{
-			r = *s++;
-			buffer[pending++] = static_cast<unsigned char>(qRed(r));
-			buffer[pending++] = static_cast<unsigned char>(qGreen(r));
-			buffer[pending++] = static_cast<unsigned char>(qBlue(r));
+			QRgb r = s[xi];
+			d[0] = qRed(r);
+			d[1] = qGreen(r);
+			d[2] = qBlue(r);
 		}
+		pending += scanLineSize;
 		if (pending >= bufferSize)
 		{
 			success &= filter->writeData(buffer.constData(), pending);
@@ -1303,40 +1290,32 @@ bool ScImage::writeRGBDataToFilter(ScStreamFilter* filter)
 
 bool ScImage::writeGrayDataToFilter(ScStreamFilter* filter, bool precal)
 {
-	QRgb r, *s;
 	QByteArray buffer;
 	bool success = true;
 	int  h = height();
 	int  w = width();
-	int  pending = 0, k;
+	int  pending = 0;
 	int  scanLineSize = w;
 	int  bufferSize   = qMax(scanLineSize, (65536 - 65536 % scanLineSize));
 	buffer.resize(bufferSize + 16);
 	if (buffer.isNull()) // Memory allocation failure
 		return false;
+	unsigned char *data = (unsigned char*) buffer.data();
 	for( int yi=0; yi < h; ++yi )
 	{
-		s = (QRgb*)(scanLine( yi ));
+		const QRgb *s = (const QRgb*)(constScanLine( yi ));
+		unsigned char *d = data + pending;
 		if (precal) // image data is already grayscale, no need for weighted conversion
 		{
 			for( int xi=0; xi < w; ++xi )
-			{
-				r = *s;
-				k = qRed(r);
-				buffer[pending++] = k;
-				s++;
-			}
+				d[xi] = qRed(s[xi]);
 		}
 		else
 		{
 			for( int xi=0; xi < w; ++xi )
-			{
-				r = *s;
-				k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-				buffer[pending++] = k;
-				s++;
-			}
+				d[xi] = grayValue(s[xi]);
 		}
+		pending += scanLineSize;
 		if (pending >= bufferSize)
 		{
 			success &= filter->writeData(buffer.constData(), pending);
@@ -1395,7 +1374,6 @@ bool ScImage::writeMonochromeDataToFilter(ScStreamFilter* filter, bool fromCmyk)
 
 bool ScImage::writeCMYKDataToFilter(ScStreamFilter* filter)
 {
-	QRgb r, *s;
 	QByteArray buffer;
 	bool success = true;
 	int  h = height();
@@ -1406,17 +1384,20 @@ bool ScImage::writeCMYKDataToFilter(ScStreamFilter* filter)
 	buffer.resize(bufferSize + 16);
 	if (buffer.isNull()) // Memory allocation failure
 		return false;
+	unsigned char *data = (unsigned char*) buffer.data();
 	for( int yi=0; yi < h; ++yi )
 	{
-		s = (QRgb*)(scanLine( yi ));
-		for( int xi=0; xi < w; ++xi )
+		const QRgb *s = (const QRgb*)(constScanLine( yi ));
+		unsigned char *d = data + pending;
+		for( int xi=0; xi < w; ++xi, d += 4 )
 		{
-			r = *s++;
-			buffer[pending++] = static_cast<unsigned char> (qRed(r));
-			buffer[pending++] = static_cast<unsigned char> (qGreen(r));
-			buffer[pending++] = static_cast<unsigned char> (qBlue(r));
-			buffer[pending++] = static_cast<unsigned char> (qAlpha(r));
+			QRgb r = s[xi];
+			d[0] = qRed(r);
+			d[1] = qGreen(r);
+			d[2] = qBlue(r);
+			d[3] = qAlpha(r);
 		}
+		pending += scanLineSize;
 		if (pending >= bufferSize)
 		{
 			success &= filter->writeData(buffer.constData(), pending);
@@ -0,0 +1,256 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "scimagebandwriter.h"
+
+#include <QByteArray>
+#include <QFile>
+
+#include <tiffio.h>
+#include <zlib.h>
+
+namespace
+{
+
+/* PNG written with zlib directly, rows use the Sub filter */
+class PngBandWriter : public ScImageBandWriter
+{
+public:
+	PngBandWriter() : m_width(0), m_height(0), m_rows(0), m_zInit(false), m_ok(false) {}
+	~PngBandWriter()
+	{
+		if (m_zInit)
+			deflateEnd(&m_zs);
+	}
+
+	bool open(const QString& fileName, int width, int height, int dpi, int quality)
+	{
+		m_width = width;
+		m_height = height;
+		m_rows = 0;
+		m_file.setFileName(fileName);
+		m_ok = (width > 0) && (height > 0) && m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+		if (!m_ok)
+			return false;
+
+		m_zs.zalloc = Z_NULL;
+		m_zs.zfree = Z_NULL;
+		m_zs.opaque = Z_NULL;
+		// same mapping of quality to compression level as Qt's PNG writer
+		int level = (quality < 0) ? Z_DEFAULT_COMPRESSION : qBound(0, (100 - quality) * 9 / 91, 9);
+		m_zInit = (deflateInit(&m_zs, level) == Z_OK);
+		m_ok = m_zInit;
+
+		m_file.write("\x89PNG\r\n\x1a\n", 8);
+		QByteArray ihdr;
+		appendUInt(ihdr, width);
+		appendUInt(ihdr, height);
+		ihdr.append(char(8));  // bit depth
+		ihdr.append(char(6));  // RGBA
+		ihdr.append(char(0));  // deflate
+		ihdr.append(char(0));  // adaptive filtering
+		ihdr.append(char(0));  // no interlace
+		writeChunk("IHDR", ihdr);
+		QByteArray phys;
+		quint32 dpm = qRound(100.0 / 2.54 * dpi);
+		appendUInt(phys, dpm);
+		appendUInt(phys, dpm);
+		phys.append(char(1));  // per meter
+		writeChunk("pHYs", phys);
+		m_row.resize(1 + width * 4);
+		return m_ok;
+	}
+
+	bool writeBand(const QImage& band)
+	{
+		if (!m_ok || band.width() != m_width || m_rows + band.height() > m_height)
+			return m_ok = false;
+		QImage rgba = band.convertToFormat(QImage::Format_RGBA8888);
+		uchar* out = reinterpret_cast<uchar*>(m_row.data());
+		for (int y = 0; y < rgba.height() && m_ok; ++y)
+		{
+			const uchar* src = rgba.constScanLine(y);
+			out[0] = 1;
+			for (int i = 0; i < 4; ++i)
+				out[1 + i] = src[i];
+			for (int i = 4; i < m_width * 4; ++i)
+				out[1 + i] = src[i] - src[i - 4];
+			deflateData(out, m_row.size(), Z_NO_FLUSH);
+		}
+		m_rows += rgba.height();
+		return m_ok;
+	}
+
+	bool close()
+	{
+		if (m_ok && m_rows == m_height)
+		{
+			deflateData(NULL, 0, Z_FINISH);
+			if (!m_idat.isEmpty())
+				writeChunk("IDAT", m_idat);
+			writeChunk("IEND", QByteArray());
+		}
+		else
+			m_ok = false;
+		if (m_zInit)
+			deflateEnd(&m_zs);
+		m_zInit = false;
+		m_file.close();
+		if (!m_ok)
+			m_file.remove();
+		return m_ok;
+	}
+
+private:
+	static void appendUInt(QByteArray& data, quint32 value)
+	{
+		data.append(char(value >> 24));
+		data.append(char(value >> 16));
+		data.append(char(value >> 8));
+		data.append(char(value));
+	}
+
+	void writeChunk(const char* type, const QByteArray& data)
+	{
+		QByteArray chunk;
+		appendUInt(chunk, data.size());
+		chunk.append(type, 4);
+		chunk.append(data);
+		uLong crc = crc32(0L, Z_NULL, 0);
+		crc = crc32(crc, reinterpret_cast<const Bytef*>(chunk.constData() + 4), chunk.size() - 4);
+		appendUInt(chunk, crc);
+		if (m_file.write(chunk) != chunk.size())
+			m_ok = false;
+	}
+
+	void deflateData(const uchar* data, int len, int flush)
+	{
+		const int chunkSize = 65536;
+		m_zs.next_in = const_cast<Bytef*>(data);
+		m_zs.avail_in = len;
+		int ret;
+		do
+		{
+			int used = m_idat.size();
+			m_idat.resize(chunkSize);
+			m_zs.next_out = reinterpret_cast<Bytef*>(m_idat.data() + used);
+			m_zs.avail_out = chunkSize - used;
+			ret = deflate(&m_zs, flush);
+			m_idat.resize(chunkSize - m_zs.avail_out);
+			if (ret == Z_STREAM_ERROR)
+			{
+				m_ok = false;
+				return;
+			}
+			if (m_idat.size() == chunkSize)
+			{
+				writeChunk("IDAT", m_idat);
+				m_idat.clear();
+			}
+		}
+		while (m_zs.avail_in > 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+	}
+
+	QFile m_file;
+	z_stream m_zs;
+	QByteArray m_idat;
+	QByteArray m_row;
+	int m_width;
+	int m_height;
+	int m_rows;
+	bool m_zInit;
+	bool m_ok;
+};
+
+class TiffBandWriter : public ScImageBandWriter
+{
+public:
+	TiffBandWriter() : m_tif(NULL), m_width(0), m_height(0), m_rows(0), m_ok(false) {}
+	~TiffBandWriter()
+	{
+		if (m_tif)
+			TIFFClose(m_tif);
+	}
+
+	bool open(const QString& fileName, int width, int height, int dpi, int /*quality*/)
+	{
+		m_fileName = fileName;
+		m_width = width;
+		m_height = height;
+		m_rows = 0;
+		m_tif = ((width > 0) && (height > 0)) ? TIFFOpen(fileName.toLocal8Bit().data(), "w") : NULL;
+		m_ok = (m_tif != NULL);
+		if (!m_ok)
+			return false;
+		uint16 extra = EXTRASAMPLE_UNASSALPHA;
+		TIFFSetField(m_tif, TIFFTAG_IMAGEWIDTH, width);
+		TIFFSetField(m_tif, TIFFTAG_IMAGELENGTH, height);
+		TIFFSetField(m_tif, TIFFTAG_BITSPERSAMPLE, 8);
+		TIFFSetField(m_tif, TIFFTAG_SAMPLESPERPIXEL, 4);
+		TIFFSetField(m_tif, TIFFTAG_EXTRASAMPLES, 1, &extra);
+		TIFFSetField(m_tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+		TIFFSetField(m_tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+		TIFFSetField(m_tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+		TIFFSetField(m_tif, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(m_tif, 0));
+		TIFFSetField(m_tif, TIFFTAG_XRESOLUTION, static_cast<float>(dpi));
+		TIFFSetField(m_tif, TIFFTAG_YRESOLUTION, static_cast<float>(dpi));
+		TIFFSetField(m_tif, TIFFTAG_RESOLUTIONUNIT, RESUNIT_INCH);
+		return true;
+	}
+
+	bool writeBand(const QImage& band)
+	{
+		if (!m_ok || band.width() != m_width || m_rows + band.height() > m_height)
+			return m_ok = false;
+		QImage rgba = band.convertToFormat(QImage::Format_RGBA8888);
+		for (int y = 0; y < rgba.height() && m_ok; ++y)
+		{
+			if (TIFFWriteScanline(m_tif, rgba.scanLine(y), m_rows + y) < 0)
+				m_ok = false;
+		}
+		m_rows += rgba.height();
+		return m_ok;
+	}
+
+	bool close()
+	{
+		if (m_rows != m_height)
+			m_ok = false;
+		if (m_tif)
+			TIFFClose(m_tif);
+		m_tif = NULL;
+		if (!m_ok)
+			QFile::remove(m_fileName);
+		return m_ok;
+	}
+
+private:
+	TIFF* m_tif;
+	QString m_fileName;
+	int m_width;
+	int m_height;
+	int m_rows;
+	bool m_ok;
+};
+
+}
+
+ScImageBandWriter* ScImageBandWriter::create(const QString& format)
+{
+	QString fmt = format.toLower();
+	if (fmt == "png")
+		return new PngBandWriter();
+	if (fmt == "tif" || fmt == "tiff")
+		return new TiffBandWriter();
+	return NULL;
+}
+
+bool ScImageBandWriter::canWrite(const QString& format)
+{
+	QString fmt = format.toLower();
+	return (fmt == "png" || fmt == "tif" || fmt == "tiff");
+}
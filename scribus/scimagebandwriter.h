@@ -0,0 +1,42 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCIMAGEBANDWRITER_H
+#define SCIMAGEBANDWRITER_H
+
+#include <QImage>
+#include <QString>
+
+#include "scribusapi.h"
+
+/*! \brief Writes an image file from horizontal bands, top to bottom.
+
+Used for bitmap exports too large to be held in one QImage: the page is
+rendered band by band and each band is encoded and written before the next
+one is rendered, so memory use depends on the band size only.
+
+Only formats with a scanline based writer are supported, see create().
+*/
+class SCRIBUS_API ScImageBandWriter
+{
+public:
+	virtual ~ScImageBandWriter() {}
+
+	/// Returns a writer for format ("png", "tif" or "tiff"), or NULL if the format can't be streamed.
+	static ScImageBandWriter* create(const QString& format);
+	/// Returns true if create() supports format
+	static bool canWrite(const QString& format);
+
+	/// Starts fileName with width x height pixels; quality as in QImage::save().
+	virtual bool open(const QString& fileName, int width, int height, int dpi, int quality = -1) = 0;
+	/// Appends the rows of band, which must be as wide as the image.
+	virtual bool writeBand(const QImage& band) = 0;
+	/// Completes the file, returns false if anything failed since open().
+	virtual bool close() = 0;
+};
+
+#endif
@@ -0,0 +1,86 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "scimagefilewriter.h"
+
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+
+class ScImageFileWriterTask : public QRunnable
+{
+public:
+	ScImageFileWriterTask(ScImageFileWriter* writer, const QImage& image, const QString& fileName, const QByteArray& format, int quality) :
+		m_writer(writer),
+		m_image(image),
+		m_fileName(fileName),
+		m_format(format),
+		m_quality(quality)
+	{
+	}
+
+	void run()
+	{
+		bool saved = m_image.save(m_fileName, m_format.constData(), m_quality);
+		// release the image before the next page may be queued
+		m_image = QImage();
+		m_writer->finished(m_fileName, saved);
+	}
+
+private:
+	ScImageFileWriter* m_writer;
+	QImage     m_image;
+	QString    m_fileName;
+	QByteArray m_format;
+	int        m_quality;
+};
+
+ScImageFileWriter::ScImageFileWriter(int maxPending) :
+	m_pending(0),
+	m_maxPending(maxPending)
+{
+	if (m_maxPending <= 0)
+		m_maxPending = qMax(1, QThread::idealThreadCount());
+	m_pool.setMaxThreadCount(m_maxPending);
+}
+
+ScImageFileWriter::~ScImageFileWriter()
+{
+	waitForDone();
+}
+
+void ScImageFileWriter::save(const QImage& image, const QString& fileName, const QByteArray& format, int quality)
+{
+	QMutexLocker locker(&m_mutex);
+	while (m_pending >= m_maxPending)
+		m_done.wait(&m_mutex);
+	++m_pending;
+	locker.unlock();
+	m_pool.start(new ScImageFileWriterTask(this, image, fileName, format, quality));
+}
+
+bool ScImageFileWriter::waitForDone()
+{
+	m_pool.waitForDone();
+	QMutexLocker locker(&m_mutex);
+	return m_failed.isEmpty();
+}
+
+QStringList ScImageFileWriter::failedFiles() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_failed;
+}
+
+void ScImageFileWriter::finished(const QString& fileName, bool saved)
+{
+	QMutexLocker locker(&m_mutex);
+	if (!saved)
+		m_failed.append(fileName);
+	--m_pending;
+	m_done.wakeAll();
+}
@@ -0,0 +1,58 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCIMAGEFILEWRITER_H
+#define SCIMAGEFILEWRITER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include "scribusapi.h"
+
+/*! \brief Encodes and saves rendered images on a pool of worker threads.
+
+Page rendering needs the document and its view, so it stays on the GUI
+thread, but PNG and JPEG compression of the result does not. Exporters queue
+each rendered page with save() and go on rendering the next one while the
+previous pages are encoded on other cores.
+
+save() blocks while maxPending images are already waiting, so a long export
+holds only a few page images in memory at a time.
+*/
+class SCRIBUS_API ScImageFileWriter
+{
+public:
+	/// maxPending 0 uses the number of cores
+	explicit ScImageFileWriter(int maxPending = 0);
+	/// Waits for all queued images.
+	~ScImageFileWriter();
+
+	/// Queues image to be saved as fileName, see QImage::save() for format and quality.
+	void save(const QImage& image, const QString& fileName, const QByteArray& format, int quality = -1);
+	/// Waits for all queued images, returns true if all of them were saved.
+	bool waitForDone();
+	/// Files which could not be written so far
+	QStringList failedFiles() const;
+
+private:
+	friend class ScImageFileWriterTask;
+	void finished(const QString& fileName, bool saved);
+
+	QThreadPool    m_pool;
+	mutable QMutex m_mutex;
+	QWaitCondition m_done;
+	int            m_pending;
+	int            m_maxPending;
+	QStringList    m_failed;
+};
+
+#endif
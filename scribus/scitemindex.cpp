@@ -0,0 +1,191 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "scitemindex.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "pageitem.h"
+
+namespace
+{
+	// Grid cell size in points, a bit more than a third of an A4 page
+	const double CellSize = 256.0;
+	// Items covering more cells are kept in a separate list
+	const int MaxCellsPerItem = 64;
+	// Limits cell coordinates for items far out on the pasteboard
+	const double MaxCell = 1000000.0;
+}
+
+ScItemIndex::ScItemIndex() : m_valid(false)
+{
+}
+
+void ScItemIndex::clear()
+{
+	m_valid = false;
+	m_items.clear();
+	m_bounds.clear();
+	m_cellRanges.clear();
+	m_positions.clear();
+	m_cells.clear();
+	m_large.clear();
+	m_changed.clear();
+}
+
+void ScItemIndex::itemChanged(PageItem* item)
+{
+	if (m_valid)
+		m_changed.insert(item);
+}
+
+quint64 ScItemIndex::cellKey(int x, int y)
+{
+	return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y);
+}
+
+QRect ScItemIndex::cellRange(const QRectF& area) const
+{
+	int x1 = static_cast<int>(qBound(-MaxCell, floor(area.left() / CellSize), MaxCell));
+	int y1 = static_cast<int>(qBound(-MaxCell, floor(area.top() / CellSize), MaxCell));
+	int x2 = static_cast<int>(qBound(-MaxCell, floor(area.right() / CellSize), MaxCell));
+	int y2 = static_cast<int>(qBound(-MaxCell, floor(area.bottom() / CellSize), MaxCell));
+	return QRect(QPoint(x1, y1), QPoint(x2, y2));
+}
+
+QRectF ScItemIndex::itemBounds(PageItem* item)
+{
+	// The visual bounds add the stroke, the margin covers clip paths of
+	// lines which extend half the line width beyond the frame
+	QRectF bounds = item->getBoundingRect() | item->getVisualBoundingRect();
+	double margin = qMax(1.0, item->lineWidth() / 2.0) + 1.0;
+	return bounds.adjusted(-margin, -margin, margin, margin);
+}
+
+void ScItemIndex::insertPosition(int position)
+{
+	QRect range = cellRange(m_bounds[position]);
+	if (static_cast<qint64>(range.width()) * range.height() > MaxCellsPerItem)
+	{
+		m_cellRanges[position] = QRect();
+		m_large.append(position);
+		return;
+	}
+	m_cellRanges[position] = range;
+	for (int y = range.top(); y <= range.bottom(); ++y)
+	{
+		for (int x = range.left(); x <= range.right(); ++x)
+			m_cells[cellKey(x, y)].append(position);
+	}
+}
+
+void ScItemIndex::removePosition(int position)
+{
+	QRect range = m_cellRanges[position];
+	if (range.isNull())
+	{
+		int i = m_large.indexOf(position);
+		if (i >= 0)
+			m_large.remove(i);
+		return;
+	}
+	for (int y = range.top(); y <= range.bottom(); ++y)
+	{
+		for (int x = range.left(); x <= range.right(); ++x)
+		{
+			QHash<quint64, QVector<int> >::Iterator cell = m_cells.find(cellKey(x, y));
+			if (cell == m_cells.end())
+				continue;
+			int i = cell->indexOf(position);
+			if (i >= 0)
+				cell->remove(i);
+			if (cell->isEmpty())
+				m_cells.erase(cell);
+		}
+	}
+}
+
+void ScItemIndex::rebuild(const QList<PageItem*>& items)
+{
+	clear();
+	m_items = items;
+	int count = m_items.count();
+	m_bounds.resize(count);
+	m_cellRanges.resize(count);
+	m_positions.reserve(count);
+	for (int i = 0; i < count; ++i)
+	{
+		PageItem* item = m_items.at(i);
+		m_positions.insert(item, i);
+		m_bounds[i] = itemBounds(item);
+		insertPosition(i);
+	}
+	m_valid = true;
+}
+
+void ScItemIndex::update(const QList<PageItem*>& items)
+{
+	// Comparing with the shallow copy is constant time while the list is untouched
+	if (!m_valid || !(m_items == items))
+	{
+		rebuild(items);
+		return;
+	}
+	m_items = items;
+	QSet<PageItem*>::ConstIterator it;
+	for (it = m_changed.constBegin(); it != m_changed.constEnd(); ++it)
+	{
+		int position = m_positions.value(*it, -1);
+		if (position < 0)
+			continue;
+		QRectF bounds = itemBounds(*it);
+		if (bounds == m_bounds[position])
+			continue;
+		removePosition(position);
+		m_bounds[position] = bounds;
+		insertPosition(position);
+	}
+	m_changed.clear();
+}
+
+QVector<int> ScItemIndex::itemsInArea(const QList<PageItem*>& items, const QRectF& area)
+{
+	update(items);
+	QVector<int> result;
+	QRect range = cellRange(area);
+	if (static_cast<qint64>(range.width()) * range.height() >= m_bounds.count())
+	{
+		// zoomed out far enough that looking at every item is cheaper
+		for (int i = 0; i < m_bounds.count(); ++i)
+		{
+			if (m_bounds[i].intersects(area))
+				result.append(i);
+		}
+		return result;
+	}
+	for (int y = range.top(); y <= range.bottom(); ++y)
+	{
+		for (int x = range.left(); x <= range.right(); ++x)
+		{
+			QHash<quint64, QVector<int> >::ConstIterator cell = m_cells.constFind(cellKey(x, y));
+			if (cell != m_cells.constEnd())
+				result += *cell;
+		}
+	}
+	result += m_large;
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	int kept = 0;
+	for (int i = 0; i < result.count(); ++i)
+	{
+		if (m_bounds[result[i]].intersects(area))
+			result[kept++] = result[i];
+	}
+	result.resize(kept);
+	return result;
+}
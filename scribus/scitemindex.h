@@ -0,0 +1,69 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef SCITEMINDEX_H
+#define SCITEMINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QRect>
+#include <QRectF>
+#include <QSet>
+#include <QVector>
+
+#include "scribusapi.h"
+
+class PageItem;
+
+/*! \brief Uniform grid over the bounding boxes of a list of page items.
+
+Used by the canvas to find the items of a large document that may be
+hit by the mouse or need to be redrawn without testing every item.
+
+The index keeps a shallow copy of the item list it was built from. Any
+change of the list detaches the document's copy, so insertions, removals
+and reordering are detected in constant time and cause a rebuild on the
+next query. Geometry changes are reported by PageItem through
+ScribusDoc::itemGeometryChanged() and only update the changed items.
+
+Results are positions in the item list in ascending (stacking) order.
+They are conservative: callers still do their exact tests.
+*/
+class SCRIBUS_API ScItemIndex
+{
+public:
+	ScItemIndex();
+
+	/// Positions of the items in items whose bounds may intersect area.
+	QVector<int> itemsInArea(const QList<PageItem*>& items, const QRectF& area);
+	/// Marks the bounds of item as outdated.
+	void itemChanged(PageItem* item);
+	/// Drops the index, it is rebuilt by the next query.
+	void clear();
+
+private:
+	void rebuild(const QList<PageItem*>& items);
+	void update(const QList<PageItem*>& items);
+	void insertPosition(int position);
+	void removePosition(int position);
+	QRect cellRange(const QRectF& area) const;
+	static quint64 cellKey(int x, int y);
+	static QRectF itemBounds(PageItem* item);
+
+	bool m_valid;
+	QList<PageItem*> m_items;
+	QVector<QRectF> m_bounds;
+	/// cells covered by each position, null for items stored in m_large
+	QVector<QRect> m_cellRanges;
+	QHash<PageItem*, int> m_positions;
+	QHash<quint64, QVector<int> > m_cells;
+	/// items covering too many cells to be stored in each of them
+	QVector<int> m_large;
+	QSet<PageItem*> m_changed;
+};
+
+#endif
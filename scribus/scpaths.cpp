@@ -517,6 +517,11 @@ QString ScPaths::getImageCacheDir(void)
 	return getApplicationDataDir() + "cache/img/";
 }
 
+QString ScPaths::getGlyphCacheDir(void)
+{
+	return getApplicationDataDir() + "cache/glyphs/";
+}
+
 QString ScPaths::getPluginDataDir(void)
 {
 	return getApplicationDataDir() + "plugins/";
@@ -82,6 +82,8 @@ public:
 	static QString getUserPaletteFilesDir(bool createIfNotExists);
 	/** @brief Return path to image cache dir*/
 	static QString getImageCacheDir(void);
+	/** @brief Return path to glyph cache dir*/
+	static QString getGlyphCacheDir(void);
 	/** @brief Return path to plugin data dir*/
 	static QString getPluginDataDir(void);
 	/** @brief Return path to user documents*/
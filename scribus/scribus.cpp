@@ -7886,7 +7886,7 @@ void ScribusMainWindow::StatusPic()
 	delete dia;
 }
 
-QString ScribusMainWindow::CFileDialog(QString workingDirectory, QString dialogCaption, QString fileFilter, QString defaultFilename, int optionFlags, bool *useCompression, bool *useFonts, bool *useProfiles)
+QString ScribusMainWindow::CFileDialog(QString workingDirectory, QString dialogCaption, QString fileFilter, QString defaultFilename, int optionFlags, bool *useCompression, bool *useFonts, bool *useProfiles, bool *useZipArchive)
 {
 	// changed from "this" to qApp->activeWindow() to be sure it will be opened
 	// with the current active window as parent. E.g. it won't hide StoryEditor etc. -- PV
@@ -7908,6 +7908,8 @@ QString ScribusMainWindow::CFileDialog(QString workingDirectory, QString dialogC
 			dia->WithFonts->setChecked(*useFonts);
 		if (useProfiles != NULL)
 			dia->WithProfiles->setChecked(*useProfiles);
+		if (useZipArchive != NULL)
+			dia->WithZipArchive->setChecked(*useZipArchive);
 	}
 	QString retval("");
 	if (dia->exec() == QDialog::Accepted)
@@ -7930,6 +7932,8 @@ QString ScribusMainWindow::CFileDialog(QString workingDirectory, QString dialogC
 				*useFonts = dia->WithFonts->isChecked();
 			if (useProfiles != NULL)
 				*useProfiles = dia->WithProfiles->isChecked();
+			if (useZipArchive != NULL)
+				*useZipArchive = dia->WithZipArchive->isChecked();
 		}
 		this->repaint();
 		retval = dia->selectedFile();
@@ -84,6 +84,7 @@ for which a new license (GPL+exception) is in place.
 #include "resourcecollection.h"
 #include "scclocale.h"
 #include "sccolorengine.h"
+#include "scfilewriter.h"
 #include "sclimits.h"
 #include "scpage.h"
 #include "scpainter.h"
@@ -171,6 +172,7 @@ public:
 	
 	void changed(PageItem* it, bool doLayout)
 	{
+		doc->checkerCache().itemChanged(it);
 		it->invalidateLayout();
 		if (doLayout)
 			it->layout();
@@ -279,6 +281,7 @@ ScribusDoc::ScribusDoc() : UndoObject( tr("Document")), Observable<ScribusDoc>(N
 	m_currentPage(NULL),
 	m_updateManager(),
 	m_docUpdater(NULL),
+	m_autoSaveWriter(NULL),
 	m_flag_notesChanged(false),
 	flag_restartMarksRenumbering(false),
 	flag_updateMarksLabels(false),
@@ -396,6 +399,7 @@ ScribusDoc::ScribusDoc(const QString& docName, int unitindex, const PageSize& pa
 	m_currentPage(NULL),
 	m_updateManager(),
 	m_docUpdater(NULL),
+	m_autoSaveWriter(NULL),
 	m_flag_notesChanged(false),
 	flag_restartMarksRenumbering(false),
 	flag_updateMarksLabels(false),
@@ -612,6 +616,12 @@ void ScribusDoc::init()
 ScribusDoc::~ScribusDoc()
 {
 	m_guardedObject.nullify();
+	if (m_autoSaveWriter)
+	{
+		m_autoSaveWriter->wait();
+		if (m_autoSaveWriter->succeeded())
+			autoSaveFiles.append(m_autoSaveWriter->fileName());
+	}
 	CloseCMSProfiles();
 	ScCore->fileWatcher->stop();
 	ScCore->fileWatcher->removeFile(DocName);
@@ -5644,6 +5654,20 @@ PageItem* ScribusDoc::getItemFromName(QString name)
 	return ret;
 }
 
+ScItemIndex& ScribusDoc::itemIndex(const QList<PageItem*>* items)
+{
+	if (items == &MasterItems)
+		return m_masterItemIndex;
+	return m_docItemIndex;
+}
+
+void ScribusDoc::itemGeometryChanged(PageItem* item)
+{
+	m_docItemIndex.itemChanged(item);
+	m_masterItemIndex.itemChanged(item);
+	m_checkerCache.itemChanged(item);
+}
+
 void ScribusDoc::rebuildItemLists()
 {
 	// #5826 Rebuild items list in case layer order as been changed
@@ -6005,6 +6029,8 @@ struct oldPageVar
 // without running this monster
 void ScribusDoc::reformPages(bool moveObjects)
 {
+	// page positions and item ownership change without notifying the items
+	m_checkerCache.clear();
 	QMap<uint, oldPageVar> pageTable;
 	struct oldPageVar oldPg;
 	int counter = pageSets()[m_docPrefsData.docSetupPrefs.pagePositioning].FirstPage;
@@ -13180,6 +13206,18 @@ void ScribusDoc::itemSelection_SwapRight()
 void ScribusDoc::changed()
 {
 	setModified(true);
+	// Most property setters don't notify their item, they act on the selection
+	for (int i = 0; i < m_Selection->count(); ++i)
+	{
+		PageItem* currItem = m_Selection->itemAt(i);
+		m_checkerCache.itemChanged(currItem);
+		if (currItem->isGroup())
+		{
+			QList<PageItem*> groupItems = currItem->getItemList();
+			for (int j = 0; j < groupItems.count(); ++j)
+				m_checkerCache.itemChanged(groupItems.at(j));
+		}
+	}
 	// Do not emit docChanged signal() unnecessarily
 	// Processing of that signal is slowwwwwww and
 	// DocUpdater will trigger it when necessary
@@ -16278,7 +16316,7 @@ void ScribusDoc::restartAutoSaveTimer()
 
 void ScribusDoc::slotAutoSave()
 {
-	if (isModified())
+	if (isModified() && !m_autoSaveWriter)
 	{
 		autoSaveTimer->stop();
 		QString base = tr("Document");
@@ -16294,23 +16332,45 @@ void ScribusDoc::slotAutoSave()
 		if ((!m_docPrefsData.docSetupPrefs.AutoSaveLocation) && (!m_docPrefsData.docSetupPrefs.AutoSaveDir.isEmpty()))
 			path = m_docPrefsData.docSetupPrefs.AutoSaveDir;
 		fileName = QDir::cleanPath(path + "/" + base + QString("_autosave_%1.sla").arg(dat.toString("dd_MM_yyyy_hh_mm")));
+		// Only serializing needs the document, the file is written in the background
 		FileLoader fl(fileName);
-		if (fl.saveFile(fileName, this, 0))
+		QByteArray data;
+		if (fl.saveToBuffer(fileName, this, data))
 		{
-			scMW()->statusBar()->showMessage( tr("File %1 autosaved").arg(base), 5000);
-			if (autoSaveFiles.count() >= m_docPrefsData.docSetupPrefs.AutoSaveCount)
-			{
-				QFile f(autoSaveFiles.first());
-				f.remove();
-				autoSaveFiles.removeFirst();
-			}
-			autoSaveFiles.append(fileName);
+			m_autoSaveWriter = new ScFileWriter(fileName, data, this);
+			m_autoSaveWriter->setPermissions(filePermissions());
+			connect(m_autoSaveWriter, SIGNAL(fileWritten(bool)), this, SLOT(autoSaveWritten(bool)));
+			m_autoSaveWriter->start();
+			return;
 		}
 		if (m_docPrefsData.docSetupPrefs.AutoSave)
 			autoSaveTimer->start(m_docPrefsData.docSetupPrefs.AutoSaveTime);
 	}
 }
 
+void ScribusDoc::autoSaveWritten(bool success)
+{
+	if (!m_autoSaveWriter)
+		return;
+	m_autoSaveWriter->wait();
+	if (success)
+	{
+		QString base = hasName ? QFileInfo(DocName).baseName() : tr("Document");
+		scMW()->statusBar()->showMessage( tr("File %1 autosaved").arg(base), 5000);
+		if (autoSaveFiles.count() >= m_docPrefsData.docSetupPrefs.AutoSaveCount)
+		{
+			QFile f(autoSaveFiles.first());
+			f.remove();
+			autoSaveFiles.removeFirst();
+		}
+		autoSaveFiles.append(m_autoSaveWriter->fileName());
+	}
+	m_autoSaveWriter->deleteLater();
+	m_autoSaveWriter = NULL;
+	if (m_docPrefsData.docSetupPrefs.AutoSave)
+		autoSaveTimer->start(m_docPrefsData.docSetupPrefs.AutoSaveTime);
+}
+
 void ScribusDoc::setupNumerations()
 {
 	QList<NumStruct*> numList = numerations.values();
@@ -16584,7 +16644,7 @@ void ScribusDoc::updateNumbers(bool updateNumerations)
 							if (mark && mark->getString() != prefixStr)
 							{
 								mark->setString(prefixStr);
-								item->invalid = true;
+								item->invalidateLayout();
 								flag_Renumber = true;
 							}
 						}
@@ -41,6 +41,7 @@ for which a new license (GPL+exception) is in place.
 #include "gtgettext.h" //CB For the ImportSetup struct and itemadduserframe
 #include "scribusapi.h"
 #include "colormgmt/sccolormgmtengine.h"
+#include "documentchecker.h"
 #include "documentinformation.h"
 #include "numeration.h"
 #include "marks.h"
@@ -54,6 +55,7 @@ for which a new license (GPL+exception) is in place.
 #include "pagestructs.h"
 #include "prefsstructs.h"
 #include "scguardedptr.h"
+#include "scitemindex.h"
 #include "scpage.h"
 #include "sclayer.h"
 #include "styles/styleset.h"
@@ -76,6 +78,7 @@ class ScribusView;
 class ScribusMainWindow;
 class ResourceCollection;
 class PageSize;
+class ScFileWriter;
 class ScPattern;
 class Serializer;
 class QProgressBar;
@@ -816,6 +819,18 @@ public:
 	uint getItemNrfromUniqueID(uint unique);
 	//return pointer to item
 	PageItem* getItemFromName(QString name);
+	/**
+	 * @brief Spatial index over DocItems or MasterItems, selected by the list passed
+	 */
+	ScItemIndex& itemIndex(const QList<PageItem*>* items);
+	/**
+	 * @brief Called by items whose position, size or outline changed
+	 */
+	void itemGeometryChanged(PageItem* item);
+	/**
+	 * @brief Item results of the last preflight check, see DocumentChecker
+	 */
+	DocumentCheckerCache& checkerCache() { return m_checkerCache; }
 	//itemDelete
 	//itemBlah...
 
@@ -1382,6 +1397,10 @@ private:
 	MassObservable<ScPage*> m_pagesChanged;
 	MassObservable<QRectF> m_regionsChanged;
 	DocUpdater* m_docUpdater;
+	ScFileWriter* m_autoSaveWriter; // writes the autosave file in the background
+	ScItemIndex m_docItemIndex;
+	ScItemIndex m_masterItemIndex;
+	DocumentCheckerCache m_checkerCache;
 	
 signals:
 	//Lets make our doc talk to our GUI rather than confusing all our normal stuff
@@ -1792,6 +1811,7 @@ public slots:
 
 protected slots:
 	void slotAutoSave();
+	void autoSaveWritten(bool success);
 
 //auto-numerations
 public:
@@ -96,6 +96,7 @@ for which a new license (GPL+exception) is in place.
 #include "prefsfile.h"
 #include "prefsmanager.h"
 #include "scclocale.h"
+#include "scimagebandwriter.h"
 #include "scmimedata.h"
 #include "scpage.h"
 #include "scpainter.h"
@@ -365,6 +366,7 @@ void ScribusView::changed(QRectF re, bool)
 		m_oldCanvasWidth = newCanvasWidth;
 		m_oldCanvasHeight = newCanvasHeight;
 	}
+	m_canvas->invalidateTiles(re);
 	if (!Doc->isLoading() && !m_ScMW->scriptIsRunning())
 	{
 // 		qDebug() << "ScribusView-changed(): changed region:" << re;
@@ -2713,37 +2715,52 @@ QImage ScribusView::MPageToPixmap(QString name, int maxGr, bool drawFrame)
 	return im;
 }
 
-QImage ScribusView::PageToPixmap(int Nr, int maxGr, bool drawFrame, bool drawBackground)
+/* Document and canvas settings changed while a page is rendered for export */
+struct ScribusView::PageRenderState
 {
-	QImage im;
-	double sx = maxGr / Doc->DocPages.at(Nr)->width();
-	double sy = maxGr / Doc->DocPages.at(Nr)->height();
-	double sc = qMin(sx, sy);
-	int clipx = static_cast<int>(Doc->DocPages.at(Nr)->xOffset() * sc);
-	int clipy = static_cast<int>(Doc->DocPages.at(Nr)->yOffset() * sc);
-	int clipw = qRound(Doc->DocPages.at(Nr)->width() * sc);
-	int cliph = qRound(Doc->DocPages.at(Nr)->height() * sc);
-	if ((clipw <=0) || (cliph <= 0))
-		return im;
-	im = QImage(clipw, cliph, QImage::Format_ARGB32_Premultiplied);
-	if (im.isNull())
-		return im;
-	im.fill( qRgba(0, 0, 0, 0) );
-	int oldAppMode = Doc->appMode;
+	int oldAppMode;
+	double oldScale;
+	double cx;
+	double cy;
+	bool oldFramesShown;
+	bool oldShowControls;
+	bool oldDrawAsPreview;
+	bool cmsCorr;
+	ScPage* act;
+	bool mMode;
+	QList<QPair<PageItem*, int> > changedList;
+};
+
+void ScribusView::reloadFullResImage(PageItem* currItem)
+{
+	int fho = currItem->imageFlippedH();
+	int fvo = currItem->imageFlippedV();
+	double imgX = currItem->imageXOffset();
+	double imgY = currItem->imageYOffset();
+	Doc->loadPict(currItem->Pfile, currItem, true);
+	currItem->setImageFlippedH(fho);
+	currItem->setImageFlippedV(fvo);
+	currItem->setImageXOffset(imgX);
+	currItem->setImageYOffset(imgY);
+}
+
+void ScribusView::beginPageRender(int Nr, double sc, PageRenderState& state)
+{
+	state.oldAppMode = Doc->appMode;
 	requestMode(modeNormal);
-	double oldScale = m_canvas->scale();
-	double cx = Doc->minCanvasCoordinate.x();
-	double cy = Doc->minCanvasCoordinate.y();
+	state.oldScale = m_canvas->scale();
+	state.cx = Doc->minCanvasCoordinate.x();
+	state.cy = Doc->minCanvasCoordinate.y();
 	Doc->minCanvasCoordinate = FPoint(0, 0);
-	bool oldFramesShown  = Doc->guidesPrefs().framesShown;
-	bool oldShowControls = Doc->guidesPrefs().showControls;
-	bool oldDrawAsPreview = Doc->drawAsPreview;
+	state.oldFramesShown  = Doc->guidesPrefs().framesShown;
+	state.oldShowControls = Doc->guidesPrefs().showControls;
+	state.oldDrawAsPreview = Doc->drawAsPreview;
 	Doc->guidesPrefs().framesShown = false;
 	Doc->guidesPrefs().showControls = false;
-	bool cmsCorr = false;
+	state.cmsCorr = false;
 	if ((Doc->cmsSettings().CMSinUse) && (Doc->cmsSettings().GamutCheck))
 	{
-		cmsCorr = true;
+		state.cmsCorr = true;
 		Doc->cmsSettings().GamutCheck = false;
 		Doc->enableCMS(true);
 	}
@@ -2751,26 +2768,12 @@ QImage ScribusView::PageToPixmap(int Nr, int maxGr, bool drawFrame, bool drawBac
 	m_canvas->setScale(sc);
 	m_canvas->setPreviewMode(true);
 	m_canvas->setForcedRedraw(true);
-	ScPage* act = Doc->currentPage();
-	bool mMode = Doc->masterPageMode();
+	state.act = Doc->currentPage();
+	state.mMode = Doc->masterPageMode();
 	Doc->setMasterPageMode(false);
 	Doc->setLoading(true);
 	Doc->setCurrentPage(Doc->DocPages.at(Nr));
-	ScPainter *painter = new ScPainter(&im, im.width(), im.height(), 1.0, 0);
-	if (drawBackground)
-		painter->clear(Doc->paperColor());
-	painter->translate(-clipx, -clipy);
-	painter->setFillMode(ScPainter::Solid);
-	if (drawFrame)
-	{
-		painter->setPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
-		painter->setBrush(Doc->paperColor());
-		painter->drawRect(clipx, clipy, clipw, cliph);
-	}
-	painter->beginLayer(1.0, 0);
-	painter->setZoomFactor(m_canvas->scale());
 
-	QList<QPair<PageItem*, int> > changedList;
 	ScPage* page = Doc->DocPages.at(Nr);
 	PageItem* currItem;
 	if (page->FromMaster.count() != 0)
@@ -2783,21 +2786,17 @@ QImage ScribusView::PageToPixmap(int Nr, int maxGr, bool drawFrame, bool drawBac
 				continue;
 			if (currItem->pixm.imgInfo.lowResType == 0)
 				continue;
-			changedList.append(qMakePair(currItem, currItem->pixm.imgInfo.lowResType));
+			state.changedList.append(qMakePair(currItem, currItem->pixm.imgInfo.lowResType));
 			currItem->pixm.imgInfo.lowResType = 0;
-			int fho = currItem->imageFlippedH();
-			int fvo = currItem->imageFlippedV();
-			double imgX = currItem->imageXOffset();
-			double imgY = currItem->imageYOffset();
-			Doc->loadPict(currItem->Pfile, currItem, true);
-			currItem->setImageFlippedH(fho);
-			currItem->setImageFlippedV(fvo);
-			currItem->setImageXOffset(imgX);
-			currItem->setImageYOffset(imgY);
+			reloadFullResImage(currItem);
 		}
 	}
 	if (Doc->Items->count() != 0)
 	{
+		int clipx = static_cast<int>(page->xOffset() * sc);
+		int clipy = static_cast<int>(page->yOffset() * sc);
+		int clipw = qRound(page->width() * sc);
+		int cliph = qRound(page->height() * sc);
 		FPoint orig = m_canvas->localToCanvas(QPoint(clipx, clipy));
 		QRectF cullingArea = QRectF(orig.x(), orig.y(), qRound(clipw / sc + 0.5), qRound(cliph / sc + 0.5));
 		for (int it = 0; it < Doc->Items->count(); ++it)
@@ -2809,72 +2808,138 @@ QImage ScribusView::PageToPixmap(int Nr, int maxGr, bool drawFrame, bool drawBac
 				continue;
 			if (currItem->pixm.imgInfo.lowResType == 0)
 				continue;
-			changedList.append(qMakePair(currItem, currItem->pixm.imgInfo.lowResType));
+			state.changedList.append(qMakePair(currItem, currItem->pixm.imgInfo.lowResType));
 			currItem->pixm.imgInfo.lowResType = 0;
-			int fho = currItem->imageFlippedH();
-			int fvo = currItem->imageFlippedV();
-			double imgX = currItem->imageXOffset();
-			double imgY = currItem->imageYOffset();
-			Doc->loadPict(currItem->Pfile, currItem, true);
-			currItem->setImageFlippedH(fho);
-			currItem->setImageFlippedV(fvo);
-			currItem->setImageXOffset(imgX);
-			currItem->setImageYOffset(imgY);
+			reloadFullResImage(currItem);
 		}
 	}
+}
 
+void ScribusView::drawPageForRender(ScPainter* painter, int Nr, const QRect& clip)
+{
 	ScLayer layer;
 	layer.isViewable = false;
 	int layerCount = Doc->layerCount();
 	for (int layerLevel = 0; layerLevel < layerCount; ++layerLevel)
 	{
 		Doc->Layers.levelToLayer(layer, layerLevel);
-		m_canvas->DrawMasterItems(painter, Doc->DocPages.at(Nr), layer, QRect(clipx, clipy, clipw, cliph));
-		m_canvas->DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph), false);
-		m_canvas->DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph), true);
+		m_canvas->DrawMasterItems(painter, Doc->DocPages.at(Nr), layer, clip);
+		m_canvas->DrawPageItems(painter, layer, clip, false);
+		m_canvas->DrawPageItems(painter, layer, clip, true);
 	}
-	painter->endLayer();
-	painter->end();
-	delete painter;
-	painter=NULL;
+}
 
-	if (changedList.count() != 0)
+void ScribusView::endPageRender(const PageRenderState& state)
+{
+	if (state.changedList.count() != 0)
 	{
 		QPair<PageItem*, int> itemPair;
-		for (int it = 0; it < changedList.count(); it++)
+		for (int it = 0; it < state.changedList.count(); it++)
 		{
-			itemPair = changedList.at(it);
-			currItem = itemPair.first;
+			itemPair = state.changedList.at(it);
+			PageItem* currItem = itemPair.first;
 			currItem->pixm.imgInfo.lowResType = itemPair.second;
-			int fho = currItem->imageFlippedH();
-			int fvo = currItem->imageFlippedV();
-			double imgX = currItem->imageXOffset();
-			double imgY = currItem->imageYOffset();
-			Doc->loadPict(currItem->Pfile, currItem, true);
-			currItem->setImageFlippedH(fho);
-			currItem->setImageFlippedV(fvo);
-			currItem->setImageXOffset(imgX);
-			currItem->setImageYOffset(imgY);
+			reloadFullResImage(currItem);
 		}
 	}
-	if (cmsCorr)
+	if (state.cmsCorr)
 	{
 		Doc->cmsSettings().GamutCheck = true;
 		Doc->enableCMS(true);
 	}
-	Doc->drawAsPreview = oldDrawAsPreview;
-	Doc->guidesPrefs().framesShown  = oldFramesShown;
-	Doc->guidesPrefs().showControls = oldShowControls;
-	m_canvas->setScale(oldScale);
-	Doc->setMasterPageMode(mMode);
-	Doc->setCurrentPage(act);
+	Doc->drawAsPreview = state.oldDrawAsPreview;
+	Doc->guidesPrefs().framesShown  = state.oldFramesShown;
+	Doc->guidesPrefs().showControls = state.oldShowControls;
+	m_canvas->setScale(state.oldScale);
+	Doc->setMasterPageMode(state.mMode);
+	Doc->setCurrentPage(state.act);
 	Doc->setLoading(false);
 	m_canvas->setPreviewMode(Doc->drawAsPreview);
 	m_canvas->setForcedRedraw(false);
-	Doc->minCanvasCoordinate = FPoint(cx, cy);
-	requestMode(oldAppMode);
+	Doc->minCanvasCoordinate = FPoint(state.cx, state.cy);
+	requestMode(state.oldAppMode);
+}
+
+QImage ScribusView::PageToPixmap(int Nr, int maxGr, bool drawFrame, bool drawBackground)
+{
+	QImage im;
+	double sx = maxGr / Doc->DocPages.at(Nr)->width();
+	double sy = maxGr / Doc->DocPages.at(Nr)->height();
+	double sc = qMin(sx, sy);
+	int clipx = static_cast<int>(Doc->DocPages.at(Nr)->xOffset() * sc);
+	int clipy = static_cast<int>(Doc->DocPages.at(Nr)->yOffset() * sc);
+	int clipw = qRound(Doc->DocPages.at(Nr)->width() * sc);
+	int cliph = qRound(Doc->DocPages.at(Nr)->height() * sc);
+	if ((clipw <=0) || (cliph <= 0))
+		return im;
+	im = QImage(clipw, cliph, QImage::Format_ARGB32_Premultiplied);
+	if (im.isNull())
+		return im;
+	im.fill( qRgba(0, 0, 0, 0) );
+	PageRenderState state;
+	beginPageRender(Nr, sc, state);
+	ScPainter *painter = new ScPainter(&im, im.width(), im.height(), 1.0, 0);
+	if (drawBackground)
+		painter->clear(Doc->paperColor());
+	painter->translate(-clipx, -clipy);
+	painter->setFillMode(ScPainter::Solid);
+	if (drawFrame)
+	{
+		painter->setPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
+		painter->setBrush(Doc->paperColor());
+		painter->drawRect(clipx, clipy, clipw, cliph);
+	}
+	painter->beginLayer(1.0, 0);
+	painter->setZoomFactor(m_canvas->scale());
+	drawPageForRender(painter, Nr, QRect(clipx, clipy, clipw, cliph));
+	painter->endLayer();
+	painter->end();
+	delete painter;
+	painter=NULL;
+	endPageRender(state);
 	return im;
 }
+
+bool ScribusView::PageToBands(int Nr, int maxGr, int bandHeight, bool drawBackground, ScImageBandWriter* writer)
+{
+	double sx = maxGr / Doc->DocPages.at(Nr)->width();
+	double sy = maxGr / Doc->DocPages.at(Nr)->height();
+	double sc = qMin(sx, sy);
+	int clipx = static_cast<int>(Doc->DocPages.at(Nr)->xOffset() * sc);
+	int clipy = static_cast<int>(Doc->DocPages.at(Nr)->yOffset() * sc);
+	int clipw = qRound(Doc->DocPages.at(Nr)->width() * sc);
+	int cliph = qRound(Doc->DocPages.at(Nr)->height() * sc);
+	if ((clipw <=0) || (cliph <= 0) || (bandHeight <= 0))
+		return false;
+	bool ok = true;
+	PageRenderState state;
+	beginPageRender(Nr, sc, state);
+	for (int y = 0; (y < cliph) && ok; y += bandHeight)
+	{
+		int h = qMin(bandHeight, cliph - y);
+		QImage band(clipw, h, QImage::Format_ARGB32_Premultiplied);
+		if (band.isNull())
+		{
+			ok = false;
+			break;
+		}
+		band.fill( qRgba(0, 0, 0, 0) );
+		ScPainter *painter = new ScPainter(&band, band.width(), band.height(), 1.0, 0);
+		if (drawBackground)
+			painter->clear(Doc->paperColor());
+		painter->translate(-clipx, -(clipy + y));
+		painter->setFillMode(ScPainter::Solid);
+		painter->beginLayer(1.0, 0);
+		painter->setZoomFactor(m_canvas->scale());
+		drawPageForRender(painter, Nr, QRect(clipx, clipy + y, clipw, h));
+		painter->endLayer();
+		painter->end();
+		delete painter;
+		ok = writer->writeBand(band);
+	}
+	endPageRender(state);
+	return ok;
+}
 #if 0
 void ScribusView::rulerMove(QMouseEvent *m)
 {
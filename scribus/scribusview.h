@@ -69,6 +69,8 @@ class Hruler;
 class Vruler;
 class ScPage;
 class RulerMover;
+class ScImageBandWriter;
+class ScPainter;
 class PageItem;
 class PageSelector;
 class ScribusDoc;
@@ -162,6 +164,12 @@ public:
 	void showInlinePage(int id);
 	void hideInlinePage();
 	QImage PageToPixmap(int Nr, int maxGr, bool drawFrame = true, bool drawBackground = true);
+	/**
+	 * Renders page Nr like PageToPixmap() in horizontal bands of bandHeight rows,
+	 * passing each band to writer before rendering the next one, for images too
+	 * large to be held in memory at once. The writer must already be open.
+	 */
+	bool PageToBands(int Nr, int maxGr, int bandHeight, bool drawBackground, ScImageBandWriter* writer);
 	QImage MPageToPixmap(QString name, int maxGr, bool drawFrame = true);
 	void RecalcPicturesRes();
 	/**
@@ -259,6 +267,13 @@ public slots: // Public slots
 private:
 	PageItem * firstFrame;
 
+private:
+	struct PageRenderState;
+	void beginPageRender(int Nr, double sc, PageRenderState& state);
+	void drawPageForRender(ScPainter* painter, int Nr, const QRect& clip);
+	void endPageRender(const PageRenderState& state);
+	void reloadFullResImage(PageItem* currItem);
+
 private: // Private attributes
 	int m_previousMode;
 	QMenu *pmen3;
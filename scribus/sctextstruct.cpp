@@ -24,7 +24,7 @@ qreal GlyphRun::width() const
 	return width;
 }
 
-ScText::~ScText() 
+ScTextRun::~ScTextRun() 
 {
 	if (parstyle)
 		delete parstyle;
@@ -32,46 +32,26 @@ ScText::~ScText()
 	mark = NULL;
 }
 
-bool ScText::hasObject(ScribusDoc *doc) const
+bool ScTextRun::hasObject(ScribusDoc *doc) const
 {
-	if (this->ch == SpecialChars::OBJECT)
-		return ((embedded > 0) && (doc->FrameItems.contains(embedded)));
-	return false;
+	return ((embedded > 0) && (doc->FrameItems.contains(embedded)));
 }
 
-bool ScText::hasMark(Mark* MRK) const
+bool ScTextRun::hasMark(Mark* MRK) const
 {
-	if (this->ch == SpecialChars::OBJECT)
-	{
-		if (MRK == NULL)
-			return mark != NULL;
-		else
-			return mark == MRK;
-	}
-	return false;
-}
-
-QList<PageItem*> ScText::getGroupedItems(ScribusDoc *doc)
-{
-	QList<PageItem*> result;
-	if ((embedded > 0) && (doc->FrameItems.contains(embedded)))
-	{
-		PageItem* dItem = doc->FrameItems[embedded];
-		result.append(dItem);
-		if (dItem->isGroup())
-			result = dItem->getItemList();
-	}
-	return result;
+	if (MRK == NULL)
+		return mark != NULL;
+	return mark == MRK;
 }
 
-PageItem* ScText::getItem(ScribusDoc *doc)
+PageItem* ScTextRun::getItem(ScribusDoc *doc)
 {
 	if ((embedded > 0) && (doc->FrameItems.contains(embedded)))
 		return doc->FrameItems[embedded];
 	return NULL;
 }
 
-void ScText::setNewMark(Mark *mrk)
+void ScTextRun::setNewMark(Mark *mrk)
 {
 	if (!mrk->isUnique())
 		mark = mrk;
@@ -101,38 +101,44 @@ public:
 	int glyphCount()                const    { return m_glyphs.count(); }
 	int firstChar()					const	{ return m_firstChar; }
 	int lastChar()					const	{ return m_lastChar; }
+	void moveChars(int delta)				{ m_firstChar += delta; m_lastChar += delta; }
 	qreal width() const;
 	PageItem* object()				const	{ return m_object; }
 };
 
 
-class SCRIBUS_API ScText : public CharStyle
+/**
+ * A run of characters of a StoryText which share the same CharStyle.
+ * Runs never extend past a PARSEP: a PARSEP is the last char of its run and
+ * the run holds the paragraph style. OBJECT chars always have a run of
+ * their own, holding the embedded item or mark.
+ */
+class SCRIBUS_API ScTextRun : public CharStyle
 {
 public:
-	ParagraphStyle* parstyle; // only for parseps
+	int length;
+	ParagraphStyle* parstyle; // only for runs ending with a parsep
 	int embedded;
 	Mark* mark;
-	QChar ch;
-	ScText() :
+	ScTextRun() :
 		CharStyle(),
-		parstyle(NULL),
-		embedded(0), mark(NULL), ch() {}
-	ScText(const ScText& other) :
+		length(0), parstyle(NULL),
+		embedded(0), mark(NULL) {}
+	ScTextRun(const ScTextRun& other) :
 		CharStyle(other),
-		parstyle(NULL),
-		embedded(other.embedded), mark(NULL), ch(other.ch)
+		length(other.length), parstyle(NULL),
+		embedded(other.embedded), mark(NULL)
 	{
 		if (other.parstyle)
 			parstyle = new ParagraphStyle(*other.parstyle);
 		if (other.mark)
 			setNewMark(other.mark);
 	}
-	~ScText();
+	~ScTextRun();
 
 	bool hasObject(ScribusDoc *doc) const;
 	//returns true if given MRK is found, if MRK is NULL then any mark returns true
 	bool hasMark(Mark * MRK = NULL) const;
-	QList<PageItem*> getGroupedItems(ScribusDoc *doc);
 	PageItem* getItem(ScribusDoc *doc);
 private:
 	void setNewMark(Mark* mrk);
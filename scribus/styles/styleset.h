@@ -3,21 +3,33 @@
 #ifndef STYLESET_H
 #define STYLESET_H
 
+#include <QHash>
 #include <QList>
 
 #include <assert.h>
 #include "style.h"
 
 
+/**
+ A list of styles which is also the StyleContext used to resolve their parents.
+ Names are looked up through a hash index, which is rebuilt lazily after the set
+ changed. Styles may be renamed through the references and pointers handed out,
+ so those accessors mark the index as outdated.
+ Renaming a style through a pointer kept from before the last lookup (from append(),
+ create() or an earlier operator[]) is not seen by the index: the old name is no
+ longer found, but the new one is only found after the next change of the set or
+ invalidate().
+ */
 template<class STYLE>
 class StyleSet : public StyleContext {
 public:
 	STYLE& operator[] (int index) { 
 		assert(index < styles.count()); 
+		m_indexed = -1;
 		return * styles[index]; 
 	}
 	
-	STYLE* getDefault(){ return m_default; }		
+	STYLE* getDefault(){ m_indexed = -1; return m_default; }		
 	
 	const STYLE& get(const QString& name) const { 
 		return * dynamic_cast<const STYLE*>(resolve(name)); 
@@ -38,6 +50,7 @@ public:
 		return styles.count();
 	}
 	
+	/// the new style is indexed by the name it has at the next lookup
 	STYLE* append(STYLE* style) { 
 		styles.append(style); 
 		style->setContext(this); 
@@ -66,7 +79,7 @@ public:
 	}
 	
 	
-	StyleSet() : styles(), m_context(NULL), m_default(NULL) {}
+	StyleSet() : styles(), m_context(NULL), m_default(NULL), m_indexed(0), m_indexVersion(-1) {}
 	
 	~StyleSet() { 
 		clear(false);
@@ -83,6 +96,7 @@ public:
 			delete styles.front(); 
 			styles.pop_front(); 
 		}
+		m_indexed = -1;
 		if (invalid)
 			invalidate();
 	}
@@ -103,9 +117,17 @@ private:
 	StyleSet(const StyleSet&)             { assert(false); }
 	StyleSet& operator= (const StyleSet&) { assert(false); return *this; }
 
+	inline int lookup(const QString& name) const;
+
 	QList<STYLE*> styles;
 	const StyleContext* m_context;
 	STYLE* m_default;
+	/// name -> position of the first style with that name
+	mutable QHash<QString, int> m_index;
+	/// number of styles in m_index, -1 if it has to be rebuilt
+	mutable int m_indexed;
+	/// m_version when m_index was built
+	mutable int m_indexVersion;
 };
 
 template<class STYLE>
@@ -118,24 +140,48 @@ inline void StyleSet<STYLE>::remove(int index)
 //	delete (*it);
 //	styles.erase(it);
 	styles.removeAt(index);
+	m_indexed = -1;
 }
 
 template<class STYLE>
-inline bool StyleSet<STYLE>::contains(const QString& name) const
+inline int StyleSet<STYLE>::lookup(const QString& name) const
 {
+	if (m_indexed < 0 || m_indexVersion != m_version)
+	{
+		m_index.clear();
+		m_index.reserve(styles.count());
+		m_indexed = 0;
+		m_indexVersion = m_version;
+	}
+	for (; m_indexed < styles.count(); ++m_indexed)
+	{
+		QString styleName(styles[m_indexed]->name());
+		if (!m_index.contains(styleName))
+			m_index.insert(styleName, m_indexed);
+	}
+	QHash<QString, int>::const_iterator it = m_index.constFind(name);
+	if (it == m_index.constEnd())
+		return -1;
+	if (styles[it.value()]->name() == name)
+		return it.value();
+	// renamed behind our back, fall back to a full search
+	m_indexed = -1;
 	for (int i=0; i < styles.count(); ++i)
 		if (styles[i]->name() == name)
-			return true;
-	return false;
+			return i;
+	return -1;
+}
+
+template<class STYLE>
+inline bool StyleSet<STYLE>::contains(const QString& name) const
+{
+	return lookup(name) >= 0;
 }
 
 template<class STYLE>
 inline int StyleSet<STYLE>::find(const QString& name) const
 {
-	for (int i=0; i < styles.count(); ++i)
-		if (styles[i]->name() == name)
-			return i;
-	return -1;
+	return lookup(name);
 }
 
 template<class STYLE>
@@ -143,11 +189,9 @@ inline const Style* StyleSet<STYLE>::resolve(const QString& name) const
 {
 	if (name.isEmpty())
 		return m_default;
-	for (int i=0; i < styles.count(); ++i)
-	{
-		if (styles[i]->name() == name)
-			return styles[i];
-	}
+	int index = lookup(name);
+	if (index >= 0)
+		return styles[index];
 	return m_context ? m_context->resolve(name) : NULL;
 }
 
@@ -156,20 +200,15 @@ inline void StyleSet<STYLE>::redefine(const StyleSet<STYLE>& defs, bool removeUn
 {
 	for (int i=signed(styles.count())-1; i >= 0; --i) 
 	{
-		bool found = false;
-		for (int j=0; j < defs.count(); ++j)
+		int j = defs.find(styles[i]->name());
+		if (j >= 0)
 		{
-			if (styles[i]->name() == defs[j].name()) 
-			{
-				found = true;
-				(*styles[i]) = defs[j];
-				(*styles[i]).setContext(this);
-				if (defs.m_default == defs.styles[j])
-					makeDefault(styles[i]);
-				break;
-			}
+			(*styles[i]) = defs[j];
+			(*styles[i]).setContext(this);
+			if (defs.m_default == defs.styles[j])
+				makeDefault(styles[i]);
 		}
-		if (!found && removeUnused) 
+		else if (removeUnused) 
 		{
 			if (styles[i] == m_default)
 				makeDefault(NULL);
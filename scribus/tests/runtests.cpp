@@ -2,7 +2,11 @@
 #include <QTest>
 //#include "testGlyphStore.h"
 //#include "testIndex.h"
+#include "testImageEffects.h"
+#include "testNumberFormat.h"
 #include "testStoryText.h"
+#include "testStyleSet.h"
+#include "testUndoState.h"
 #include "runtests.h"
 
 int RunTests::runTests(int argc, char ** argv)
@@ -10,6 +14,10 @@ int RunTests::runTests(int argc, char ** argv)
 	QList<QObject *> testObjects;
 //	testObjects << new TestGlyphStore();
 	testObjects << new TestStoryText();
+	testObjects << new TestImageEffects();
+	testObjects << new TestNumberFormat();
+	testObjects << new TestStyleSet();
+	testObjects << new TestUndoState();
 //	testObjects << new TestIndex();
 	int failed = 0;
 	for (int i = 0; i < testObjects.count(); ++i)
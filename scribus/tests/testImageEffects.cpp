@@ -0,0 +1,477 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QBuffer>
+#include <QDataStream>
+
+#include <math.h>
+
+#include "sccolor.h"
+#include "scimagestructs.h"
+#include "scstreamfilter.h"
+#include "testImageEffects.h"
+
+namespace {
+
+void fillImage(QImage& image)
+{
+	quint32 seed = 12345;
+	for (int y = 0; y < image.height(); ++y)
+	{
+		QRgb *s = (QRgb*) image.scanLine(y);
+		for (int x = 0; x < image.width(); ++x)
+		{
+			seed = seed * 1103515245 + 12345;
+			s[x] = seed;
+		}
+	}
+}
+
+ScImageEffectList effectList(int code, const QString& parameters)
+{
+	ImageEffect effect;
+	effect.effectCode = code;
+	effect.effectParameters = parameters;
+	ScImageEffectList effects;
+	effects.append(effect);
+	return effects;
+}
+
+// The per pixel kernels as they were before they were restructured
+
+void referenceInvert(QImage& image, bool cmyk)
+{
+	for (int yi = 0; yi < image.height(); ++yi)
+	{
+		QRgb *s = (QRgb*) image.scanLine(yi);
+		for (int xi = 0; xi < image.width(); ++xi)
+		{
+			if (cmyk)
+			{
+				unsigned char *p = (unsigned char *) s;
+				unsigned char c = 255 - qMin(255, p[0] + p[3]);
+				unsigned char m = 255 - qMin(255, p[1] + p[3]);
+				unsigned char y = 255 - qMin(255, p[2] + p[3]);
+				unsigned char k = qMin(qMin(c, m), y);
+				p[0] = c - k;
+				p[1] = m - k;
+				p[2] = y - k;
+				p[3] = k;
+			}
+			else
+				*s ^= 0x00ffffff;
+			s++;
+		}
+	}
+}
+
+void referenceGrayscale(QImage& image, bool cmyk)
+{
+	for (int yi = 0; yi < image.height(); ++yi)
+	{
+		QRgb *s = (QRgb*) image.scanLine(yi);
+		for (int xi = 0; xi < image.width(); ++xi)
+		{
+			QRgb r = *s;
+			if (cmyk)
+			{
+				int k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
+				*s = qRgba(0, 0, 0, k);
+			}
+			else
+			{
+				int k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
+				*s = qRgba(k, k, k, qAlpha(r));
+			}
+			s++;
+		}
+	}
+}
+
+void referenceCurve(QImage& image, const QVector<int>& curveTable, bool cmyk)
+{
+	for (int yi = 0; yi < image.height(); ++yi)
+	{
+		QRgb *s = (QRgb*) image.scanLine(yi);
+		for (int xi = 0; xi < image.width(); ++xi)
+		{
+			QRgb r = *s;
+			if (cmyk)
+			{
+				unsigned char *p = (unsigned char *) s;
+				p[0] = 255 - curveTable[255 - p[0]];
+				p[1] = 255 - curveTable[255 - p[1]];
+				p[2] = 255 - curveTable[255 - p[2]];
+				p[3] = 255 - curveTable[255 - p[3]];
+			}
+			else
+				*s = qRgba(curveTable[qRed(r)], curveTable[qGreen(r)], curveTable[qBlue(r)], qAlpha(r));
+			s++;
+		}
+	}
+}
+
+void referenceContrast(QImage& image, int contrastValue, bool cmyk)
+{
+	QVector<int> curveTable(256);
+	QPoint p1(0,0 - contrastValue);
+	QPoint p2(256, 256 + contrastValue);
+	double mc = (p1.y() - p2.y()) / (double)(p1.x() - p2.x());
+	for (int i = 0; i < 256; ++i)
+		curveTable[i] = qMin(255, qMax(0, int(i * mc) + p1.y()));
+	referenceCurve(image, curveTable, cmyk);
+}
+
+void referenceBrightness(QImage& image, int brightnessValue, bool cmyk)
+{
+	QVector<int> curveTable(256);
+	QPoint p1(0,0 + brightnessValue);
+	QPoint p2(256, 256 + brightnessValue);
+	double mc = (p1.y() - p2.y()) / (double)(p1.x() - p2.x());
+	for (int i = 0; i < 256; ++i)
+		curveTable[i] = qMin(255, qMax(0, int(i * mc) + p1.y()));
+	referenceCurve(image, curveTable, cmyk);
+}
+
+void referenceConvolve(const QImage& image, QImage& dest, int widthk, const double *kernel)
+{
+	QVector<double> normal_kernel(widthk*widthk);
+	dest = QImage(image.width(), image.height(), QImage::Format_ARGB32);
+	double normalize=0.0;
+	for(int i=0; i < (widthk*widthk); i++)
+		normalize += kernel[i];
+	if(fabs(normalize) <= 1.0e-12)
+		normalize=1.0;
+	normalize=1.0/normalize;
+	for(int i=0; i < (widthk*widthk); i++)
+		normal_kernel[i] = normalize*kernel[i];
+	for(int y=0; y < dest.height(); ++y)
+	{
+		unsigned int *q = (unsigned int *)dest.scanLine(y);
+		for(int x=0; x < dest.width(); ++x)
+		{
+			const double *k = normal_kernel.constData();
+			double red = 0, green = 0, blue = 0, alpha = 0;
+			int sy = y-(widthk/2);
+			for(int mcy=0; mcy < widthk; ++mcy, ++sy)
+			{
+				int my = sy < 0 ? 0 : sy > image.height()-1 ? image.height()-1 : sy;
+				int sx = x+(-widthk/2);
+				for(int mcx=0; mcx < widthk; ++mcx, ++sx)
+				{
+					int mx = sx < 0 ? 0 : sx > image.width()-1 ? image.width()-1 : sx;
+					int px = image.pixel(mx, my);
+					red += (*k)*(qRed(px)*257);
+					green += (*k)*(qGreen(px)*257);
+					blue += (*k)*(qBlue(px)*257);
+					alpha += (*k)*(qAlpha(px)*257);
+					++k;
+				}
+			}
+			red = red < 0 ? 0 : red > 65535 ? 65535 : red+0.5;
+			green = green < 0 ? 0 : green > 65535 ? 65535 : green+0.5;
+			blue = blue < 0 ? 0 : blue > 65535 ? 65535 : blue+0.5;
+			alpha = alpha < 0 ? 0 : alpha > 65535 ? 65535 : alpha+0.5;
+			*q++ = qRgba((unsigned char)(red/257UL),
+			             (unsigned char)(green/257UL),
+			             (unsigned char)(blue/257UL),
+			             (unsigned char)(alpha/257UL));
+		}
+	}
+}
+
+int referenceKernelWidth(double radius, double sigma)
+{
+	if(radius > 0.0)
+		return((int)(2.0*ceil(radius)+1.0));
+	long width;
+	for(width=5; ;)
+	{
+		double normalize=0.0;
+		for(long u=(-width/2); u <= (width/2); u++)
+			normalize+=exp(-((double) u*u)/(2.0*sigma*sigma))/(2.50662827463100024161235523934010416269302368164062*sigma);
+		long u=width/2;
+		double value=exp(-((double) u*u)/(2.0*sigma*sigma))/(2.50662827463100024161235523934010416269302368164062*sigma)/normalize;
+		if((long)(65535*value) <= 0)
+			break;
+		width+=2;
+	}
+	return((int)width-2);
+}
+
+void referenceSharpen(QImage& image, double radius, double sigma)
+{
+	int widthk = referenceKernelWidth(radius, sigma);
+	if(image.width() < widthk)
+		return;
+	QVector<double> kernel(widthk*widthk);
+	int i = 0;
+	double normalize=0.0;
+	for (long v=(-widthk/2); v <= (widthk/2); v++)
+	{
+		for (long u=(-widthk/2); u <= (widthk/2); u++)
+		{
+			double alpha=exp(-((double) u*u+v*v)/(2.0*sigma*sigma));
+			kernel[i]=alpha/(2.0*3.14159265358979323846264338327950288419716939937510*sigma*sigma);
+			normalize+=kernel[i];
+			i++;
+		}
+	}
+	kernel[i/2]=(-2.0)*normalize;
+	QImage dest;
+	referenceConvolve(image, dest, widthk, kernel.constData());
+	image = dest;
+}
+
+QByteArray referenceFilterData(const QImage& image, bool cmyk)
+{
+	QByteArray buffer;
+	for (int yi = 0; yi < image.height(); ++yi)
+	{
+		const QRgb *s = (const QRgb*) image.constScanLine(yi);
+		for (int xi = 0; xi < image.width(); ++xi)
+		{
+			QRgb r = *s++;
+			buffer.append(static_cast<char>(qRed(r)));
+			buffer.append(static_cast<char>(qGreen(r)));
+			buffer.append(static_cast<char>(qBlue(r)));
+			if (cmyk)
+				buffer.append(static_cast<char>(qAlpha(r)));
+		}
+	}
+	return buffer;
+}
+
+QByteArray filterData(ScImage& image, bool cmyk)
+{
+	QByteArray data;
+	QBuffer device(&data);
+	device.open(QIODevice::WriteOnly);
+	QDataStream stream(&device);
+	ScNullEncodeFilter filter(&stream);
+	filter.openFilter();
+	if (cmyk)
+		image.writeCMYKDataToFilter(&filter);
+	else
+		image.writeRGBDataToFilter(&filter);
+	filter.closeFilter();
+	return data;
+}
+
+// Grayscale conversion is exact in integers now and sharpen scales its sums
+// once instead of per kernel tap, so half way values may round differently
+bool sameImage(const QImage& a, const QImage& b, int tolerance)
+{
+	if (a.size() != b.size())
+		return false;
+	for (int y = 0; y < a.height(); ++y)
+	{
+		const uchar *pa = a.constScanLine(y);
+		const uchar *pb = b.constScanLine(y);
+		for (int x = 0; x < 4 * a.width(); ++x)
+		{
+			if (qAbs(pa[x] - pb[x]) > tolerance)
+				return false;
+		}
+	}
+	return true;
+}
+
+void benchmarkData(bool withReference)
+{
+	QTest::addColumn<QSize>("size");
+	QTest::addColumn<bool>("cmyk");
+	QTest::addColumn<bool>("reference");
+	QList<QSize> sizes;
+	sizes << QSize(1024, 768) << QSize(2480, 3508); // preview, A4 at 300 dpi
+	for (int i = 0; i < sizes.count(); ++i)
+	{
+		QString name = QString("%1x%2").arg(sizes[i].width()).arg(sizes[i].height());
+		QTest::newRow(qPrintable(name + " rgb")) << sizes[i] << false << false;
+		QTest::newRow(qPrintable(name + " cmyk")) << sizes[i] << true << false;
+		if (!withReference)
+			continue;
+		QTest::newRow(qPrintable(name + " rgb reference")) << sizes[i] << false << true;
+		QTest::newRow(qPrintable(name + " cmyk reference")) << sizes[i] << true << true;
+	}
+}
+
+}
+
+void TestImageEffects::matchesReference()
+{
+	ColorList colors;
+	for (int c = 0; c < 2; ++c)
+	{
+		bool cmyk = (c == 1);
+		ScImage image(97, 61);
+		fillImage(*image.qImagePtr());
+		QImage expected = image.qImage().copy();
+		image.applyEffect(effectList(ScImage::EF_INVERT, ""), colors, cmyk);
+		referenceInvert(expected, cmyk);
+		QVERIFY(sameImage(image.qImage(), expected, 0));
+
+		image.applyEffect(effectList(ScImage::EF_CONTRAST, "40"), colors, cmyk);
+		referenceContrast(expected, 40, cmyk);
+		QVERIFY(sameImage(image.qImage(), expected, 0));
+
+		image.applyEffect(effectList(ScImage::EF_BRIGHTNESS, "-30"), colors, cmyk);
+		referenceBrightness(expected, -30, cmyk);
+		QVERIFY(sameImage(image.qImage(), expected, 0));
+
+		image.applyEffect(effectList(ScImage::EF_BRIGHTNESS, "55"), colors, cmyk);
+		referenceBrightness(expected, 55, cmyk);
+		QVERIFY(sameImage(image.qImage(), expected, 0));
+
+		QCOMPARE(filterData(image, cmyk), referenceFilterData(expected, cmyk));
+
+		image.applyEffect(effectList(ScImage::EF_GRAYSCALE, ""), colors, cmyk);
+		referenceGrayscale(expected, cmyk);
+		QVERIFY(sameImage(image.qImage(), expected, 1));
+	}
+
+	// sharpen does not depend on the color model, check the computed and a fixed kernel width
+	QList<QPair<double, double> > sharpenParameters;
+	sharpenParameters << qMakePair(0.0, 1.0) << qMakePair(2.0, 1.5);
+	for (int i = 0; i < sharpenParameters.count(); ++i)
+	{
+		ScImage image(97, 61);
+		fillImage(*image.qImagePtr());
+		QImage expected = image.qImage().copy();
+		double radius = sharpenParameters[i].first;
+		double sigma = sharpenParameters[i].second;
+		image.applyEffect(effectList(ScImage::EF_SHARPEN, QString("%1 %2").arg(radius).arg(sigma)), colors, false);
+		referenceSharpen(expected, radius, sigma);
+		QVERIFY(sameImage(image.qImage(), expected, 1));
+	}
+}
+
+void TestImageEffects::benchmarkInvert_data()
+{
+	benchmarkData(true);
+}
+
+void TestImageEffects::benchmarkInvert()
+{
+	QFETCH(QSize, size);
+	QFETCH(bool, cmyk);
+	QFETCH(bool, reference);
+	ScImage image(size.width(), size.height());
+	fillImage(*image.qImagePtr());
+	ScImageEffectList effects = effectList(ScImage::EF_INVERT, "");
+	ColorList colors;
+	QBENCHMARK {
+		if (reference)
+			referenceInvert(*image.qImagePtr(), cmyk);
+		else
+			image.applyEffect(effects, colors, cmyk);
+	}
+}
+
+void TestImageEffects::benchmarkGrayscale_data()
+{
+	benchmarkData(true);
+}
+
+void TestImageEffects::benchmarkGrayscale()
+{
+	QFETCH(QSize, size);
+	QFETCH(bool, cmyk);
+	QFETCH(bool, reference);
+	ScImage image(size.width(), size.height());
+	fillImage(*image.qImagePtr());
+	ScImageEffectList effects = effectList(ScImage::EF_GRAYSCALE, "");
+	ColorList colors;
+	QBENCHMARK {
+		if (reference)
+			referenceGrayscale(*image.qImagePtr(), cmyk);
+		else
+			image.applyEffect(effects, colors, cmyk);
+	}
+}
+
+void TestImageEffects::benchmarkContrast_data()
+{
+	benchmarkData(true);
+}
+
+void TestImageEffects::benchmarkContrast()
+{
+	QFETCH(QSize, size);
+	QFETCH(bool, cmyk);
+	QFETCH(bool, reference);
+	ScImage image(size.width(), size.height());
+	fillImage(*image.qImagePtr());
+	ScImageEffectList effects = effectList(ScImage::EF_CONTRAST, "20");
+	ColorList colors;
+	QBENCHMARK {
+		if (reference)
+			referenceContrast(*image.qImagePtr(), 20, cmyk);
+		else
+			image.applyEffect(effects, colors, cmyk);
+	}
+}
+
+void TestImageEffects::benchmarkSharpen_data()
+{
+	benchmarkData(true);
+}
+
+void TestImageEffects::benchmarkSharpen()
+{
+	QFETCH(QSize, size);
+	QFETCH(bool, cmyk);
+	QFETCH(bool, reference);
+	ScImage image(size.width(), size.height());
+	fillImage(*image.qImagePtr());
+	ScImageEffectList effects = effectList(ScImage::EF_SHARPEN, "0 1");
+	ColorList colors;
+	QBENCHMARK {
+		if (reference)
+			referenceSharpen(*image.qImagePtr(), 0.0, 1.0);
+		else
+			image.applyEffect(effects, colors, cmyk);
+	}
+}
+
+void TestImageEffects::benchmarkBlur_data()
+{
+	benchmarkData(false);
+}
+
+void TestImageEffects::benchmarkBlur()
+{
+	QFETCH(QSize, size);
+	QFETCH(bool, cmyk);
+	ScImage image(size.width(), size.height());
+	fillImage(*image.qImagePtr());
+	ScImageEffectList effects = effectList(ScImage::EF_BLUR, "5 1");
+	ColorList colors;
+	QBENCHMARK {
+		image.applyEffect(effects, colors, cmyk);
+	}
+}
+
+void TestImageEffects::benchmarkWriteData_data()
+{
+	benchmarkData(true);
+}
+
+void TestImageEffects::benchmarkWriteData()
+{
+	QFETCH(QSize, size);
+	QFETCH(bool, cmyk);
+	QFETCH(bool, reference);
+	ScImage image(size.width(), size.height());
+	fillImage(*image.qImagePtr());
+	QBENCHMARK {
+		if (reference)
+			referenceFilterData(image.qImage(), cmyk);
+		else
+			filterData(image, cmyk);
+	}
+}
@@ -0,0 +1,35 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QtTest/QtTest>
+
+#include "scimage.h"
+
+/*
+ Checks the ScImage pixel kernels against plain per pixel versions and
+ benchmarks both on preview and print sized images (scribus --tests).
+*/
+class TestImageEffects: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void matchesReference();
+	void benchmarkInvert_data();
+	void benchmarkInvert();
+	void benchmarkGrayscale_data();
+	void benchmarkGrayscale();
+	void benchmarkContrast_data();
+	void benchmarkContrast();
+	void benchmarkSharpen_data();
+	void benchmarkSharpen();
+	void benchmarkBlur_data();
+	void benchmarkBlur();
+	void benchmarkWriteData_data();
+	void benchmarkWriteData();
+};
@@ -0,0 +1,163 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QBuffer>
+#include <QDataStream>
+
+#include "util_math.h"
+#include "testNumberFormat.h"
+
+namespace {
+
+const int pathCount = 10000;
+
+QVector<double> pathCoordinates()
+{
+	// each path is a moveto and four curvetos
+	QVector<double> coords(pathCount * 26);
+	quint32 seed = 12345;
+	for (int i = 0; i < coords.count(); ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		coords[i] = (seed >> 8) / 16777216.0 * 842.0 - 421.0;
+	}
+	return coords;
+}
+
+// PSLib's output before it used appendDecimal()
+
+QString referenceToStr(double c)
+{
+	QString cc;
+	return cc.setNum(c);
+}
+
+void referencePutStream(QDataStream& stream, const QString& c)
+{
+	QByteArray utf8Array = c.toUtf8();
+	stream.writeRawData(utf8Array.data(), utf8Array.length());
+}
+
+void referencePage(QDataStream& stream, const QVector<double>& coords)
+{
+	const double* p = coords.constData();
+	for (int i = 0; i < pathCount; ++i, p += 26)
+	{
+		referencePutStream(stream, referenceToStr(p[0]) + " " + referenceToStr(p[1]) + " m\n");
+		for (int j = 2; j < 26; j += 6)
+			referencePutStream(stream, referenceToStr(p[j]) + " " + referenceToStr(p[j + 1]) + " " + referenceToStr(p[j + 2]) + " " + referenceToStr(p[j + 3]) + " " + referenceToStr(p[j + 4]) + " " + referenceToStr(p[j + 5]) + " cu\n");
+		referencePutStream(stream, "cl\n");
+		referencePutStream(stream, QString("0.0 0.0 0.0 1.0") + " cmyk fill\n");
+	}
+}
+
+// PSLib::PutOperator(), the line itself is formatted by the shared appendOperator()
+
+void putOperator(QDataStream& stream, QByteArray& line, const double* values, int count, const char* op)
+{
+	line.resize(0);
+	appendOperator(line, values, count, 5, op);
+	stream.writeRawData(line.constData(), line.size());
+}
+
+void page(QDataStream& stream, const QVector<double>& coords)
+{
+	QByteArray line;
+	line.reserve(256);
+	QByteArray fillColor("0 0 0 1");
+	const double* p = coords.constData();
+	for (int i = 0; i < pathCount; ++i, p += 26)
+	{
+		putOperator(stream, line, p, 2, "m");
+		for (int j = 2; j < 26; j += 6)
+			putOperator(stream, line, p + j, 6, "cu");
+		stream.writeRawData("cl\n", 3);
+		QByteArray fill = fillColor + " cmyk fill\n";
+		stream.writeRawData(fill.constData(), fill.size());
+	}
+}
+
+}
+
+void TestNumberFormat::appendDecimal_data()
+{
+	QTest::addColumn<double>("value");
+	QTest::addColumn<int>("decimals");
+	QTest::addColumn<QByteArray>("expected");
+	QTest::newRow("zero") << 0.0 << 5 << QByteArray("0");
+	QTest::newRow("integer") << 3.0 << 5 << QByteArray("3");
+	QTest::newRow("negative integer") << -42.0 << 5 << QByteArray("-42");
+	QTest::newRow("leading zeros") << 0.05 << 5 << QByteArray("0.05");
+	QTest::newRow("negative fraction") << -0.25 << 5 << QByteArray("-0.25");
+	QTest::newRow("rounded") << 123.456789 << 5 << QByteArray("123.45679");
+	QTest::newRow("rounded up") << 99999.999996 << 5 << QByteArray("100000");
+	QTest::newRow("tiny") << 1e-7 << 5 << QByteArray("0");
+	QTest::newRow("negative tiny") << -1e-7 << 5 << QByteArray("0");
+	QTest::newRow("no exponent") << 1e13 << 5 << QByteArray("10000000000000");
+	QTest::newRow("no decimals") << 2.5 << 0 << QByteArray("3");
+	QTest::newRow("six decimals") << 0.1234564 << 6 << QByteArray("0.123456");
+	QTest::newRow("huge") << 1e20 << 5 << QByteArray("100000000000000000000");
+}
+
+void TestNumberFormat::appendDecimal()
+{
+	QFETCH(double, value);
+	QFETCH(int, decimals);
+	QFETCH(QByteArray, expected);
+	QByteArray result("x");
+	::appendDecimal(result, value, decimals);
+	QCOMPARE(result, QByteArray("x") + expected);
+}
+
+void TestNumberFormat::appendOperator()
+{
+	const double values[] = { 12.5, -0.000001, 1e13, 0.333333333 };
+	QByteArray line("x ");
+	::appendOperator(line, values, 4, 5, "cu");
+	QCOMPARE(line, QByteArray("x 12.5 0 10000000000000 0.33333 cu\n"));
+	line.resize(0);
+	::appendOperator(line, values, 0, 5, "cl");
+	QCOMPARE(line, QByteArray("cl\n"));
+}
+
+void TestNumberFormat::roundTrip()
+{
+	QVector<double> coords = pathCoordinates();
+	QByteArray number;
+	for (int i = 0; i < coords.count(); ++i)
+	{
+		number.resize(0);
+		::appendDecimal(number, coords[i], 5);
+		QVERIFY(!number.contains('e'));
+		QVERIFY(qAbs(number.toDouble() - coords[i]) <= 0.000005 + 1e-9);
+	}
+}
+
+void TestNumberFormat::benchmarkPathPage_data()
+{
+	QTest::addColumn<bool>("reference");
+	QTest::newRow("appendDecimal") << false;
+	QTest::newRow("reference") << true;
+}
+
+void TestNumberFormat::benchmarkPathPage()
+{
+	QFETCH(bool, reference);
+	QVector<double> coords = pathCoordinates();
+	QByteArray output;
+	QBENCHMARK {
+		output.resize(0);
+		QBuffer buffer(&output);
+		buffer.open(QIODevice::WriteOnly);
+		QDataStream stream(&buffer);
+		if (reference)
+			referencePage(stream, coords);
+		else
+			page(stream, coords);
+	}
+	QVERIFY(output.size() > pathCount * 100);
+}
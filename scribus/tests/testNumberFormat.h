@@ -0,0 +1,28 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QtTest/QtTest>
+
+/*
+ Checks appendDecimal() and appendOperator(), the number formatting shared by
+ the PostScript and PDF exporters, and benchmarks writing the path operators
+ of a synthetic 10,000 path page with them against the former QString based
+ formatting.
+*/
+class TestNumberFormat: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void appendDecimal_data();
+	void appendDecimal();
+	void appendOperator();
+	void roundTrip();
+	void benchmarkPathPage_data();
+	void benchmarkPathPage();
+};
@@ -9,6 +9,53 @@
 
 #include <QDebug>
 #include "testStoryText.h"
+#include "text/sctext_shared.h"
+
+namespace {
+
+// a long story with a few formatted words in each paragraph
+void fillStory(StoryText& story, int paragraphs)
+{
+	CharStyle emphasis;
+	emphasis.setFontSize(14);
+	QString par = QString("Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor.") + SpecialChars::PARSEP;
+	for (int i = 0; i < paragraphs; ++i)
+	{
+		int start = story.length();
+		story.insertChars(start, par);
+		story.applyCharStyle(start + 6, 5, emphasis);
+		story.applyCharStyle(start + 28, 11, emphasis);
+	}
+}
+
+// every char has to find its defaults in the style of its paragraph
+bool contextsMatch(const StoryText& story)
+{
+	for (int i = 0; i < story.length(); ++i)
+	{
+		if (story.text(i) == SpecialChars::PARSEP)
+			continue;
+		if (story.charStyle(i).context() != story.paragraphStyle(i).charStyleContext())
+			return false;
+	}
+	return true;
+}
+
+bool runContextsMatch(const ScText_Shared& shared)
+{
+	const StyleContext* context = shared.trailingStyle.charStyleContext();
+	for (int i = shared.runs.count() - 1; i >= 0; --i)
+	{
+		const ScTextRun* run = shared.runs.at(i);
+		if (run->parstyle)
+			context = run->parstyle->charStyleContext();
+		if (run->context() != context)
+			return false;
+	}
+	return true;
+}
+
+}
 
 void TestStoryText::initST()
 {
@@ -127,3 +174,277 @@ void TestStoryText::removeCharStyle()
 	QCOMPARE(story.startOfRun(2), 5  + 26 + 1);
 	QCOMPARE(story.endOfRun(2), 11 + 26);
 }
+
+void TestStoryText::mapUnchanged()
+{
+	StoryText story;
+	story.insertChars(0,
+					  QString("0123456789") + SpecialChars::PARSEP + 
+					  QString("abcdefghijklmnopqrstuvwxyz"));
+	uint serial = story.changeSerial();
+	story.insertChars(3, "xyz");
+	int first = 11, last = 20;
+	QVERIFY(story.mapUnchangedRange(serial, first, last));
+	QCOMPARE(first, 14);
+	QCOMPARE(last, 23);
+	story.removeChars(0, 2);
+	first = 11;
+	last = 20;
+	QVERIFY(story.mapUnchangedRange(serial, first, last));
+	QCOMPARE(first, 12);
+	QCOMPARE(last, 21);
+	story.insertChars(15, "!");
+	first = 11;
+	last = 20;
+	QVERIFY(!story.mapUnchangedRange(serial, first, last));
+	first = 0;
+	last = 2;
+	QVERIFY(!story.mapUnchangedRange(serial, first, last));
+	first = 21;
+	last = 22;
+	QVERIFY(story.mapUnchangedRange(story.changeSerial(), first, last));
+	QCOMPARE(first, 21);
+}
+
+void TestStoryText::flagsKeepRuns()
+{
+	StoryText story;
+	story.insertChars(0, QString("Silbentrennung"));
+	char hyphens[] = { 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0 };
+	story.hyphenateWord(0, 14, hyphens);
+	QCOMPARE(story.nrOfRuns(), 1u);
+	QVERIFY(story.hasFlag(4, ScLayout_HyphenationPossible));
+	QVERIFY(!story.hasFlag(5, ScLayout_HyphenationPossible));
+	CharStyle cs;
+	cs.setFontSize(10);
+	story.applyCharStyle(3, 4, cs);
+	QCOMPARE(story.nrOfRuns(), 3u);
+	story.setCharStyle(0, story.length(), CharStyle());
+	QCOMPARE(story.nrOfRuns(), 1u);
+	QVERIFY(story.hasFlag(9, ScLayout_HyphenationPossible));
+}
+
+void TestStoryText::joinPars()
+{
+	StoryText story;
+	story.insertChars(0, QString("Hallo") + SpecialChars::PARSEP + QString("Welt") + SpecialChars::PARSEP + QString("Ende"));
+	ParagraphStyle centered;
+	centered.setAlignment(ParagraphStyle::Centered);
+	story.applyStyle(0, centered);
+	ParagraphStyle right;
+	right.setAlignment(ParagraphStyle::Rightaligned);
+	story.applyStyle(6, right);
+	QCOMPARE(story.nrOfRuns(), 3u);
+
+	// the joined paragraph keeps the style of its second half
+	story.removeChars(5, 1);
+	QCOMPARE(story.text(0, story.length()), QString("HalloWelt") + SpecialChars::PARSEP + QString("Ende"));
+	QCOMPARE(story.nrOfParagraphs(), 2u);
+	QCOMPARE(story.nrOfRuns(), 2u);
+	QCOMPARE(story.endOfRun(0), 10);
+	for (int i = 0; i < 10; ++i)
+		QCOMPARE(story.paragraphStyle(i).alignment(), ParagraphStyle::Rightaligned);
+	for (int i = 10; i < story.length(); ++i)
+		QCOMPARE(story.paragraphStyle(i).alignment(), ParagraphStyle::Leftaligned);
+	QVERIFY(contextsMatch(story));
+}
+
+void TestStoryText::replaceParSep()
+{
+	StoryText story;
+	story.insertChars(0, QString("Hallo") + SpecialChars::PARSEP + QString("Welt"));
+	ParagraphStyle centered;
+	centered.setAlignment(ParagraphStyle::Centered);
+	story.applyStyle(0, centered);
+
+	story.replaceChar(5, ' ');
+	QCOMPARE(story.text(0, story.length()), QString("Hallo Welt"));
+	QCOMPARE(story.nrOfParagraphs(), 1u);
+	QCOMPARE(story.nrOfRuns(), 1u);
+	for (int i = 0; i < story.length(); ++i)
+		QCOMPARE(story.paragraphStyle(i).alignment(), ParagraphStyle::Leftaligned);
+	QVERIFY(contextsMatch(story));
+
+	// the new paragraph gets a copy of the style it was split from
+	story.applyStyle(0, centered);
+	story.replaceChar(5, SpecialChars::PARSEP);
+	QCOMPARE(story.text(0, story.length()), QString("Hallo") + SpecialChars::PARSEP + QString("Welt"));
+	QCOMPARE(story.nrOfParagraphs(), 2u);
+	QCOMPARE(story.nrOfRuns(), 2u);
+	QCOMPARE(story.endOfRun(0), 6);
+	QVERIFY(&story.paragraphStyle(0) != &story.paragraphStyle(6));
+	for (int i = 0; i < story.length(); ++i)
+		QCOMPARE(story.paragraphStyle(i).alignment(), ParagraphStyle::Centered);
+	QVERIFY(contextsMatch(story));
+}
+
+void TestStoryText::replaceObject()
+{
+	StoryText story;
+	story.insertChars(0, QString("Hallo Welt"));
+	CharStyle cs;
+	cs.setFontSize(10);
+	story.applyCharStyle(0, story.length(), cs);
+
+	story.replaceChar(5, SpecialChars::OBJECT);
+	QCOMPARE(story.text(5), SpecialChars::OBJECT);
+	QCOMPARE(story.nrOfRuns(), 3u);
+	QCOMPARE(story.startOfRun(1), 5);
+	QCOMPARE(story.endOfRun(1), 6);
+	for (int i = 0; i < story.length(); ++i)
+		QCOMPARE(story.charStyle(i).fontSize(), 10.0);
+	QVERIFY(contextsMatch(story));
+
+	story.replaceChar(5, ' ');
+	QCOMPARE(story.text(0, story.length()), QString("Hallo Welt"));
+	QCOMPARE(story.nrOfRuns(), 1u);
+	QCOMPARE(story.charStyle(5).fontSize(), 10.0);
+	QVERIFY(contextsMatch(story));
+}
+
+void TestStoryText::insertPars()
+{
+	StoryText story;
+	story.insertChars(0, QString("HalloWelt"));
+	CharStyle cs;
+	cs.setFontSize(10);
+	story.applyCharStyle(0, story.length(), cs);
+	ParagraphStyle centered;
+	centered.setAlignment(ParagraphStyle::Centered);
+	story.applyStyle(0, centered);
+	QCOMPARE(story.nrOfRuns(), 1u);
+
+	story.insertChars(5, QString("A") + SpecialChars::PARSEP + QString("B") + SpecialChars::PARSEP + QString("C"));
+	QCOMPARE(story.text(0, story.length()),
+			 QString("HalloA") + SpecialChars::PARSEP + QString("B") + SpecialChars::PARSEP + QString("CWelt"));
+	QCOMPARE(story.nrOfParagraphs(), 3u);
+	// "Hallo", "A", "B", "C" and "Welt", the PARSEPs end the runs of the new chars
+	QCOMPARE(story.nrOfRuns(), 5u);
+	QCOMPARE(story.endOfRun(0), 5);
+	QCOMPARE(story.endOfRun(1), 7);
+	QCOMPARE(story.endOfRun(2), 9);
+	QCOMPARE(story.endOfRun(3), 10);
+	QCOMPARE(story.endOfRun(4), 14);
+	for (int i = 0; i < 5; ++i)
+		QCOMPARE(story.charStyle(i).fontSize(), 10.0);
+	for (int i = 10; i < 14; ++i)
+		QCOMPARE(story.charStyle(i).fontSize(), 10.0);
+	QVERIFY(story.charStyle(5).fontSize() != 10.0);
+	QVERIFY(&story.paragraphStyle(0) != &story.paragraphStyle(7));
+	QVERIFY(&story.paragraphStyle(7) != &story.paragraphStyle(9));
+	for (int i = 0; i < story.length(); ++i)
+		QCOMPARE(story.paragraphStyle(i).alignment(), ParagraphStyle::Centered);
+	QVERIFY(contextsMatch(story));
+}
+
+void TestStoryText::objectRuns()
+{
+	StoryText story;
+	story.insertChars(0, QString("Hallo Welt"));
+	story.insertChars(5, QString(SpecialChars::OBJECT));
+	QCOMPARE(story.nrOfRuns(), 3u);
+
+	// equal styles never merge into an object's run
+	CharStyle cs;
+	cs.setFontSize(10);
+	story.applyCharStyle(0, story.length(), cs);
+	QCOMPARE(story.nrOfRuns(), 3u);
+	story.setCharStyle(0, story.length(), CharStyle());
+	QCOMPARE(story.nrOfRuns(), 3u);
+
+	story.applyCharStyle(3, 5, cs);
+	QCOMPARE(story.nrOfRuns(), 5u);
+	QCOMPARE(story.startOfRun(2), 5);
+	QCOMPARE(story.endOfRun(2), 6);
+
+	// without the object the styled chars around it form one run
+	story.removeChars(5, 1);
+	QCOMPARE(story.text(0, story.length()), QString("Hallo Welt"));
+	QCOMPARE(story.nrOfRuns(), 3u);
+	QCOMPARE(story.startOfRun(1), 3);
+	QCOMPARE(story.endOfRun(1), 7);
+	for (int i = 3; i < 7; ++i)
+		QCOMPARE(story.charStyle(i).fontSize(), 10.0);
+	QVERIFY(story.charStyle(2).fontSize() != 10.0);
+	QVERIFY(contextsMatch(story));
+}
+
+void TestStoryText::copyShared()
+{
+	ScText_Shared shared(NULL);
+	CharStyle cs;
+	cs.setFontSize(10);
+	cs.setContext(shared.trailingStyle.charStyleContext());
+	shared.insertChars(0, QString("Hallo") + SpecialChars::PARSEP + QString("Welt"), cs);
+	ScTextRun* parsepRun = shared.runOf(5);
+	parsepRun->parstyle = new ParagraphStyle();
+	parsepRun->parstyle->setContext(& shared.pstyleContext);
+	parsepRun->parstyle->setAlignment(ParagraphStyle::Centered);
+	shared.replaceCharStyleContextInParagraph(5, parsepRun->parstyle->charStyleContext());
+	QCOMPARE(shared.runs.count(), 2);
+	QVERIFY(runContextsMatch(shared));
+
+	// the copies own their paragraph styles and the runs look up defaults there
+	ScText_Shared copy(shared);
+	QCOMPARE(copy.text, shared.text);
+	QCOMPARE(copy.runs.count(), 2);
+	QCOMPARE(copy.runs.at(0)->length, 6);
+	QVERIFY(copy.runs.at(0)->parstyle);
+	QVERIFY(copy.runs.at(0)->parstyle != parsepRun->parstyle);
+	QVERIFY(copy.runs.at(0)->parstyle->context() == & copy.pstyleContext);
+	QCOMPARE(copy.runs.at(0)->parstyle->alignment(), ParagraphStyle::Centered);
+	QCOMPARE(copy.runs.at(1)->fontSize(), 10.0);
+	QVERIFY(runContextsMatch(copy));
+
+	ScText_Shared assigned(NULL);
+	assigned.insertChars(0, QString("x") + SpecialChars::PARSEP, cs);
+	assigned = shared;
+	QCOMPARE(assigned.text, shared.text);
+	QCOMPARE(assigned.runs.count(), 2);
+	QVERIFY(assigned.runs.at(0)->parstyle != parsepRun->parstyle);
+	QVERIFY(assigned.runs.at(0)->parstyle->context() == & assigned.pstyleContext);
+	QCOMPARE(assigned.runs.at(0)->parstyle->alignment(), ParagraphStyle::Centered);
+	QVERIFY(runContextsMatch(assigned));
+
+	// and the original still uses its own
+	QVERIFY(runContextsMatch(shared));
+	QVERIFY(shared.runs.at(0)->context() == parsepRun->parstyle->charStyleContext());
+}
+
+void TestStoryText::benchmarkTyping()
+{
+	StoryText story;
+	fillStory(story, 2000);
+	int pos = story.length() / 2;
+	QBENCHMARK {
+		story.insertChars(pos, "x");
+		story.removeChars(pos, 1);
+	}
+	QCOMPARE(story.length(), 2000 * 80);
+}
+
+void TestStoryText::benchmarkApplyCharStyle()
+{
+	StoryText story;
+	fillStory(story, 2000);
+	CharStyle cs;
+	cs.setFontSize(10);
+	int pos = story.length() / 2;
+	QBENCHMARK {
+		story.applyCharStyle(pos, 1000, cs);
+	}
+	QCOMPARE(story.charStyle(pos + 999).fontSize(), 10.0);
+}
+
+void TestStoryText::benchmarkCharStyleWalk()
+{
+	StoryText story;
+	fillStory(story, 2000);
+	double sum = 0;
+	// what layout does: read each char's style in turn
+	QBENCHMARK {
+		for (int i = 0; i < story.length(); ++i)
+			sum += story.charStyle(i).fontSize();
+	}
+	QVERIFY(sum > 0);
+}
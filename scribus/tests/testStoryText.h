@@ -27,4 +27,15 @@ private slots:
 	void removePars();
 	void applyCharStyle();
 	void removeCharStyle();
+	void mapUnchanged();
+	void flagsKeepRuns();
+	void joinPars();
+	void replaceParSep();
+	void replaceObject();
+	void insertPars();
+	void objectRuns();
+	void copyShared();
+	void benchmarkTyping();
+	void benchmarkApplyCharStyle();
+	void benchmarkCharStyleWalk();
 };
@@ -0,0 +1,106 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "styles/charstyle.h"
+#include "styles/styleset.h"
+#include "testStyleSet.h"
+
+namespace {
+
+CharStyle* addStyle(StyleSet<CharStyle>& set, const QString& name)
+{
+	CharStyle proto;
+	proto.setName(name);
+	return set.create(proto);
+}
+
+}
+
+void TestStyleSet::appendThenFind()
+{
+	StyleSet<CharStyle> set;
+	addStyle(set, "A");
+	addStyle(set, "B");
+	QCOMPARE(set.find("A"), 0);
+	QCOMPARE(set.find("B"), 1);
+	QCOMPARE(set.find("C"), -1);
+	// appended after the index was built
+	addStyle(set, "C");
+	QCOMPARE(set.find("C"), 2);
+	QVERIFY(set.contains("C"));
+	// the first style of a name wins
+	addStyle(set, "A");
+	QCOMPARE(set.find("A"), 0);
+}
+
+void TestStyleSet::renameByIndex()
+{
+	StyleSet<CharStyle> set;
+	addStyle(set, "A");
+	addStyle(set, "B");
+	QCOMPARE(set.find("A"), 0);
+	set[0].setName("Z");
+	QCOMPARE(set.find("Z"), 0);
+	QCOMPARE(set.find("A"), -1);
+	QCOMPARE(set.find("B"), 1);
+}
+
+void TestStyleSet::removeStyle()
+{
+	StyleSet<CharStyle> set;
+	addStyle(set, "A");
+	CharStyle* b = addStyle(set, "B");
+	addStyle(set, "C");
+	QCOMPARE(set.find("C"), 2);
+	set.remove(1);
+	delete b;
+	QCOMPARE(set.count(), 2);
+	QCOMPARE(set.find("B"), -1);
+	QCOMPARE(set.find("C"), 1);
+	QCOMPARE(set.find("A"), 0);
+}
+
+void TestStyleSet::redefine()
+{
+	StyleSet<CharStyle> set;
+	addStyle(set, "A");
+	addStyle(set, "B");
+	QCOMPARE(set.find("A"), 0);
+	QCOMPARE(set.find("B"), 1);
+
+	StyleSet<CharStyle> defs;
+	addStyle(defs, "B")->setFontSize(240);
+	addStyle(defs, "C");
+	set.redefine(defs);
+	QCOMPARE(set.count(), 3);
+	QCOMPARE(set.find("A"), 0);
+	QCOMPARE(set.find("B"), 1);
+	QCOMPARE(set.find("C"), 2);
+	QCOMPARE(set.get("B").fontSize(), 240.0);
+
+	CharStyle* a = &set[0];
+	set.redefine(defs, true);
+	delete a;
+	QCOMPARE(set.count(), 2);
+	QCOMPARE(set.find("A"), -1);
+	QCOMPARE(set.find("B"), 0);
+	QCOMPARE(set.find("C"), 1);
+}
+
+void TestStyleSet::renameHeldPointer()
+{
+	// documented limitation: the new name is only found once the set changes
+	StyleSet<CharStyle> set;
+	CharStyle* a = addStyle(set, "A");
+	addStyle(set, "B");
+	QCOMPARE(set.find("A"), 0);
+	a->setName("Z");
+	QCOMPARE(set.find("A"), -1);
+	set.invalidate();
+	QCOMPARE(set.find("Z"), 0);
+	QCOMPARE(set.find("B"), 1);
+}
@@ -0,0 +1,24 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QtTest/QtTest>
+
+/*
+ Checks that the name index of StyleSet follows the changes of the set.
+*/
+class TestStyleSet: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void appendThenFind();
+	void renameByIndex();
+	void removeStyle();
+	void redefine();
+	void renameHeldPointer();
+};
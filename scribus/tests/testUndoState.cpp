@@ -0,0 +1,144 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "fpointarray.h"
+#include "scimagestructs.h"
+#include "undomanager.h"
+#include "undoobject.h"
+#include "undostack.h"
+#include "undostate.h"
+#include "testUndoState.h"
+
+namespace {
+
+SimpleState* moveState(UndoObject* target)
+{
+	SimpleState* ss = new SimpleState("Move");
+	ss->set("ITEM_MOVE");
+	ss->set("OLD_XPOS", 0.0);
+	ss->set("NEW_XPOS", 1.0);
+	ss->setUndoObject(target);
+	return ss;
+}
+
+FPointArray path(int count)
+{
+	FPointArray points;
+	for (int i = 0; i < count; ++i)
+		points.addPoint(i, i);
+	return points;
+}
+
+}
+
+void TestUndoState::mergeSameObject()
+{
+	DummyUndoObject item;
+	QScopedPointer<SimpleState> last(moveState(&item));
+	QVERIFY(last->canMerge(&item, "ITEM_MOVE", 60000));
+}
+
+void TestUndoState::mergeOtherObject()
+{
+	DummyUndoObject item;
+	DummyUndoObject other;
+	QScopedPointer<SimpleState> last(moveState(&item));
+	QVERIFY(!last->canMerge(&other, "ITEM_MOVE", 60000));
+	QVERIFY(!last->canMerge(NULL, "ITEM_MOVE", 60000));
+}
+
+void TestUndoState::mergeOtherAction()
+{
+	DummyUndoObject item;
+	QScopedPointer<SimpleState> last(moveState(&item));
+	QVERIFY(!last->canMerge(&item, "ITEM_RESIZE", 60000));
+}
+
+void TestUndoState::mergeAfterInterval()
+{
+	DummyUndoObject item;
+	QScopedPointer<SimpleState> last(moveState(&item));
+	QTest::qWait(50);
+	QVERIFY(!last->canMerge(&item, "ITEM_MOVE", 20));
+}
+
+void TestUndoState::mergeAfterTouch()
+{
+	// a sequence of nudges keeps extending the same state as long as each follows quickly
+	DummyUndoObject item;
+	QScopedPointer<SimpleState> last(moveState(&item));
+	QTest::qWait(100);
+	qint64 before = last->msecsSinceChange();
+	QVERIFY(before >= 50);
+	last->touch();
+	QVERIFY(last->msecsSinceChange() < before);
+	QVERIFY(last->canMerge(&item, "ITEM_MOVE", 60000));
+}
+
+void TestUndoState::stackMergesLastMove()
+{
+	DummyUndoObject item;
+	UndoStack stack;
+	SimpleState* move = moveState(&item);
+	stack.action(move);
+	QCOMPARE(stack.mergeCandidate(&item, "ITEM_MOVE", 60000), move);
+	stack.clear();
+}
+
+void TestUndoState::stackKeepsOtherActions()
+{
+	DummyUndoObject item;
+	DummyUndoObject other;
+	UndoStack stack;
+	stack.action(moveState(&item));
+	stack.action(moveState(&other));
+	QVERIFY(stack.mergeCandidate(&item, "ITEM_MOVE", 60000) == NULL);
+	stack.clear();
+}
+
+void TestUndoState::stackKeepsRedo()
+{
+	// move A, move B, undo, move A: the new move must not extend A's state
+	// while B can still be redone
+	DummyUndoObject a;
+	DummyUndoObject b;
+	UndoStack stack;
+	stack.action(moveState(&a));
+	stack.action(moveState(&b));
+	stack.undo(1, Um::GLOBAL_UNDO_MODE);
+	QCOMPARE(stack.redoItems(), 1u);
+	QVERIFY(stack.mergeCandidate(&a, "ITEM_MOVE", 60000) == NULL);
+	stack.clear();
+}
+
+void TestUndoState::payloadPath()
+{
+	ScItemState<FPointArray> small("Path");
+	small.setItem(path(4));
+	ScItemState<FPointArray> large("Path");
+	large.setItem(path(10000));
+	QVERIFY(large.memorySize() - small.memorySize() >= qint64(9996 * sizeof(FPoint)));
+}
+
+void TestUndoState::payloadPathPair()
+{
+	ScItemState<QPair<FPointArray, FPointArray> > state("Path");
+	state.setItem(qMakePair(path(1000), path(2000)));
+	QVERIFY(state.memorySize() >= qint64(3000 * sizeof(FPoint)));
+}
+
+void TestUndoState::payloadEffects()
+{
+	ImageEffect effect;
+	effect.effectCode = 0;
+	effect.effectParameters = QString(5000, QChar('1'));
+	ScImageEffectList effects;
+	effects.append(effect);
+	ScItemState<ScImageEffectList> state("Effects");
+	state.setItem(effects);
+	QVERIFY(state.memorySize() >= qint64(5000 * sizeof(QChar)));
+}
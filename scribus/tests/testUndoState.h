@@ -0,0 +1,31 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QtTest/QtTest>
+
+/*
+ Checks when a move may extend the previous undo state, and that the
+ memory estimate of item states includes the data they hold.
+*/
+class TestUndoState: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void mergeSameObject();
+	void mergeOtherObject();
+	void mergeOtherAction();
+	void mergeAfterInterval();
+	void mergeAfterTouch();
+	void stackMergesLastMove();
+	void stackKeepsOtherActions();
+	void stackKeepsRedo();
+	void payloadPath();
+	void payloadPathPair();
+	void payloadEffects();
+};
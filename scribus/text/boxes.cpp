@@ -16,6 +16,16 @@
 #include "colorblind.h"
 #include "textlayoutpainter.h"
 
+void Box::moveChars(int delta)
+{
+	if (m_firstChar != INT_MAX)
+		m_firstChar += delta;
+	if (m_lastChar != INT_MIN)
+		m_lastChar += delta;
+	foreach (Box *box, boxes())
+		box->moveChars(delta);
+}
+
 int GroupBox::pointToPosition(QPointF coord) const
 {
 	QPointF rel = coord - QPointF(m_x, m_y);
@@ -627,6 +637,12 @@ void GlyphBox::render(TextLayoutPainter *p) const
 	p->restore();
 }
 
+void GlyphBox::moveChars(int delta)
+{
+	Box::moveChars(delta);
+	m_glyphRun.moveChars(delta);
+}
+
 int GlyphBox::pointToPosition(QPointF coord) const
 {
 	double relX = coord.x() - m_x;
@@ -102,6 +102,8 @@ public:
 	int firstChar() const { return m_firstChar == INT_MAX ? 0 : m_firstChar; }
 	/// The last character within the box.
 	int lastChar() const { return m_lastChar == INT_MIN ? 0 : m_lastChar; }
+	/// Moves the character range of the box and its children by delta, after text was inserted or removed before it.
+	virtual void moveChars(int delta);
 
 	/// Sets the transformation matrix to applied to the box.
 	void setMatrix(QTransform x) { m_matrix = x; }
@@ -245,6 +247,8 @@ public:
 
 	const CharStyle& style() const { return m_glyphRun.style(); }
 
+	void moveChars(int delta);
+
 protected:
 	GlyphRun m_glyphRun;
 	const StyleFlag m_effects;
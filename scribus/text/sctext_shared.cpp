@@ -14,52 +14,50 @@ for which a new license (GPL+exception) is in place.
 
 #include "scribusdoc.h"
 #include "sctext_shared.h"
+#include "text/specialchars.h"
 #include "util.h"
 
-ScText_Shared::ScText_Shared(const StyleContext* pstyles) : QList<ScText*>(), 
+ScText_Shared::ScText_Shared(const StyleContext* pstyles) :
 	defaultStyle(), 
 	pstyleContext(NULL),
-	refs(1), len(0), cursorPosition(0), trailingStyle()
+	refs(1), len(0), cursorPosition(0), trailingStyle(),
+	m_lastRun(0), m_lastRunStart(0),
+	m_restyledFirst(0), m_restyledEnd(0)
 {
 	pstyleContext.setDefaultStyle( & defaultStyle );
 	defaultStyle.setContext( pstyles );
 	trailingStyle.setContext( &pstyleContext );
+	resetChanges();
 //		defaultStyle.charStyle().setContext( cstyles );
 //		qDebug() << QString("ScText_Shared() %1 %2 %3 %4").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&defaultStyle)).arg(reinterpret_cast<uint>(pstyles)).arg(reinterpret_cast<uint>(cstyles));
 }
 		
 
-ScText_Shared::ScText_Shared(const ScText_Shared& other) : QList<ScText*>(), 
+ScText_Shared::ScText_Shared(const ScText_Shared& other) :
 	defaultStyle(other.defaultStyle), 
 	pstyleContext(other.pstyleContext),
 	refs(1), len(0), cursorPosition(other.cursorPosition),
-	trailingStyle(other.trailingStyle)
+	trailingStyle(other.trailingStyle),
+	m_lastRun(0), m_lastRunStart(0),
+	m_restyledFirst(0), m_restyledEnd(0)
 {
 	pstyleContext.setDefaultStyle( &defaultStyle );
 	trailingStyle.setContext( &pstyleContext );
-	QListIterator<ScText*> it( other );
-	ScText* elem;
-	while ( it.hasNext() ) {
-		elem = it.next();
-		ScText* elem2 = new ScText(*elem);
-		append(elem2);
-		if (elem2->parstyle) {
-			elem2->parstyle->setContext( & pstyleContext);
-//				elem2->parstyle->charStyle().setContext( defaultStyle.charStyleContext() );
-			replaceCharStyleContextInParagraph(count()-1, elem2->parstyle->charStyleContext());
-		}
-	}
-	len = count();
-	replaceCharStyleContextInParagraph(len,  trailingStyle.charStyleContext() );
+	copyRuns(other);
+	resetChanges();
 //		qDebug() << QString("ScText_Shared(%2) %1").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&other));
 }
 
 void ScText_Shared::clear()
 {
-	while(!this->isEmpty())
-		delete this->takeFirst(); 
-	QList<ScText*>::clear();
+	qDeleteAll(runs);
+	runs.clear();
+	text.clear();
+	flags.clear();
+	len = 0;
 	cursorPosition = 0;
+	m_lastRun = m_lastRunStart = 0;
+	m_restyledFirst = m_restyledEnd = 0;
 }
 
 ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other) 
@@ -73,37 +71,245 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 		defaultStyle.setContext( other.defaultStyle.context() );
 		trailingStyle.setContext( &pstyleContext );
 		clear();
-		QListIterator<ScText*> it( other );
-		ScText* elem;
-		while ( it.hasNext() ) {
-			elem = it.next();
-			ScText* elem2 = new ScText(*elem);
-			append(elem2);
-			if (elem2->parstyle) {
-				elem2->parstyle->setContext( & pstyleContext );
-//					qDebug() << QString("StoryText::copy: * %1 align=%2").arg(elem2->parstyle->parent())
-//						   .arg(elem2->parstyle->alignment())
-//						   .arg((uint)elem2->parstyle->context()));
-					//				elem2->parstyle->charStyle().setContext( defaultStyle.charStyleContext());
-				replaceCharStyleContextInParagraph(count()-1, elem2->parstyle->charStyleContext());
-			}
-		}
-		len = count();
+		copyRuns(other);
 		cursorPosition = other.cursorPosition;
 		pstyleContext.invalidate();
 //			qDebug() << QString("StoryText::copy: %1 align=%2 %3").arg(trailingStyle.parentStyle()->name())
 //				   .arg(trailingStyle.alignment()).arg((uint)trailingStyle.context());
-		replaceCharStyleContextInParagraph(len,  trailingStyle.charStyleContext());
+		resetChanges();
 	}
 //			qDebug() << QString("ScText_Shared: %1 = %2").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&other));
 	return *this;
 }
 
+/**
+	Copies text and runs of other, the copied paragraph styles use our
+	pstyleContext and the runs look up their defaults in them.
+	*/
+void ScText_Shared::copyRuns(const ScText_Shared& other)
+{
+	text = other.text;
+	flags = other.flags;
+	len = text.length();
+	const StyleContext* context = trailingStyle.charStyleContext();
+	for (int i = other.runs.count() - 1; i >= 0; --i)
+	{
+		ScTextRun* run = new ScTextRun(*other.runs.at(i));
+		if (run->parstyle)
+		{
+			run->parstyle->setContext( & pstyleContext );
+			context = run->parstyle->charStyleContext();
+		}
+		run->setContext(context);
+		runs.prepend(run);
+	}
+	m_lastRun = m_lastRunStart = 0;
+}
+
+void ScText_Shared::resetChanges()
+{
+	changes.clear();
+	changesSince = nextChangeSerial();
+	changeLength = len;
+	m_restyledFirst = m_restyledEnd = 0;
+}
+
+uint ScText_Shared::nextChangeSerial()
+{
+	static uint serial = 0;
+	return ++serial;
+}
+
 ScText_Shared::~ScText_Shared() 
 {
 //		qDebug() << QString("~ScText_Shared() %1").arg(reinterpret_cast<uint>(this));
-	while(!this->isEmpty())
-		delete this->takeFirst(); 
+	qDeleteAll(runs);
+}
+
+int ScText_Shared::runAt(int pos, int* runStart) const
+{
+	assert (pos >= 0);
+	assert (pos < static_cast<int>(len));
+
+	// layout and most edits walk through the text, so start at the last run found
+	int run = m_lastRun;
+	int start = m_lastRunStart;
+	if (run >= runs.count() || pos < start - pos)
+	{
+		run = 0;
+		start = 0;
+	}
+	while (pos < start)
+		start -= runs.at(--run)->length;
+	while (pos >= start + runs.at(run)->length)
+		start += runs.at(run++)->length;
+	m_lastRun = run;
+	m_lastRunStart = start;
+	if (runStart)
+		*runStart = start;
+	return run;
+}
+
+int ScText_Shared::startOfRun(int run) const
+{
+	int i = 0;
+	int start = 0;
+	if (m_lastRun <= run && m_lastRun < runs.count())
+	{
+		i = m_lastRun;
+		start = m_lastRunStart;
+	}
+	for (; i < run; ++i)
+		start += runs.at(i)->length;
+	return start;
+}
+
+bool ScText_Shared::endsParagraph(int run, int runStart) const
+{
+	return text.at(runStart + runs.at(run)->length - 1) == SpecialChars::PARSEP;
+}
+
+bool ScText_Shared::isObjectRun(int run, int runStart) const
+{
+	return text.at(runStart) == SpecialChars::OBJECT;
+}
+
+void ScText_Shared::restyled(int first, int end)
+{
+	if (m_restyledFirst >= m_restyledEnd)
+	{
+		m_restyledFirst = first;
+		m_restyledEnd = end;
+	}
+	else
+	{
+		m_restyledFirst = qMin(m_restyledFirst, first);
+		m_restyledEnd = qMax(m_restyledEnd, end);
+	}
+}
+
+bool ScText_Shared::takeRestyledRange(int& first, int& end)
+{
+	if (m_restyledFirst >= m_restyledEnd)
+		return false;
+	first = m_restyledFirst;
+	end = m_restyledEnd;
+	m_restyledFirst = m_restyledEnd = 0;
+	return true;
+}
+
+int ScText_Shared::splitRun(int pos)
+{
+	if (pos >= static_cast<int>(len))
+		return runs.count();
+	int start;
+	int run = runAt(pos, &start);
+	if (start == pos)
+		return run;
+
+	// the parsep goes with the second half
+	ScTextRun* left = runs.at(run);
+	ParagraphStyle* parstyle = left->parstyle;
+	left->parstyle = NULL;
+	ScTextRun* right = new ScTextRun(*left);
+	right->setContext(left->context());
+	right->parstyle = parstyle;
+	right->length = start + left->length - pos;
+	left->length = pos - start;
+	runs.insert(run + 1, right);
+	restyled(pos, pos + right->length);
+
+	m_lastRun = run + 1;
+	m_lastRunStart = pos;
+	return run + 1;
+}
+
+void ScText_Shared::mergeRuns(int first, int last)
+{
+	m_lastRun = m_lastRunStart = 0;
+	first = qMax(first, 0);
+	last = qMin(last, runs.count() - 2);
+	if (first > last)
+		return;
+
+	int start = startOfRun(last);
+	for (int i = last; i >= first; --i)
+	{
+		ScTextRun* run = runs.at(i);
+		ScTextRun* next = runs.at(i + 1);
+		int nextStart = start + run->length;
+		// compare contexts first, removeChars() may leave stale ones until the paragraph is fixed
+		if (!endsParagraph(i, start) && !isObjectRun(i, start) && !isObjectRun(i + 1, nextStart)
+			&& run->context() == next->context() && *run == *next)
+		{
+			restyled(nextStart, nextStart + next->length);
+			run->length += next->length;
+			run->parstyle = next->parstyle;
+			next->parstyle = NULL;
+			delete runs.takeAt(i + 1);
+		}
+		if (i > first)
+			start -= runs.at(i - 1)->length;
+	}
+}
+
+void ScText_Shared::insertChars(int pos, const QString& txt, const CharStyle& style)
+{
+	assert (pos >= 0);
+	assert (pos <= static_cast<int>(len));
+
+	if (txt.isEmpty())
+		return;
+
+	int run = splitRun(pos);
+	int first = run;
+	int runStart = 0;
+	for (int i = 0; i < txt.length(); ++i)
+	{
+		// a parsep ends its run, objects get one of their own
+		QChar ch = txt.at(i);
+		if (i + 1 < txt.length() && ch != SpecialChars::PARSEP && ch != SpecialChars::OBJECT
+			&& txt.at(i + 1) != SpecialChars::OBJECT)
+			continue;
+		ScTextRun* newRun = new ScTextRun();
+		static_cast<CharStyle&>(*newRun) = style;
+		newRun->setContext(style.context());
+		newRun->length = i + 1 - runStart;
+		runs.insert(run++, newRun);
+		runStart = i + 1;
+	}
+	text.insert(pos, txt);
+	flags.insert(pos, txt.length(), 0);
+	len = text.length();
+
+	if (m_restyledFirst >= pos)
+		m_restyledFirst += txt.length();
+	if (m_restyledEnd > pos)
+		m_restyledEnd += txt.length();
+	mergeRuns(first - 1, run - 1);
+}
+
+void ScText_Shared::removeChars(int pos, int count)
+{
+	assert (pos >= 0);
+	assert (pos + count <= static_cast<int>(len));
+
+	if (count <= 0)
+		return;
+
+	int first = splitRun(pos);
+	int last = splitRun(pos + count);
+	for (int i = last - 1; i >= first; --i)
+		delete runs.takeAt(i);
+	text.remove(pos, count);
+	flags.remove(pos, count);
+	len = text.length();
+
+	if (m_restyledFirst > pos)
+		m_restyledFirst = qMax(pos, m_restyledFirst - count);
+	if (m_restyledEnd > pos)
+		m_restyledEnd = qMax(pos, m_restyledEnd - count);
+	mergeRuns(first - 1, first - 1);
 }
 
 /**
@@ -114,48 +320,41 @@ ScText_Shared::~ScText_Shared()
 void ScText_Shared::replaceCharStyleContextInParagraph(int pos, const StyleContext* newContext)
 {
 	assert (pos >= 0);
-	assert (pos <= size());
-	
-	if (pos < size())
-		value(pos)->setContext(newContext);
-	for (int i=pos-1; i >=0 ; --i ) 
+	assert (pos <= static_cast<int>(len));
+
+	// pos is the paragraph's parsep or the end of the text, so its run is the paragraph's last one
+	int start = len;
+	int last = (pos < static_cast<int>(len)) ? runAt(pos, &start) : runs.count();
+	if (last < runs.count())
+		runs.at(last)->setContext(newContext);
+	int first = last;
+	while (first > 0)
 	{
-		if ( (at(i)->ch) == SpecialChars::PARSEP)
+		start -= runs.at(first - 1)->length;
+		if (endsParagraph(first - 1, start))
 			break;
-		value(i)->setContext(newContext);
+		--first;
+		runs.at(first)->setContext(newContext);
 	}
+	mergeRuns(first, last - 1);
 #ifndef NDEBUG // skip assertions if we aren't debugging
 	// we are done here but will do a sanity check:
-	// assert that all chars point to the following parstyle
-	QListIterator<ScText*> it( *this );
-	const StyleContext* lastContext = NULL;
-	while ( it.hasNext() ) {
-		ScText* elem = it.next();
-		assert( elem );
-		if ( elem->ch.isNull() ) 
-		{
-			// nothing, see code in removeParSep
-		}
-		else if (elem->ch == SpecialChars::PARSEP)
-		{
-			assert( elem->parstyle );
-			if ( lastContext )
-			{
-				assert( lastContext == elem->parstyle->charStyleContext() );
-			}
-			lastContext = NULL;
-		}
-		else if (lastContext == NULL)
-		{
-			lastContext = elem->context();
-		}
-		else 
+	// assert that all runs point to the following parstyle
+	const StyleContext* lastContext = trailingStyle.charStyleContext();
+	int runStart = len;
+	for (int i = runs.count() - 1; i >= 0; --i)
+	{
+		ScTextRun* run = runs.at(i);
+		assert( run && run->length > 0 );
+		runStart -= run->length;
+		if (endsParagraph(i, runStart))
 		{
-			assert( lastContext == elem->context() );
+			assert( run->parstyle );
+			lastContext = run->parstyle->charStyleContext();
 		}
+		assert( lastContext == run->context() );
 	}
-	if ( lastContext )
-		assert( lastContext == trailingStyle.charStyleContext() );
+	assert( runStart == 0 );
 #endif
 }
 
@@ -4,17 +4,37 @@
 #include <QList>
 #include <QObject>
 #include <QString>
+#include <QVector>
 #include <cassert>
 
 //#include "text/paragraphlayout.h"
 #include "text/frect.h"
+#include "sctextstruct.h"
 #include "style.h"
 #include "styles/charstyle.h"
 #include "styles/paragraphstyle.h"
 #include "styles/stylecontextproxy.h"
 
 
-class SCRIBUS_API ScText_Shared : public QList<ScText*>
+/**
+   A modification of the text: characters [start, end) are new or changed,
+   and the text grew by delta characters (shrank if negative).
+ */
+struct TextChange
+{
+	uint serial;
+	int start;
+	int end;
+	int delta;
+};
+
+
+/**
+   The shared content of StoryText objects. The characters are kept in one
+   string, the styles in a list of runs covering it (see ScTextRun), so a
+   character costs a QChar and its layout flags instead of a full CharStyle.
+ */
+class SCRIBUS_API ScText_Shared
 {
 public:
 	ParagraphStyle defaultStyle;
@@ -23,6 +43,19 @@ public:
 	uint len;
 	uint cursorPosition;
 	ParagraphStyle trailingStyle;
+	/// the characters of the story
+	QString text;
+	/// the non user style flags (ScLayout_*) of each character
+	QVector<ushort> flags;
+	/// the style runs, in text order
+	QList<ScTextRun*> runs;
+	/// most recent modifications, oldest first
+	QList<TextChange> changes;
+	static const int MaxChanges = 256;
+	/// all modifications after this serial are listed in changes
+	uint changesSince;
+	/// length of the text after the last listed modification
+	uint changeLength;
 	ScText_Shared(const StyleContext* pstyles);	
 
 	ScText_Shared(const ScText_Shared& other);
@@ -32,6 +65,33 @@ public:
 	~ScText_Shared();
 
 	void clear();
+
+	/// forget the modification history, used when the whole content is replaced
+	void resetChanges();
+	/// serial numbers are unique over all stories
+	static uint nextChangeSerial();
+
+	/// index of the run containing pos, runStart is set to the position of its first char
+	int runAt(int pos, int* runStart = NULL) const;
+	/// position of the first char of the run with this index
+	int startOfRun(int run) const;
+	/// the run containing pos
+	ScTextRun* runOf(int pos) const { return runs.at(runAt(pos)); }
+
+	/**
+	   Inserts txt at pos, all chars get style. Paragraph styles of new
+	   PARSEPs are left to the caller.
+	 */
+	void insertChars(int pos, const QString& txt, const CharStyle& style);
+	/**
+	   Removes len chars at pos. If PARSEPs were removed, the caller has to
+	   move the runs of the joined paragraph to its style context.
+	 */
+	void removeChars(int pos, int len);
+	/// lets a run begin at pos and returns its index, runs.count() for the end of the text
+	int splitRun(int pos);
+	/// joins the runs with index first to last with their successors where the style allows it
+	void mergeRuns(int first, int last);
 	
 	/**
 	   A char's stylecontext is the containing paragraph's style, 
@@ -39,6 +99,25 @@ public:
 	   in the parstyle first.
 	 */
 	void replaceCharStyleContextInParagraph(int pos, const StyleContext* newContext);
+
+	/**
+	   Returns the chars whose run was split off or merged into another one
+	   since the last call. Layouts keep pointers to run styles, so these
+	   chars have to be treated as modified.
+	 */
+	bool takeRestyledRange(int& first, int& end);
+
+private:
+	void copyRuns(const ScText_Shared& other);
+	bool endsParagraph(int run, int runStart) const;
+	bool isObjectRun(int run, int runStart) const;
+	void restyled(int first, int end);
+
+	/// last run found by runAt(), consecutive lookups start there
+	mutable int m_lastRun;
+	mutable int m_lastRunStart;
+	int m_restyledFirst;
+	int m_restyledEnd;
 };
 
 #endif /*SCTEXT_SHARED_H*/
@@ -220,7 +220,7 @@ int StoryText::indexOf(const QString &str, int from, Qt::CaseSensitivity cs) con
 			int index = 0;
 			while ((index < strLen) && ((index + i) < storyLen))
 			{
-				if (qStr.at(index) != d->at(index + i)->ch)
+				if (qStr.at(index) != d->text.at(index + i))
 					break;
 				++index;
 			}
@@ -240,7 +240,7 @@ int StoryText::indexOf(const QString &str, int from, Qt::CaseSensitivity cs) con
 			int index = 0;
 			while ((index < strLen) && ((index + i) < storyLen))
 			{
-				if (qStr.at(index) != d->at(index + i)->ch.toLower())
+				if (qStr.at(index) != d->text.at(index + i).toLower())
 					break;
 				++index;
 			}
@@ -265,7 +265,7 @@ int StoryText::indexOf(QChar ch, int from, Qt::CaseSensitivity cs) const
 	{
 		for (int i = from; i < textLength; ++i)
 		{
-			if (d->at(i)->ch == ch)
+			if (d->text.at(i) == ch)
 			{
 				foundIndex = i;
 				break;
@@ -276,7 +276,7 @@ int StoryText::indexOf(QChar ch, int from, Qt::CaseSensitivity cs) const
 	{
 		for (int i = from; i < textLength; ++i)
 		{
-			if (d->at(i)->ch.toLower() == ch)
+			if (d->text.at(i).toLower() == ch)
 			{
 				foundIndex = i;
 				break;
@@ -360,7 +360,7 @@ void StoryText::insert(int pos, const StoryText& other, bool onlySelection)
  */
 void StoryText::insertParSep(int pos)
 {
-	ScText* it = item(pos);
+	ScTextRun* it = item(pos);
 	if (!it->parstyle) {
 		it->parstyle = new ParagraphStyle(paragraphStyle(pos+1));
 		it->parstyle->setContext( & d->pstyleContext);
@@ -376,25 +376,6 @@ void StoryText::insertParSep(int pos)
 	}
 	d->replaceCharStyleContextInParagraph(pos, it->parstyle->charStyleContext());
 }
-/**
-     need to remove the ParagraphStyle structure and replace all pointers
-     to it...
- */
-void StoryText::removeParSep(int pos)
-{
-	ScText* it = item(pos);
-	if (it->parstyle) {
-//		const CharStyle* oldP = & it->parstyle->charStyle();
-//		const CharStyle* newP = & that->paragraphStyle(pos+1).charStyle();
-//		d->replaceParentStyle(pos, oldP, newP);
-		delete it->parstyle;
-		it->parstyle = 0;
-	}
-	// demote this parsep so the assert code in replaceCharStyleContextInParagraph()
-	// doesn't choke:
-	it->ch = 0;
-	d->replaceCharStyleContextInParagraph(pos, paragraphStyle(pos+1).charStyleContext());
-}
 
 void StoryText::removeChars(int pos, uint len)
 {
@@ -410,14 +391,18 @@ void StoryText::removeChars(int pos, uint len)
 	if (pos + static_cast<int>(len) > length())
 		len = length() - pos;
 
+	int parsep = d->text.indexOf(SpecialChars::PARSEP, pos);
+	bool removedParSep = (parsep >= 0) && (parsep < pos + static_cast<int>(len));
+	d->removeChars(pos, len);
+	// the removed paragraph styles are gone, let the joined paragraph use the following one
+	if (removedParSep)
+	{
+		parsep = d->text.indexOf(SpecialChars::PARSEP, pos);
+		d->replaceCharStyleContextInParagraph(parsep < 0 ? length() : parsep, paragraphStyle(pos).charStyleContext());
+	}
+
 	for ( int i=pos + static_cast<int>(len) - 1; i >= pos; --i )
 	{
-		ScText *it = d->at(i);
-		if ((it->ch == SpecialChars::PARSEP))
-			removeParSep(i);
-		d->takeAt(i);
-		d->len--;
-		delete it;
 		// #9592 : adjust m_selFirst and m_selLast, those values have to be
 		// consistent in functions such as select()
 		if (i <= m_selLast)
@@ -428,14 +413,17 @@ void StoryText::removeChars(int pos, uint len)
 			d->cursorPosition -= 1;
 	}
 
-	d->len = d->count();
 	d->cursorPosition = qMin(d->cursorPosition, d->len);
 	if (m_selFirst > m_selLast)
 	{
 		m_selFirst =  0;
 		m_selLast  = -1;
 	}
-	invalidate(pos, length());
+	// only the paragraph that was joined with the next one changes its style
+	if (removedParSep)
+		invalidate(prevParagraph(pos), qMin(nextParagraph(pos) + 1, length()));
+	else
+		invalidate(pos, pos);
 }
 
 void StoryText::trim()
@@ -446,8 +434,8 @@ void StoryText::trim()
 	int pos = static_cast<int>(length()) - 1;
 	for ( int i = static_cast<int>(length()) - 1; i >= 0; --i )
 	{
-		ScText *it = d->at(i);
-		if ((it->ch == SpecialChars::PARSEP) || (it->ch.isSpace()))
+		QChar ch = d->text.at(i);
+		if ((ch == SpecialChars::PARSEP) || (ch.isSpace()))
 		{
 			pos--;
 			posCount++;
@@ -480,33 +468,40 @@ void StoryText::insertChars(int pos, QString txt, bool applyNeighbourStyle) //,
 	if (txt.length() == 0)
 		return;
 	
-	const StyleContext* cStyleContext = paragraphStyle(pos).charStyleContext();
-
-	ScText clone;
+	CharStyle clone;
 	if (applyNeighbourStyle)
 	{
 		int referenceChar = qMax(0, qMin(pos, length()-1));
 		clone.applyCharStyle(charStyle(referenceChar));
 		clone.setEffects(ScStyle_Default);
 	}
+	clone.setContext(paragraphStyle(pos).charStyleContext());
 
-	for (int i = 0; i < txt.length(); ++i) {
-		ScText * item = new ScText(clone);
-		item->ch= txt.at(i);
-		item->setContext(cStyleContext);
-		d->insert(pos + i, item);
-		d->len++;
-		if (item->ch == SpecialChars::PARSEP) {
-//			qDebug() << QString("new PARSEP %2 at %1").arg(pos).arg(paragraphStyle(pos).name());
-			insertParSep(pos + i);
-		}
-		if (d->cursorPosition >= static_cast<uint>(pos + i)) {
-			d->cursorPosition += 1;
+	insertCharsWithStyle(pos, txt, clone);
+	invalidate(pos, pos + txt.length());
+}
+
+/**
+    Inserts txt one paragraph at a time, so that each new paragraph style is
+    created from the text following it, as when typing.
+ */
+void StoryText::insertCharsWithStyle(int pos, const QString& txt, const CharStyle& style)
+{
+	int start = 0;
+	while (start < txt.length())
+	{
+		int parsep = txt.indexOf(SpecialChars::PARSEP, start);
+		int end = (parsep < 0) ? txt.length() : parsep + 1;
+		d->insertChars(pos + start, txt.mid(start, end - start), style);
+		if (parsep >= 0)
+		{
+//			qDebug() << QString("new PARSEP %2 at %1").arg(pos + parsep).arg(paragraphStyle(pos + parsep).name());
+			insertParSep(pos + parsep);
 		}
+		start = end;
 	}
-
-	d->len = d->count();
-	invalidate(pos, pos + txt.length());
+	if (d->cursorPosition >= static_cast<uint>(pos))
+		d->cursorPosition += txt.length();
 }
 
 void StoryText::insertCharsWithSoftHyphens(int pos, QString txt, bool applyNeighbourStyle)
@@ -520,50 +515,43 @@ void StoryText::insertCharsWithSoftHyphens(int pos, QString txt, bool applyNeigh
 	if (txt.length() == 0)
 		return;
 	
-	const StyleContext* cStyleContext = paragraphStyle(pos).charStyleContext();
-
-	ScText clone;
+	CharStyle clone;
 	if (applyNeighbourStyle)
 	{
 		int referenceChar = qMax(0, qMin(pos, length()-1));
 		clone.applyCharStyle(charStyle(referenceChar));
 		clone.setEffects(ScStyle_Default);
 	}
+	clone.setContext(paragraphStyle(pos).charStyleContext());
 
-	int inserted = 0;
+	QString chars;
+	QVector<ushort> charFlags;
 	for (int i = 0; i < txt.length(); ++i) 
 	{
 		QChar ch = txt.at(i);
-		int  index  = pos + inserted;
 		bool insert = true; 
-		if (ch == SpecialChars::SHYPHEN && index > 0) {
-			ScText* lastItem = this->item(index - 1);
+		if (ch == SpecialChars::SHYPHEN && pos + chars.length() > 0) {
+			ushort& lastFlags = chars.isEmpty() ? d->flags[pos - 1] : charFlags.last();
 			// qreal SHY means user provided SHY, single SHY is automatic one
-			if (lastItem->effects() & ScStyle_HyphenationPossible)
-				lastItem->setEffects(lastItem->effects() & ~ScStyle_HyphenationPossible);
+			if (lastFlags & ScLayout_HyphenationPossible)
+				lastFlags &= ~ScLayout_HyphenationPossible;
 			else
 			{
-				lastItem->setEffects(lastItem->effects() | ScStyle_HyphenationPossible);
+				lastFlags |= ScLayout_HyphenationPossible;
 				insert = false;
 			}
 		}
 		if (insert)
 		{
-			ScText * item = new ScText(clone);
-			item->ch = ch;
-			item->setContext(cStyleContext);
-			d->insert(index, item);
-			d->len++;
-			if (item->ch == SpecialChars::PARSEP)
-				insertParSep(index);
-			if (d->cursorPosition >= static_cast<uint>(index))
-				d->cursorPosition += 1;
-			++inserted;
+			chars += ch;
+			charFlags.append(0);
 		}
 	}
 
-	d->len = d->count();
-	invalidate(pos, pos + inserted);
+	insertCharsWithStyle(pos, chars, clone);
+	for (int i = 0; i < charFlags.count(); ++i)
+		d->flags[pos + i] = charFlags.at(i);
+	invalidate(pos, pos + chars.length());
 }
 
 void StoryText::replaceChar(int pos, QChar ch)
@@ -574,17 +562,29 @@ void StoryText::replaceChar(int pos, QChar ch)
 	assert(pos >= 0);
 	assert(pos < length());
 
-	ScText* item = d->at(pos);
-	if (item->ch == ch)
+	QChar old = d->text.at(pos);
+	if (old == ch)
 		return;
 	
-	if (d->at(pos)->ch == SpecialChars::PARSEP) {
-		removeParSep(pos);
-	}
-	item->ch = ch;
-	if (d->at(pos)->ch == SpecialChars::PARSEP) {
-		insertParSep(pos);
+	if (old == SpecialChars::PARSEP || old == SpecialChars::OBJECT
+		|| ch == SpecialChars::PARSEP || ch == SpecialChars::OBJECT)
+	{
+		// these chars start or end a run, so replace the char with its run
+		CharStyle style(*item(pos));
+		d->removeChars(pos, 1);
+		const StyleContext* cStyleContext = paragraphStyle(pos).charStyleContext();
+		if (old == SpecialChars::PARSEP)
+		{
+			int parsep = d->text.indexOf(SpecialChars::PARSEP, pos);
+			d->replaceCharStyleContextInParagraph(parsep < 0 ? length() : parsep, cStyleContext);
+		}
+		style.setContext(cStyleContext);
+		int cursor = d->cursorPosition;
+		insertCharsWithStyle(pos, QString(ch), style);
+		d->cursorPosition = cursor;
 	}
+	else
+		d->text[pos] = ch;
 	
 	invalidate(pos, pos + 1);
 }
@@ -633,13 +633,13 @@ void StoryText::hyphenateWord(int pos, uint len, char* hyphens)
 //	QString dump("");
 	for (int i=pos; i < pos+signed(len); ++i)
 	{
-//		dump += d->at(i)->ch;
+//		dump += d->text.at(i);
 		if (hyphens && hyphens[i-pos] & 1) {
-			d->at(i)->setEffects(d->at(i)->effects() | ScStyle_HyphenationPossible);
+			d->flags[i] |= ScLayout_HyphenationPossible;
 //			dump += "-";
 		}
 		else {
-			d->at(i)->setEffects(d->at(i)->effects() & ~ScStyle_HyphenationPossible);
+			d->flags[i] &= ~ScLayout_HyphenationPossible;
 		}
 	}
 //	qDebug() << QString("st: %1").arg(dump);
@@ -657,7 +657,7 @@ void StoryText::insertObject(int pos, int ob)
 		pos += length()+1;
 
 	insertChars(pos, SpecialChars::OBJECT);
-	const_cast<StoryText *>(this)->d->at(pos)->embedded = ob;
+	item(pos)->embedded = ob;
 	m_doc->FrameItems[ob]->isEmbedded = true;   // this might not be enough...
 	m_doc->FrameItems[ob]->OwnPage = -1; // #10379: OwnPage is not meaningful for inline object
 }
@@ -670,7 +670,7 @@ void StoryText::insertMark(Mark* Mark, int pos)
 		pos = d->cursorPosition;
 
 	insertChars(pos, SpecialChars::OBJECT, false);
-	const_cast<StoryText *>(this)->d->at(pos)->mark = Mark;
+	item(pos)->mark = Mark;
 }
 
 void StoryText::replaceObject(int pos, int ob)
@@ -679,7 +679,7 @@ void StoryText::replaceObject(int pos, int ob)
 		pos += length()+1;
 
 	replaceChar(pos, SpecialChars::OBJECT);
-	const_cast<StoryText *>(this)->d->at(pos)->embedded = ob;
+	item(pos)->embedded = ob;
 	m_doc->FrameItems[ob]->isEmbedded = true;   // this might not be enough...
 	m_doc->FrameItems[ob]->OwnPage = -1; // #10379: OwnPage is not meaningful for inline object
 }
@@ -695,20 +695,8 @@ QString StoryText::plainText() const
 	if (length() <= 0)
 		return QString();
 
-	QChar   ch;
-	QString result;
-
-	int len = length();
-	result.reserve(len);
-
-	StoryText* that(const_cast<StoryText*>(this));
-	for (int i = 0; i < len; ++i) {
-		ch = that->d->at(i)->ch;
-		if (ch == SpecialChars::PARSEP)
-			ch = QLatin1Char('\n');
-		result += ch;
-	}
-
+	QString result(d->text);
+	result.replace(SpecialChars::PARSEP, QLatin1Char('\n'));
 	return result;
 }
 
@@ -725,7 +713,7 @@ QChar StoryText::text(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return const_cast<StoryText *>(this)->d->at(pos)->ch;
+	return d->text.at(pos);
 }
 
 QString StoryText::text(int pos, uint len) const
@@ -736,13 +724,7 @@ QString StoryText::text(int pos, uint len) const
 	assert(pos >= 0);
 	assert(pos + signed(len) <= length());
 
-	QString result;
-	StoryText* that(const_cast<StoryText*>(this));
-	for (int i = pos; i < pos+signed(len); ++i) {
-		result += that->d->at(i)->ch;
-	}
-
-	return result;
+	return d->text.mid(pos, len);
 }
 
 QString StoryText::sentence(int pos, int &posn)
@@ -761,7 +743,7 @@ QString StoryText::textWithSoftHyphens(int pos, uint len) const
 	len = qMin((uint) (length() - pos), len);
 	for (int i = pos; i < pos+signed(len); ++i)
 	{
-		if (this->charStyle(i).effects() & ScStyle_HyphenationPossible 
+		if ((d->flags.at(i) & ScLayout_HyphenationPossible)
 			// duplicate SHYPHEN if already present to indicate a user provided SHYPHEN:
 			|| this->text(i) == SpecialChars::SHYPHEN)
 		{
@@ -783,9 +765,8 @@ bool StoryText::hasObject(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	StoryText* that = const_cast<StoryText *>(this);
-	if (that->d->at(pos)->ch == SpecialChars::OBJECT)
-		return that->d->at(pos)->hasObject(m_doc);
+	if (d->text.at(pos) == SpecialChars::OBJECT)
+		return item(pos)->hasObject(m_doc);
 	return false;
 }
 
@@ -797,8 +778,7 @@ PageItem* StoryText::object(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	StoryText* that = const_cast<StoryText *>(this);
-	return that->d->at(pos)->getItem(m_doc);
+	return d->runOf(pos)->getItem(m_doc);
 }
 
 bool StoryText::hasMark(int pos, Mark* mrk) const
@@ -809,9 +789,8 @@ bool StoryText::hasMark(int pos, Mark* mrk) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	StoryText* that = const_cast<StoryText *>(this);
-	if (that->d->at(pos)->ch == SpecialChars::OBJECT)
-        return that->d->at(pos)->hasMark(mrk);
+	if (d->text.at(pos) == SpecialChars::OBJECT)
+		return item(pos)->hasMark(mrk);
 	return false;
 }
 
@@ -823,8 +802,9 @@ Mark* StoryText::mark(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	StoryText* that = const_cast<StoryText *>(this);
-	return that->d->at(pos)->mark;
+	if (d->text.at(pos) != SpecialChars::OBJECT)
+		return NULL;
+	return item(pos)->mark;
 }
 
 
@@ -836,7 +816,7 @@ void StoryText::replaceMark(int pos, Mark* mrk)
     assert(pos >= 0);
     assert(pos < length());
 
-    this->d->at(pos)->mark = mrk;
+    item(pos)->mark = mrk;
 }
 
 
@@ -848,8 +828,7 @@ LayoutFlags StoryText::flags(int pos) const
 	assert(pos >= 0);
     assert(pos < length());
 
-    StoryText* that = const_cast<StoryText *>(this);
-	return  static_cast<LayoutFlags>((*that->d->at(pos)).effects().value & ScStyle_NonUserStyles);
+	return static_cast<LayoutFlags>(d->flags.at(pos) & ScStyle_NonUserStyles);
 }
 
 bool StoryText::hasFlag(int pos, LayoutFlags flags) const
@@ -861,7 +840,7 @@ bool StoryText::hasFlag(int pos, LayoutFlags flags) const
     assert(pos < length());
     assert((flags & ScStyle_UserStyles) == ScStyle_None);
 
-	return (flags & d->at(pos)->effects().value) == flags;
+	return (flags & d->flags.at(pos)) == flags;
 }
 
 void StoryText::setFlag(int pos, LayoutFlags flags)
@@ -873,7 +852,7 @@ void StoryText::setFlag(int pos, LayoutFlags flags)
     assert(pos < length());
     assert((flags & ScStyle_UserStyles) == ScStyle_None);
 
-	d->at(pos)->setEffects(flags | d->at(pos)->effects().value);
+	d->flags[pos] |= flags;
 }
 
 void StoryText::clearFlag(int pos, LayoutFlags flags)
@@ -884,7 +863,7 @@ void StoryText::clearFlag(int pos, LayoutFlags flags)
     assert(pos >= 0);
     assert(pos < length());
 
-	d->at(pos)->setEffects(~(flags & ScStyle_NonUserStyles) & d->at(pos)->effects().value);
+	d->flags[pos] &= ~(flags & ScStyle_NonUserStyles);
 }
 
 
@@ -911,8 +890,7 @@ const CharStyle & StoryText::charStyle(int pos) const
 	}
 	if (text(pos) == SpecialChars::PARSEP)
 		return paragraphStyle(pos).charStyle();
-	StoryText* that = const_cast<StoryText *>(this);
-	return dynamic_cast<const CharStyle &> (*that->d->at(pos));
+	return *item(pos);
 }
 
 const ParagraphStyle & StoryText::paragraphStyle() const
@@ -935,14 +913,12 @@ const ParagraphStyle & StoryText::paragraphStyle(int pos) const
 //	assert( that->at(pos)->cab < doc->docParagraphStyles.count() );
 //	return doc->docParagraphStyles[that->at(pos)->cab];
 	
-	while (pos < length() && that->d->at(pos)->ch != SpecialChars::PARSEP) {
-		++pos;
-	}
-	if (pos >= length()) {
+	pos = d->text.indexOf(SpecialChars::PARSEP, pos);
+	if (pos < 0) {
 		return that->d->trailingStyle;
 	}
-	else if ( !that->d->at(pos)->parstyle ) {
-		ScText* current = that->d->at(pos);
+	ScTextRun* current = that->item(pos);
+	if ( !current->parstyle ) {
 		qDebug("inserting default parstyle at %i", pos);
 		current->parstyle = new ParagraphStyle();
 		current->parstyle->setContext( & d->pstyleContext);
@@ -953,8 +929,8 @@ const ParagraphStyle & StoryText::paragraphStyle(int pos) const
 	else {
 //		qDebug() << QString("using parstyle at %1").arg(pos);
 	}
-	assert (that->d->at(pos)->parstyle);
-	return *that->d->at(pos)->parstyle;
+	assert (current->parstyle);
+	return *current->parstyle;
 }
 
 const ParagraphStyle& StoryText::defaultStyle() const
@@ -998,9 +974,11 @@ void StoryText::applyCharStyle(int pos, uint len, const CharStyle& style )
 		return;
 
 //	int lastParStart = pos == 0? 0 : -1;
-	ScText* itText;
-	for (uint i=pos; i < pos+len; ++i) {
-		itText = d->at(i);
+	int first = d->splitRun(pos);
+	int last = d->splitRun(pos + len);
+	ScTextRun* itText;
+	for (int i=first; i < last; ++i) {
+		itText = d->runs.at(i);
 		// #6165 : applying style on last character applies style on whole text on next open 
 		/*if (itText->ch == SpecialChars::PARSEP && itText->parstyle != NULL)
 			itText->parstyle->charStyle().applyCharStyle(style);*/
@@ -1021,6 +999,7 @@ void StoryText::applyCharStyle(int pos, uint len, const CharStyle& style )
 		eraseCharStyle(lastParStart, length() - lastParStart, style);
 		d->trailingStyle.charStyle().applyCharStyle(style);
 	}*/
+	d->mergeRuns(first - 1, last - 1);
 	
 	invalidate(pos, pos + len);
 }
@@ -1038,14 +1017,17 @@ void StoryText::eraseCharStyle(int pos, uint len, const CharStyle& style )
 	if (len == 0)
 		return;
 	
-	ScText* itText;
-	for (uint i=pos; i < pos+len; ++i) {
-		itText = d->at(i);
+	int first = d->splitRun(pos);
+	int last = d->splitRun(pos + len);
+	ScTextRun* itText;
+	for (int i=first; i < last; ++i) {
+		itText = d->runs.at(i);
 		// FIXME?? see #6165 : should we really erase charstyle of paragraph style??
-		if (itText->ch == SpecialChars::PARSEP && itText->parstyle != NULL)
+		if (itText->parstyle != NULL)
 			itText->parstyle->charStyle().eraseCharStyle(style);
 		itText->eraseCharStyle(style);
 	}
+	d->mergeRuns(first - 1, last - 1);
 	// Does not work well, do not reenable before checking #9337, #9376 and #9428
 	/*if (pos + signed(len) == length())
 	{
@@ -1063,21 +1045,21 @@ void StoryText::applyStyle(int pos, const ParagraphStyle& style, bool rmDirectFo
 	assert(pos >= 0);
 	assert(pos <= length());
 
-	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP) {
-		++i;
-	}
+	int i = d->text.indexOf(SpecialChars::PARSEP, pos);
+	if (i < 0)
+		i = length();
 	if (i < length()) {
-		if (!d->at(i)->parstyle) {
+		ScTextRun* itText = item(i);
+		if (!itText->parstyle) {
 			qDebug("PARSEP without style at pos %i", i);
-			d->at(i)->parstyle = new ParagraphStyle();
-			d->at(i)->parstyle->setContext( & d->pstyleContext);
+			itText->parstyle = new ParagraphStyle();
+			itText->parstyle->setContext( & d->pstyleContext);
 //			d->at(i)->parstyle->setName( "para(applyStyle)" ); // DON'T TRANSLATE
 //			d->at(i)->parstyle->charStyle().setName( "cpara(applyStyle)" ); // DON'T TRANSLATE
 //			d->at(i)->parstyle->charStyle().setContext( d->defaultStyle.charStyleContext() );
 		}
 //		qDebug() << QString("applying parstyle %2 at %1 for %3").arg(i).arg(paragraphStyle(pos).name()).arg(pos);
-		d->at(i)->parstyle->applyStyle(style);
+		itText->parstyle->applyStyle(style);
 	}
 	else {
 		// not happy about this but inserting a new PARSEP makes more trouble
@@ -1086,14 +1068,17 @@ void StoryText::applyStyle(int pos, const ParagraphStyle& style, bool rmDirectFo
 	}
 	if (rmDirectFormatting)
 	{
-		--i;
-		while (i >= 0 && d->at(i)->ch != SpecialChars::PARSEP)
+		int start = (i > 0) ? d->text.lastIndexOf(SpecialChars::PARSEP, i - 1) + 1 : 0;
+		if (start < i)
 		{
-			d->at(i)->eraseDirectFormatting();
-			--i;
+			int first = d->splitRun(start);
+			int last = d->splitRun(i);
+			for (int j = first; j < last; ++j)
+				d->runs.at(j)->eraseDirectFormatting();
+			d->mergeRuns(first - 1, last - 1);
 		}
 	}
-	invalidate(pos, qMin(i, length()));
+	invalidate(prevParagraph(pos), qMin(nextParagraph(pos) + 1, length()));
 }
 
 void StoryText::eraseStyle(int pos, const ParagraphStyle& style)
@@ -1104,28 +1089,28 @@ void StoryText::eraseStyle(int pos, const ParagraphStyle& style)
 	assert(pos >= 0);
 	assert(pos <= length());
 		
-	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP) {
-		++i;
-	}
+	int i = d->text.indexOf(SpecialChars::PARSEP, pos);
+	if (i < 0)
+		i = length();
 	if (i < length()) {
-		if (!d->at(i)->parstyle) {
+		ScTextRun* itText = item(i);
+		if (!itText->parstyle) {
 			qDebug("PARSEP without style at pos %i", i);
-			d->at(i)->parstyle = new ParagraphStyle();
-			d->at(i)->parstyle->setContext( & d->pstyleContext);
+			itText->parstyle = new ParagraphStyle();
+			itText->parstyle->setContext( & d->pstyleContext);
 //			d->at(i)->parstyle->setName( "para(eraseStyle)" ); // DON'T TRANSLATE
 //			d->at(i)->parstyle->charStyle().setName( "cpara(eraseStyle)" ); // DON'T TRANSLATE
 //			d->at(i)->parstyle->charStyle().setContext( d->defaultStyle.charStyleContext());
 		}
 		//		qDebug() << QString("applying parstyle %2 at %1 for %3").arg(i).arg(paragraphStyle(pos).name()).arg(pos);
-		d->at(i)->parstyle->eraseStyle(style);
+		itText->parstyle->eraseStyle(style);
 	}
 	else {
 		// not happy about this but inserting a new PARSEP makes more trouble
 		//		qDebug() << QString("applying parstyle %1 as defaultstyle for %2").arg(paragraphStyle(pos).name()).arg(pos);
 		d->trailingStyle.eraseStyle(style);
 	}
-	invalidate(pos, qMin(i, length()));
+	invalidate(prevParagraph(pos), qMin(i + 1, length()));
 }
 
 
@@ -1148,14 +1133,17 @@ void StoryText::setCharStyle(int pos, uint len, const CharStyle& style)
 	if (len == 0)
 		return;
 	
-	ScText* itText;
-	for (uint i=pos; i < pos+len; ++i) {
-		itText = d->at(i);
+	int first = d->splitRun(pos);
+	int last = d->splitRun(pos + len);
+	ScTextRun* itText;
+	for (int i=first; i < last; ++i) {
+		itText = d->runs.at(i);
 		// #6165 : applying style on last character applies style on whole text on next open 
 		/*if (itText->ch == SpecialChars::PARSEP && itText->parstyle != NULL)
 			itText->parstyle->charStyle() = style;*/
 		itText->setStyle(style);
 	}
+	d->mergeRuns(first - 1, last - 1);
 	
 	invalidate(pos, pos + len);
 }
@@ -1196,14 +1184,14 @@ void StoryText::replaceNamedResources(ResourceCollection& newNames)
 	if (len == 0)
 		return;
 	
-	ScText* itText;
-	for (int i=0; i < len; ++i) {
-		itText = d->at(i);
+	ScTextRun* itText;
+	for (int i=0; i < d->runs.count(); ++i) {
+		itText = d->runs.at(i);
 		if (itText->parstyle)
 			itText->parstyle->replaceNamedResources(newNames);
-		else
-			itText->replaceNamedResources(newNames);
+		itText->replaceNamedResources(newNames);
 	}
+	d->mergeRuns(0, d->runs.count() - 1);
 	
 	invalidate(0, len);	
 }
@@ -1223,7 +1211,7 @@ void StoryText::fixLegacyFormatting()
 
 	for (int i = 0; i < length(); ++ i)
 	{
-		if (d->at(i)->ch == SpecialChars::PARSEP)
+		if (d->text.at(i) == SpecialChars::PARSEP)
 			fixLegacyFormatting(i);
 	}
 	fixLegacyFormatting( length() );
@@ -1240,10 +1228,7 @@ void StoryText::fixLegacyFormatting(int pos)
 	assert(pos >= 0);
 	assert(pos <= length());
 
-	int i = pos;
-	while (i > 0 && d->at(i - 1)->ch != SpecialChars::PARSEP) {
-		--i;
-	}
+	int i = (pos > 0) ? d->text.lastIndexOf(SpecialChars::PARSEP, pos - 1) + 1 : 0;
 
 	const ParagraphStyle& parStyle = this->paragraphStyle(pos);
 	parStyle.validate();
@@ -1251,12 +1236,17 @@ void StoryText::fixLegacyFormatting(int pos)
 	if (parStyle.hasParent())
 	{
 		int start = i;
-		while ((i < length()) && (d->at(i)->ch != SpecialChars::PARSEP))
+		i = d->text.indexOf(SpecialChars::PARSEP, start);
+		if (i < 0)
+			i = length();
+		int first = d->splitRun(start);
+		int last = d->splitRun(i);
+		for (int j = first; j < last; ++j)
 		{
-			d->at(i)->validate();
-			d->at(i)->eraseCharStyle( parStyle.charStyle() );
-			++i;
+			d->runs.at(j)->validate();
+			d->runs.at(j)->eraseCharStyle( parStyle.charStyle() );
 		}
+		d->mergeRuns(first - 1, last - 1);
 		invalidate(start, qMin(i + 1, length()));
 	}
 }
@@ -1274,7 +1264,7 @@ uint StoryText::nrOfParagraph(int pos) const
 	pos = qMin(pos, that->length());
 	for (int i=0; i < pos; ++i)
 	{
-		lastWasPARSEP = that->d->at(i)->ch == SpecialChars::PARSEP;
+		lastWasPARSEP = that->d->text.at(i) == SpecialChars::PARSEP;
 		if (lastWasPARSEP)
 			++result;
 	}
@@ -1288,7 +1278,7 @@ uint StoryText::nrOfParagraphs() const
 	bool lastWasPARSEP = true;
 	for (int i=0; i < length(); ++i)
 	{
-		lastWasPARSEP = that->d->at(i)->ch == SpecialChars::PARSEP;
+		lastWasPARSEP = that->d->text.at(i) == SpecialChars::PARSEP;
 		if (lastWasPARSEP)
 			++result;
 	}
@@ -1308,7 +1298,7 @@ int StoryText::startOfParagraph(uint index) const
 	StoryText* that = const_cast<StoryText *>(this);
 	for (int i=0; i < length(); ++i)
 	{
-		if (that->d->at(i)->ch == SpecialChars::PARSEP && ! --index)
+		if (that->d->text.at(i) == SpecialChars::PARSEP && ! --index)
 			return i + 1;
 	}
 	return length();
@@ -1325,7 +1315,7 @@ int StoryText::endOfParagraph(uint index) const
 	StoryText* that = const_cast<StoryText *>(this);
 	for (int i=0; i < length(); ++i)
 	{
-		if (that->d->at(i)->ch == SpecialChars::PARSEP && ! --index)
+		if (that->d->text.at(i) == SpecialChars::PARSEP && ! --index)
 			return i;
 	}
 	return length();
@@ -1333,17 +1323,17 @@ int StoryText::endOfParagraph(uint index) const
 
 uint StoryText::nrOfRuns() const
 {
-	return length();
+	return d->runs.count();
 }
 
 int StoryText::startOfRun(uint index) const
 {
-	return index;
+	return d->startOfRun(index);
 }
 
 int StoryText::endOfRun(uint index) const
 {
-	return index + 1;
+	return d->startOfRun(index) + d->runs.at(index)->length;
 }
 
 // positioning. all positioning methods return char positions
@@ -1502,7 +1492,7 @@ QString StoryText::wordAt(int pos) const
 	StoryText* that(const_cast<StoryText*>(this));
 	for (int i = startWordPos; i < endWordPos; ++i)
 	{
-		result += that->d->at(i)->ch;
+		result += that->d->text.at(i);
 	}
 	return result;
 }
@@ -1692,13 +1682,59 @@ void StoryText::invalidateAll()
     invalidate(0, length());
 }
 
+uint StoryText::changeSerial() const
+{
+	return d->changes.isEmpty() ? d->changesSince : d->changes.last().serial;
+}
+
+bool StoryText::mapUnchangedRange(uint since, int& first, int& last) const
+{
+	int i = 0;
+	if (since != d->changesSince)
+	{
+		while (i < d->changes.count() && d->changes[i].serial != since)
+			++i;
+		if (i == d->changes.count())
+			return false;
+		++i;
+	}
+	for (; i < d->changes.count(); ++i)
+	{
+		const TextChange& change(d->changes[i]);
+		if (change.start > last)
+			continue;
+		if (change.end - change.delta > first)
+			return false;
+		first += change.delta;
+		last += change.delta;
+	}
+	return true;
+}
+
 void StoryText::invalidate(int firstItem, int endItem)
 {
-	for (int i=firstItem; i < endItem; ++i) {
+	for (int i = d->text.indexOf(SpecialChars::PARSEP, firstItem); i >= 0 && i < endItem; i = d->text.indexOf(SpecialChars::PARSEP, i + 1)) {
 		ParagraphStyle* par = item(i)->parstyle;
 		if (par)
 			par->charStyleContext()->invalidate();
 	}
+	// remember what changed so that layouts of untouched text can be kept,
+	// this includes chars which now belong to another run
+	int restyledFirst, restyledEnd;
+	if (d->takeRestyledRange(restyledFirst, restyledEnd))
+	{
+		firstItem = qMin(firstItem, restyledFirst);
+		endItem = qMax(endItem, restyledEnd);
+	}
+	TextChange change;
+	change.serial = ScText_Shared::nextChangeSerial();
+	change.start = firstItem;
+	change.end = endItem;
+	change.delta = static_cast<int>(d->len) - static_cast<int>(d->changeLength);
+	d->changes.append(change);
+	if (d->changes.count() > ScText_Shared::MaxChanges)
+		d->changesSince = d->changes.takeFirst().serial;
+	d->changeLength = d->len;
 	if (!signalsBlocked())
 		emit changed();
 	emit changed();
@@ -1721,17 +1757,17 @@ void StoryText::validate()
 
 
 
-ScText*  StoryText::item(uint itm)
+ScTextRun*  StoryText::item(uint itm)
 {
 	assert( static_cast<int>(itm) < length() );
-	return const_cast<StoryText *>(this)->d->at(itm);
+	return d->runOf(itm);
 }
 
 
-const ScText*  StoryText::item(uint itm) const
+const ScTextRun*  StoryText::item(uint itm) const
 {
 	assert( static_cast<int>(itm) < length() );
-	return const_cast<StoryText *>(this)->d->at(itm);
+	return d->runOf(itm);
 }
 
 
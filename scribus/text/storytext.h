@@ -189,6 +189,7 @@ class SCRIBUS_API StoryText : public QObject, public SaxIO
 	uint nrOfParagraph() const;
 	uint nrOfParagraph(int pos) const;
 
+	/// runs are ranges of chars with the same CharStyle, a PARSEP ends its run
  	uint nrOfRuns() const;
  	int startOfRun(uint index) const;
  	int endOfRun(uint index) const;
@@ -243,6 +244,15 @@ class SCRIBUS_API StoryText : public QObject, public SaxIO
  	/// call this if the shape of the paragraph changes (redos layout)
  	void invalidateLayout();
 
+	/// serial number of the last modification of the text
+	uint changeSerial() const;
+	/**
+	   Maps the range [first, last] of the text as it was at change serial 'since'
+	   to the current text. Returns false if a character in the range was modified
+	   since then, or if the modification history doesn't reach back that far.
+	 */
+	bool mapUnchangedRange(uint since, int& first, int& last) const;
+
 public slots:
 	/// call this if some logical style changes (redos shaping and layout)
  	void invalidateAll();
@@ -251,11 +261,12 @@ signals:
 		void changed();
 
 private:
- 	ScText * item(uint index);
- 	const ScText * item(uint index) const;
+ 	/// the run containing the char at index
+ 	ScTextRun * item(uint index);
+ 	const ScTextRun * item(uint index) const;
 
 //public:
-//	ScText * item_p(uint index) { return item(index); }
+//	ScTextRun * item_p(uint index) { return item(index); }
 
 // 	int screenToPosition(FPoint coord) const;
 // 	FRect  boundingBox(int pos, uint len = 1) const;
@@ -279,8 +290,8 @@ private:
 	
  	/// mark these runs as invalid, ie. need itemize and shaping
  	void invalidate(int firstRun, int lastRun);
- 	void removeParSep(int pos);
  	void insertParSep(int pos);
+ 	void insertCharsWithStyle(int pos, const QString& txt, const CharStyle& style);
 
 	// 	int splitRun(int pos);
  	
@@ -168,6 +168,13 @@ void TextLayout::addColumn(double colLeft, double colWidth)
 	m_box->setWidth(m_frame->width());
 }
 
+// Keep the layout of text that was moved by an edit before it.
+void TextLayout::moveChars(int delta)
+{
+	m_box->moveChars(delta);
+	m_lastMagicPos = -1;
+}
+
 void TextLayout::clear() 
 {
 	delete m_box;
@@ -79,6 +79,7 @@ public:
 
 	void appendLine(LineBox* ls);
 	void removeLastLine ();
+	void moveChars(int delta);
 	void addColumn(double colLeft, double colWidth);
 
 	void clear();
@@ -7,6 +7,7 @@
 
 #include "pageitem.h"
 #include "pageitem_textframe.h"
+#include "prefsstructs.h"
 #include "scribusdoc.h"
 #include "sctextstruct.h"
 #include "style.h"
@@ -15,13 +16,76 @@
 #include "textshaper.h"
 #include "text/specialchars.h"
 
+ShapingCache::ShapingCache()
+	: m_glyphCount(0)
+{
+	for (int i = 0; i < 5; ++i)
+		m_typoPrefs[i] = -1;
+}
+
+void ShapingCache::validate(ScribusDoc* doc)
+{
+	const TypoPrefs& prefs = doc->typographicPrefs();
+	int typoPrefs[5] = { prefs.valueSuperScript, prefs.scalingSuperScript,
+						 prefs.valueSubScript, prefs.scalingSubScript, prefs.valueSmallCaps };
+	bool changed = false;
+	for (int i = 0; i < 5; ++i)
+	{
+		changed |= (m_typoPrefs[i] != typoPrefs[i]);
+		m_typoPrefs[i] = typoPrefs[i];
+	}
+	if (changed || (m_glyphCount > MaxGlyphs))
+		clear();
+}
+
+void ShapingCache::clear()
+{
+	m_glyphs.clear();
+	m_kerning.clear();
+	m_glyphCount = 0;
+}
+
+ShapingCache::GlyphTable* ShapingCache::glyphTable(const CharStyle& style)
+{
+	QString key = QString("%1|%2|%3|%4|%5|%6")
+			.arg(style.font().scName())
+			.arg(style.fontSize())
+			.arg(static_cast<int>(style.effects() & ScStyle_UserStyles))
+			.arg(style.scaleH())
+			.arg(style.scaleV())
+			.arg(style.tracking());
+	return &m_glyphs[key];
+}
+
+ShapingCache::KerningTable* ShapingCache::kerningTable(const CharStyle& style)
+{
+	return &m_kerning[style.font().scName()];
+}
+
+bool ShapingCache::sameShaping(const CharStyle& a, const CharStyle& b)
+{
+	if (&a == &b)
+		return true;
+	return a.fontSize() == b.fontSize()
+		&& a.scaleH() == b.scaleH()
+		&& a.scaleV() == b.scaleV()
+		&& a.tracking() == b.tracking()
+		&& (a.effects() & ScStyle_UserStyles) == (b.effects() & ScStyle_UserStyles)
+		&& a.font() == b.font();
+}
+
 TextShaper::TextShaper(PageItem_TextFrame* textItem, int startIndex)
 	      : m_startIndex(startIndex),
 			m_index(startIndex),
 			m_lastKernedIndex(-1),
 			m_layoutFlags(ScLayout_None),
-			m_item(textItem)
+			m_item(textItem),
+			m_cache(&textItem->shapingCache()),
+			m_runStyle(NULL),
+			m_runGlyphs(NULL),
+			m_runKerning(NULL)
 {
+	m_cache->validate(m_item->doc());
 	if (m_item->lastInFrame() >= m_item->firstInFrame())
 	{
 		int charsCount = m_item->lastInFrame() - m_item->firstInFrame() + 1;
@@ -183,6 +247,18 @@ void TextShaper::startLine(int i)
 	m_lastKernedIndex = m_runs.count() - 1;
 }
 
+void TextShaper::startStyleRun(const CharStyle& style)
+{
+	if (m_runStyle && ShapingCache::sameShaping(*m_runStyle, style))
+	{
+		m_runStyle = &style;
+		return;
+	}
+	m_runStyle   = &style;
+	m_runGlyphs  = m_cache->glyphTable(style);
+	m_runKerning = m_cache->kerningTable(style);
+}
+
 void TextShaper::initGlyphLayout(GlyphRun& run, const QString& chars, int runIndex)
 {
 	int a = run.firstChar();
@@ -193,14 +269,38 @@ void TextShaper::initGlyphLayout(GlyphRun& run, const QString& chars, int runInd
 	if (SpecialChars::isExpandingSpace(ch))
 		run.setFlag(ScLayout_ExpandingSpace);
 
+	startStyleRun(runStyle);
+
 	LayoutFlags layoutFlags = static_cast<LayoutFlags>(itemText.flags(a) | m_layoutFlags);
-	GlyphLayout gl = m_item->layoutGlyphs(runStyle, chars, layoutFlags);
+	uint glyphKey = ch.unicode();
+	if (layoutFlags & ScLayout_StartOfLine)
+		glyphKey |= 0x10000;
+	GlyphLayout gl;
+	ShapingCache::GlyphTable::const_iterator cached = m_runGlyphs->constFind(glyphKey);
+	if (cached != m_runGlyphs->constEnd())
+		gl = cached.value();
+	else
+	{
+		gl = m_item->layoutGlyphs(runStyle, chars, layoutFlags);
+		m_runGlyphs->insert(glyphKey, gl);
+		m_cache->glyphAdded();
+	}
 	m_layoutFlags  = static_cast<LayoutFlags>(m_layoutFlags & (~ScLayout_StartOfLine));
 
 	if (runIndex > 0)
 	{
 		GlyphLayout& last = m_runs[runIndex - 1].glyphs().last();
-		last.xadvance += runStyle.font().glyphKerning(last.glyph, gl.glyph, runStyle.fontSize() / 10);
+		quint64 pair = (static_cast<quint64>(last.glyph) << 32) | gl.glyph;
+		qreal kerning;
+		ShapingCache::KerningTable::const_iterator kern = m_runKerning->constFind(pair);
+		if (kern != m_runKerning->constEnd())
+			kerning = kern.value();
+		else
+		{
+			kerning = runStyle.font().glyphKerning(last.glyph, gl.glyph, 1.0);
+			m_runKerning->insert(pair, kerning);
+		}
+		last.xadvance += kerning * runStyle.fontSize() / 10;
 		m_lastKernedIndex = qMax(m_lastKernedIndex, runIndex - 1);
 	}
 
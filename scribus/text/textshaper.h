@@ -8,13 +8,69 @@
 #ifndef TEXTSHAPER_H
 #define TEXTSHAPER_H
 
+#include <QHash>
 #include <QList>
 
 #include "scribusapi.h"
 #include "sctextstruct.h"
 #include "text/storytext.h"
 
+class CharStyle;
 class PageItem_TextFrame;
+class ScribusDoc;
+
+/**
+ * Shaped glyphs of a text frame, kept across layouts.
+ * Characters are grouped in runs sharing the style attributes which
+ * PageItem::layoutGlyphs() depends on. Each distinct run gets its own glyph
+ * and kerning table, so relayouting after an edit only shapes characters
+ * and style combinations which have not been seen before.
+ */
+class SCRIBUS_API ShapingCache
+{
+public:
+	typedef QHash<uint, GlyphLayout> GlyphTable;
+	typedef QHash<quint64, qreal> KerningTable;
+
+	ShapingCache();
+
+	/**
+	 * Empty the cache if the typographic settings of the document changed
+	 * since last use or if it grew past its size limit
+	 */
+	void validate(ScribusDoc* doc);
+	void clear();
+
+	/**
+	 * Glyph table of the run style belongs to, keyed by character and
+	 * start of line flag
+	 */
+	GlyphTable* glyphTable(const CharStyle& style);
+
+	/**
+	 * Kerning table of the font used by style, values are for a font size of 1
+	 */
+	KerningTable* kerningTable(const CharStyle& style);
+
+	/**
+	 * Test if two styles belong to the same run, ie. if layoutGlyphs()
+	 * gives the same result for both
+	 */
+	static bool sameShaping(const CharStyle& a, const CharStyle& b);
+
+	/**
+	 * Notify the cache that a glyph has been added, used to bound its size
+	 */
+	void glyphAdded() { ++m_glyphCount; }
+
+private:
+	QHash<QString, GlyphTable> m_glyphs;
+	QHash<QString, KerningTable> m_kerning;
+	int m_typoPrefs[5];
+	int m_glyphCount;
+
+	static const int MaxGlyphs = 65536;
+};
 
 class SCRIBUS_API TextShaper
 {
@@ -56,6 +112,17 @@ protected:
 	// Glyph runs waiting to be retrieved
 	QList<GlyphRun> m_runs;
 
+	// Shaping results shared with previous layouts of the item
+	ShapingCache* m_cache;
+
+	// Tables of the style run currently being shaped
+	const CharStyle* m_runStyle;
+	ShapingCache::GlyphTable* m_runGlyphs;
+	ShapingCache::KerningTable* m_runKerning;
+
+	// Switch to the tables of the run style belongs to
+	void startStyleRun(const CharStyle& style);
+
 	// Get next chars and put them in char queue
 	void needChars(int runIndex);
 
@@ -216,6 +216,9 @@ void CheckDocument::doReScan()
 {
 	showPagesWithoutErrors=PrefsManager::instance()->appPrefs.verifierPrefs.showPagesWithoutErrors;
 	showNonPrintingLayerErrors=PrefsManager::instance()->appPrefs.verifierPrefs.showNonPrintingLayerErrors;
+	// an explicit rescan checks every item again
+	if (m_Doc != 0)
+		m_Doc->checkerCache().clear();
 	newScan(curCheckProfile->currentText());
 }
 
@@ -27,6 +27,7 @@ CollectForOutput_UI::CollectForOutput_UI(QWidget* parent, ScribusDoc* doc, QStri
 	connect(this, SIGNAL(itemsCollected(int)), this, SLOT(collectedItems(int)));
 	connect(this, SIGNAL(patternsCollected(int)), this, SLOT(collectedPatterns(int)));
 	connect(this, SIGNAL(profilesCollected(int)), this, SLOT(collectedProfiles(int)));
+	connect(this, SIGNAL(filesCopied(int)), this, SLOT(copiedFiles(int)));
 }
 
 QString CollectForOutput_UI::collect(QString &newFileName)
@@ -57,6 +58,10 @@ QString CollectForOutput_UI::collect(QString &newFileName)
 		barsNumeric << true;
 	}
 
+	barNames << "files";
+	barTexts << tr("Copying Files:");
+	barsNumeric << true;
+
 	progressDialog->addExtraProgressBars(barNames, barTexts, barsNumeric);
 	progressDialog->setOverallTotalSteps(profileCount+itemCount+fontCount+patternCount);
 	progressDialog->setTotalSteps("items", itemCount);
@@ -73,6 +78,8 @@ QString CollectForOutput_UI::collect(QString &newFileName)
 		progressDialog->setTotalSteps("profiles", profileCount);
 		progressDialog->setProgress("profiles", 0);
 	}
+	progressDialog->setTotalSteps("files", 1);
+	progressDialog->setProgress("files", 0);
 	progressDialog->setOverallProgress(0);
 
 	ScCore->fileWatcher->forceScan();
@@ -109,11 +116,16 @@ QString CollectForOutput_UI::collect(QString &newFileName)
 	/* collect document must go last because of image paths changes in collectItems() */
 	if (!collectDocument())
 	{
+		waitForCopies();
+		updateWatchedFiles();
 		QString errorMsg( tr("Cannot collect the file: \n%1").arg(newName) );
 		ScMessageBox::warning(ScCore->primaryMainWindow(), CommonStrings::trWarning, "<qt>" + errorMsg + "</qt>");
 		return errorMsg;
 	}
 
+	progressDialog->setTotalSteps("files", copiesQueued);
+	finishCopies();
+
 	QDir::setCurrent(m_outputDirectory);
 	ScCore->primaryMainWindow()->updateActiveWindowCaption(newName);
 	UndoManager::instance()->renameStack(newName);
@@ -150,6 +162,11 @@ void CollectForOutput_UI::collectedPatterns(int c)
 	ScQApp->processEvents();
 }
 
+void CollectForOutput_UI::copiedFiles(int c)
+{
+	progressDialog->setProgress("files", c);
+}
+
 void CollectForOutput_UI::collectedProfiles(int c)
 {
 	progressDialog->setProgress("profiles", c);
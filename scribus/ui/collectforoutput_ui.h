@@ -24,6 +24,7 @@ class CollectForOutput_UI : public CollectForOutput
 		void collectedItems(int);
 		void collectedPatterns(int);
 		void collectedProfiles(int);
+		void copiedFiles(int);
 
 	protected:
 		MultiProgressDialog* progressDialog;
@@ -343,6 +343,7 @@ CustomFDialog::CustomFDialog(QWidget *parent, QString wDir, QString caption, QSt
 	SaveZip=NULL;
 	WithFonts=NULL;
 	WithProfiles=NULL;
+	WithZipArchive=NULL;
 	TxCodeM = NULL;
 	TxCodeT = NULL;
 	Layout = LayoutC = NULL;
@@ -366,6 +367,9 @@ CustomFDialog::CustomFDialog(QWidget *parent, QString wDir, QString caption, QSt
 		Layout1C->addWidget(WithFonts, Qt::AlignLeft);
 		WithProfiles = new QCheckBox( tr( "&Include Color Profiles" ), LayoutC);
 		Layout1C->addWidget(WithProfiles, Qt::AlignLeft);
+		WithZipArchive = new QCheckBox( tr( "Create &Zip Archive" ), LayoutC);
+		WithZipArchive->setToolTip( "<qt>" + tr( "Pack the collected files into a zip archive next to the directory" ) + "</qt>");
+		Layout1C->addWidget(WithZipArchive, Qt::AlignLeft);
 		QSpacerItem* spacer2 = new QSpacerItem( 2, 2, QSizePolicy::Expanding, QSizePolicy::Minimum );
 		Layout1C->addItem( spacer2 );
 		vboxLayout->addWidget(LayoutC);
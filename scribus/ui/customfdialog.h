@@ -116,6 +116,7 @@ public:
 	QCheckBox* SaveZip;
 	QCheckBox* WithFonts;
 	QCheckBox* WithProfiles;
+	QCheckBox* WithZipArchive;
 	QFrame* Layout;
 	QFrame* LayoutC;
 	QComboBox *TxCodeM;
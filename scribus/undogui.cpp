@@ -225,6 +225,15 @@ void UndoWidget::popBack()
 	}
 }
 
+void UndoWidget::updateLastUndoItem(UndoObject* target, UndoState* state)
+{
+	if (undoItems.size() == 0)
+		return;
+	undoItems[0] = QString( tr("%1: %2", "undo target: action (f.e. Text frame: Resize)"))
+	               .arg(target->getUName()).arg(state->getName());
+	updateUndoMenu();
+}
+
 UndoWidget::~UndoWidget()
 {
 
@@ -391,6 +400,17 @@ void UndoPalette::popBack()
 // 	qDebug() << "UndoPalette::popBack end";
 }
 
+void UndoPalette::updateLastUndoItem(UndoObject* target, UndoState* state)
+{
+	if (currentSelection < 1 || currentSelection >= undoList->count())
+		return;
+	delete undoList->takeItem(currentSelection);
+	undoList->insertItem(currentSelection, new UndoItem(target->getUName(), state->getName(),
+                         state->getDescription(), target->getUPixmap(),
+                         state->getPixmap(), true));
+	updateList();
+}
+
 void UndoPalette::updateList()
 {
 // 	qDebug() << "UndoPalette::updateList start";
@@ -127,6 +127,13 @@ public slots:
 
 	/** @brief Remove the last (oldest) item from the undo stack representation. */
 	virtual void popBack() = 0;
+
+	/**
+	 * @brief Update the latest undo item after an action was merged into its state.
+	 * @param target Target of the undo action
+	 * @param state State describing the action
+	 */
+	virtual void updateLastUndoItem(UndoObject* target, UndoState* state) = 0;
 /* signals: do not implement these but emit when action happens
 	virtual void undo(int steps) = 0;
 	virtual void redo(int steps) = 0;
@@ -225,6 +232,9 @@ public slots:
 	
 	/** @brief Remove the last (oldest) item from the undo stack representation. */
 	void popBack();
+
+	/** @brief Update the latest undo item after an action was merged into its state. */
+	void updateLastUndoItem(UndoObject* target, UndoState* state);
 signals:
 	/** 
 	 * @brief Emitted when undo is requested.
@@ -406,6 +416,9 @@ public slots:
 	/** @brief Remove the last (oldest) item from the undo stack representation. */
 	void popBack();
 
+	/** @brief Update the latest undo item after an action was merged into its state. */
+	void updateLastUndoItem(UndoObject* target, UndoState* state);
+
 	/** @brief Receive prefsChanged() signal to update shortcuts. */
 	void updateFromPrefs();
 
@@ -230,6 +230,8 @@ void UndoManager::connectGuis()
 		connect(this, SIGNAL(newAction(UndoObject*, UndoState*)),
                 gui, SLOT(insertUndoItem(UndoObject*, UndoState*)));
 		connect(this, SIGNAL(popBack()), gui, SLOT(popBack()));
+		connect(this, SIGNAL(lastUndoChanged(UndoObject*, UndoState*)),
+				gui, SLOT(updateLastUndoItem(UndoObject*, UndoState*)));
 		connect(this, SIGNAL(undoSignal(int)), gui, SLOT(updateUndo(int)));
 		connect(this, SIGNAL(redoSignal(int)), gui, SLOT(updateRedo(int)));
 		connect(this, SIGNAL(clearRedo()), gui, SLOT(clearRedo()));
@@ -249,6 +251,8 @@ void UndoManager::disconnectGuis()
 		disconnect(this, SIGNAL(newAction(UndoObject*, UndoState*)),
                    gui, SLOT(insertUndoItem(UndoObject*, UndoState*)));
 		disconnect(this, SIGNAL(popBack()), gui, SLOT(popBack()));
+		disconnect(this, SIGNAL(lastUndoChanged(UndoObject*, UndoState*)),
+				gui, SLOT(updateLastUndoItem(UndoObject*, UndoState*)));
 		disconnect(this, SIGNAL(undoSignal(int)), gui, SLOT(updateUndo(int)));
 		disconnect(this, SIGNAL(redoSignal(int)), gui, SLOT(updateRedo(int)));
 		disconnect(this, SIGNAL(clearRedo()), gui, SLOT(clearRedo()));
@@ -278,6 +282,7 @@ void UndoManager::switchStack(const QString& stackName)
 		stacks_[currentDoc_] = UndoStack();
 
 	stacks_[currentDoc_].setMaxSize(prefs_->getInt("historylength", 100));
+	stacks_[currentDoc_].setMemoryBudget(static_cast<qint64>(prefs_->getInt("memorybudget", 256)) * 1024 * 1024);
 	for (uint i = 0; i < undoGuis_.size(); ++i)
 		setState(undoGuis_[i]);
 
@@ -362,7 +367,8 @@ void UndoManager::action(UndoObject* target, UndoState* state, QPixmap *targetPi
 	{
 //		qDebug() << "UndoManager: Action executed:" << target->getUName() << state->getName();
 		state->setUndoObject(target);
-		if (stacks_[currentDoc_].action(state))
+		int popped = stacks_[currentDoc_].action(state);
+		for (int i = 0; i < popped; ++i)
 			emit popBack();
 	}
 	if (targetPixmap)
@@ -386,6 +392,21 @@ UndoState* UndoManager::getLastUndo(){
 	return state;
 }
 
+SimpleState* UndoManager::mergeableState(UndoObject* target, const QString& key, qint64 interval)
+{
+	if (!undoEnabled_ || isTransactionMode())
+		return 0;
+	return stacks_[currentDoc_].mergeCandidate(target, key, interval);
+}
+
+void UndoManager::stateMerged(UndoObject* target, UndoState* state)
+{
+	state->touch();
+	if (currentUndoObjectId_ == -1 || currentUndoObjectId_ == static_cast<long>(target->getUId()))
+		emit lastUndoChanged(target, state);
+	setTexts();
+}
+
 void UndoManager::undo(int steps)
 {
 	if (!undoEnabled_)
@@ -499,6 +520,23 @@ void UndoManager::setAllHistoryLengths(int steps)
 	}
 }
 
+void UndoManager::setMemoryBudget(int megabytes)
+{
+	if (megabytes >= 0)
+	{
+		for (StackMap::Iterator it = stacks_.begin(); it != stacks_.end(); ++it )
+		{
+			it.value().setMemoryBudget(static_cast<qint64>(megabytes) * 1024 * 1024);
+		}
+		prefs_->set("memorybudget", megabytes);
+	}
+}
+
+int UndoManager::getMemoryBudget()
+{
+	return prefs_->getInt("memorybudget", 256);
+}
+
 int UndoManager::getHistoryLength()
 {
 	if (stacks_.size() > 0 && stacks_[currentDoc_].redoItems() > 0)
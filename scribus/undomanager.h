@@ -257,6 +257,12 @@ public:
 	 */
 	int getHistoryLength();
 
+	/**
+	 * @brief Returns the memory budget of the undo stacks in megabytes.
+	 * @return memory budget in megabytes, 0 if only the history length applies
+	 */
+	int getMemoryBudget();
+
 	/**
 	 * @brief Returns true if in global mode and false if in object specific mode.
 	 * @return true if in global mode and false if in object specific mode
@@ -265,6 +271,26 @@ public:
 
 	UndoState* getLastUndo();
 
+	/**
+	 * @brief Returns the last undo state if an action of kind key on target may extend it.
+	 *
+	 * Used to merge repeated small actions, like nudging an item, into one undo
+	 * step. Returns NULL in transaction mode, when undo is disabled or when there
+	 * is something to redo (see UndoStack::mergeCandidate()). After the returned
+	 * state was changed stateMerged() must be called.
+	 * @param target UndoObject of the new action
+	 * @param key Key identifying the kind of action, f.e. "ITEM_MOVE"
+	 * @param interval Time window in milliseconds since the last change of the state
+	 */
+	SimpleState* mergeableState(UndoObject* target, const QString& key, qint64 interval);
+
+	/**
+	 * @brief Tell the registered UndoGuis that an action was merged into state.
+	 * @param target UndoObject of the merged action
+	 * @param state State returned by mergeableState()
+	 */
+	void stateMerged(UndoObject* target, UndoState* state);
+
 private:
 	/**
 	 * @brief The only instance of UndoManager available.
@@ -720,6 +746,15 @@ public slots:
 	void setHistoryLength(int steps);
 	void setAllHistoryLengths(int steps);
 
+	/**
+	 * @brief Sets the memory budget of all undo stacks.
+	 *
+	 * Oldest UndoStates are removed when the estimated size of a stack exceeds
+	 * the budget, even if the history length has not been reached yet.
+	 * @param megabytes memory budget in megabytes, 0 for no limit
+	 */
+	void setMemoryBudget(int megabytes);
+
 signals:
 	/**
 	 * @brief Emitted when a new undo action is stored to the undo stack.
@@ -762,6 +797,13 @@ signals:
 	 */
 	void popBack();
 
+	/**
+	 * @brief This signal is used to notify registered UndoGui instances that
+	 * @brief an action was merged into the latest undo state, whose
+	 * @brief representation should be updated.
+	 */
+	void lastUndoChanged(UndoObject* target, UndoState* state);
+
 	/**
 	 * @brief This signal is emitted when beginning a series of undo/redo actions
 	 *
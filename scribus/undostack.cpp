@@ -28,18 +28,34 @@ for which a new license (GPL+exception) is in place.
 #include "undoobject.h"
 #include "undostack.h"
 
-UndoStack::UndoStack(int maxSize) : m_maxSize_(maxSize)
+UndoStack::UndoStack(int maxSize) : m_maxSize_(maxSize), m_memoryBudget_(0), m_memoryUsed_(0)
 {
 
 }
 
-bool UndoStack::action(UndoState *state)
+int UndoStack::action(UndoState *state)
 {
-    m_redoActions_.clear();
-    m_undoActions_.insert(m_undoActions_.begin(), state);
-    bool needsPopping = checkSize(); // only store maxSize_ amount of actions
+	for (uint i = 0; i < m_redoActions_.size(); ++i)
+	{
+		m_memoryUsed_ -= m_redoActions_[i]->stackedSize_;
+		delete m_redoActions_[i];
+	}
+	m_redoActions_.clear();
+	// typing and similar actions are merged into the previous state after it was stored
+	if (!m_undoActions_.empty())
+		account(m_undoActions_[0]);
+	state->stackedSize_ = 0;
+	account(state);
+	m_undoActions_.insert(m_undoActions_.begin(), state);
+
+	return checkSize(); // only store maxSize_ amount of actions
+}
 
-    return needsPopping;
+void UndoStack::account(UndoState *state)
+{
+	qint64 size = state->memorySize();
+	m_memoryUsed_ += size - state->stackedSize_;
+	state->stackedSize_ = size;
 }
 
 bool UndoStack::undo(uint steps, int objectId)
@@ -152,20 +168,49 @@ void UndoStack::setMaxSize(uint maxSize)
     checkSize(); // we may need to remove actions
 }
 
-bool UndoStack::checkSize() {
-    if (m_maxSize_ == 0) // 0 marks for infinite stack size
-        return false;
+qint64 UndoStack::memoryBudget() const
+{
+	return m_memoryBudget_;
+}
+
+void UndoStack::setMemoryBudget(qint64 bytes)
+{
+	m_memoryBudget_ = qMax<qint64>(0, bytes);
+	checkSize();
+}
+
+qint64 UndoStack::memoryUsed() const
+{
+	return m_memoryUsed_;
+}
+
+void UndoStack::popOldest()
+{
+	UndoState *state;
+	if (m_redoActions_.size() > 0) // clear redo actions first
+	{
+		state = m_redoActions_.back();
+		m_redoActions_.pop_back();
+	}
+	else
+	{
+		state = m_undoActions_.back();
+		m_undoActions_.pop_back();
+	}
+	m_memoryUsed_ -= state->stackedSize_;
+	delete state;
+}
 
-    bool needsPopping = size () > m_maxSize_;
+int UndoStack::checkSize() {
+	uint undoCount = m_undoActions_.size();
 
-    while (size() > m_maxSize_) {
-        if (m_redoActions_.size() > 0) // clear redo actions first
-            m_redoActions_.pop_back();
-        else
-            m_undoActions_.pop_back();
-    }
+	// 0 marks for infinite stack size
+	while (m_maxSize_ != 0 && size() > m_maxSize_)
+		popOldest();
+	while (m_memoryBudget_ != 0 && m_memoryUsed_ > m_memoryBudget_ && size() > 1)
+		popOldest();
 
-    return needsPopping;
+	return undoCount - m_undoActions_.size();
 }
 
 void UndoStack::clear()
@@ -176,6 +221,7 @@ void UndoStack::clear()
 		delete m_redoActions_[i];
 	m_undoActions_.clear();
 	m_redoActions_.clear();
+	m_memoryUsed_ = 0;
 }
 
 UndoState* UndoStack::getNextUndo(int objectId)
@@ -234,6 +280,16 @@ UndoState* UndoStack::getNextRedo(int objectId)
 	return state;
 }
 
+SimpleState* UndoStack::mergeCandidate(UndoObject* target, const QString& key, qint64 interval)
+{
+	if (m_undoActions_.empty() || !m_redoActions_.empty())
+		return 0;
+	SimpleState *state = dynamic_cast<SimpleState*>(m_undoActions_[0]);
+	if (!state || !state->canMerge(target, key, interval))
+		return 0;
+	return state;
+}
+
 UndoStack::~UndoStack()
 {
     // no dynamically allocated memory
@@ -29,6 +29,11 @@ for which a new license (GPL+exception) is in place.
 
 #include <vector>
 
+#include <QtGlobal>
+
+class QString;
+class SimpleState;
+class UndoObject;
 class UndoState;
 class TransactionState;
 
@@ -42,9 +47,9 @@ public:
 
     /* Used to push a new action to the stack. UndoState in the parameter will then
      * become the first undo action in the stack and all the redo actions will be
-     * cleared. If maximum size of the stack is hit and an action needs to be removed
-     * this function returns true. */
-    bool action(UndoState *state);
+     * cleared. Returns the number of undo actions removed because the maximum
+     * size or the memory budget of the stack was hit. */
+    int action(UndoState *state);
 
     /* undo number of steps actions (these will then become redo actions) */
     bool undo(uint steps, int objectId);
@@ -65,11 +70,26 @@ public:
      * function setUndoEnabled(bool) from UndoManager should be used */
     void setMaxSize(uint maxSize);
 
+    /* maximum memory in bytes the stored actions may use, 0 for no limit */
+    qint64 memoryBudget() const;
+    /* Change the memory budget. Oldest actions are removed the same way as
+     * with setMaxSize() until the estimated size of the stack fits in the
+     * budget. The latest undo action is always kept. */
+    void setMemoryBudget(qint64 bytes);
+    /* estimated memory used by the stored actions in bytes */
+    qint64 memoryUsed() const;
+
     void clear();
 
     UndoState* getNextUndo(int objectId);
     UndoState* getNextRedo(int objectId);
 
+    /* Returns the latest undo action if an action of kind key on target may be
+     * merged into it instead of being pushed, NULL otherwise. That requires an
+     * empty redo list, so history stays linear, and a SimpleState accepting the
+     * action (SimpleState::canMerge()). */
+    SimpleState* mergeCandidate(UndoObject* target, const QString& key, qint64 interval);
+
 private:
     /* When an action happens it is pushed to the undoActions_ and the redoActions_
      * is cleared. When undo is requested action is popped from undoActions_ and
@@ -79,10 +99,19 @@ private:
 
     /* maximum amount of actions stored, 0 for no limit */
 	uint m_maxSize_;
+	/* maximum memory used by the stored actions, 0 for no limit */
+	qint64 m_memoryBudget_;
+	/* sum of the sizes accounted for the stored actions */
+	qint64 m_memoryUsed_;
 
-    /* returns true if an action was popped from the stack */
+    /* returns the number of undo actions popped from the stack */
     /* assures that we only hold the maxSize_ number of UndoStates */
-    bool checkSize();
+    /* and stay within memoryBudget_ */
+    int checkSize();
+    /* deletes the oldest redo action, or the oldest undo action if there are no redo actions */
+    void popOldest();
+    /* updates the accounted size of state, which may have grown since it was stored */
+    void account(UndoState *state);
 
     friend class UndoManager; // UndoManager needs access to undoActions_ and redoActions_
                               // for updating the attached UndoGui widgets
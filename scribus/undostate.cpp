@@ -24,17 +24,48 @@ for which a new license (GPL+exception) is in place.
  *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.             *
  ***************************************************************************/
 
+#include <QHash>
+
 #include "undostate.h"
 #include "undoobject.h"
+#include "fpointarray.h"
+#include "scimagestructs.h"
+#include "vgradient.h"
+#include "text/storytext.h"
+
+namespace
+{
+	/* Key strings of all SimpleStates, states only store the key's index */
+	QHash<QString, int>& undoKeyIds()
+	{
+		static QHash<QString, int> ids;
+		return ids;
+	}
+
+	qint64 variantSize(const QVariant& v)
+	{
+		// int, uint, double and bool are stored inside the QVariant itself
+		switch (v.type())
+		{
+			case QVariant::String:
+				return v.toString().capacity() * sizeof(QChar);
+			case QVariant::ByteArray:
+				return v.toByteArray().capacity();
+			default:
+				return 0;
+		}
+	}
+}
 
 UndoState::UndoState(const QString& name, const QString& description, QPixmap* pixmap) :
 transactionCode(0),
+stackedSize_(0),
 actionName_(name),
 actionDescription_(description),
 actionPixmap_(pixmap),
 undoObject_(0)
 {
-
+	changeTimer_.start();
 }
 
 QString UndoState::getName()
@@ -89,6 +120,21 @@ UndoObject* UndoState::undoObject()
 	return undoObject_;
 }
 
+qint64 UndoState::memorySize() const
+{
+	return sizeof(UndoState) + actionDescription_.capacity() * sizeof(QChar);
+}
+
+void UndoState::touch()
+{
+	changeTimer_.restart();
+}
+
+qint64 UndoState::msecsSinceChange() const
+{
+	return changeTimer_.elapsed();
+}
+
 UndoState::~UndoState()
 {
 
@@ -102,29 +148,70 @@ SimpleState::SimpleState(const QString& name, const QString& description, QPixma
 
 }
 
+int SimpleState::keyId(const QString& key)
+{
+	QHash<QString, int>& ids = undoKeyIds();
+	QHash<QString, int>::const_iterator it = ids.constFind(key);
+	if (it != ids.constEnd())
+		return it.value();
+	int id = ids.count();
+	ids.insert(key, id);
+	return id;
+}
+
+int SimpleState::knownKeyId(const QString& key)
+{
+	return undoKeyIds().value(key, -1);
+}
+
+int SimpleState::lowerBound(int id) const
+{
+	int lo = 0;
+	int hi = m_values.count();
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
+		if (m_values.at(mid).first < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+void SimpleState::setValue(const QString& key, const QVariant& value)
+{
+	int id = keyId(key);
+	int pos = lowerBound(id);
+	if (pos < m_values.count() && m_values.at(pos).first == id)
+		m_values[pos].second = value;
+	else
+		m_values.insert(pos, Value(id, value));
+}
+
 bool SimpleState::contains(const QString& key)
 {
-	return m_values.contains(key);
+	int id = knownKeyId(key);
+	if (id < 0)
+		return false;
+	int pos = lowerBound(id);
+	return (pos < m_values.count() && m_values.at(pos).first == id);
 }
 
 QVariant SimpleState::variant(const QString& key, const QVariant& def)
 {
-	QMap<QString, QVariant>::const_iterator it = m_values.find(key);
-	if (it != m_values.end())
-		return it.value();
+	int id = keyId(key);
+	int pos = lowerBound(id);
+	if (pos < m_values.count() && m_values.at(pos).first == id)
+		return m_values.at(pos).second;
 
-	m_values[key] = def;
+	m_values.insert(pos, Value(id, def));
 	return def;
 }
 
 QString SimpleState::get(const QString& key, const QString& def)
 {
-	QMap<QString, QVariant>::const_iterator it = m_values.find(key);
-	if (it != m_values.end())
-		return it.value().toString();
-
-	m_values[key] = def;
-	return def;
+	return variant(key, QVariant(def)).toString();
 }
 
 int SimpleState::getInt(const QString& key, int def)
@@ -169,40 +256,120 @@ bool SimpleState::getBool(const QString& key, bool def)
 
 void SimpleState::set(const QString& key)
 {
-	m_values[key] = QVariant();
+	setValue(key, QVariant());
 }
 
 void SimpleState::set(const QString& key, const QString& value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 void SimpleState::set(const QString& key, int value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 void SimpleState::set(const QString& key, uint value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 void SimpleState::set(const QString& key, double value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 void SimpleState::set(const QString& key, bool value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 
+bool SimpleState::canMerge(UndoObject* target, const QString& key, qint64 interval)
+{
+	return (target != NULL) && (undoObject() == target) && contains(key) && (msecsSinceChange() < interval);
+}
+
+qint64 SimpleState::memorySize() const
+{
+	qint64 size = UndoState::memorySize() - sizeof(UndoState) + sizeof(SimpleState);
+	size += m_values.capacity() * sizeof(Value);
+	for (int i = 0; i < m_values.count(); ++i)
+		size += variantSize(m_values.at(i).second);
+	return size;
+}
+
 SimpleState::~SimpleState()
 {
 
 }
 
+/*** Payload sizes ***********************************************************/
+
+qint64 undoPayloadSize(const QString& s)
+{
+	return s.capacity() * sizeof(QChar);
+}
+
+qint64 undoPayloadSize(const FPointArray& points)
+{
+	return points.capacity() * sizeof(FPoint);
+}
+
+qint64 undoPayloadSize(const ImageEffect& effect)
+{
+	return undoPayloadSize(effect.effectParameters);
+}
+
+qint64 undoPayloadSize(const VGradient& gradient)
+{
+	const QList<VColorStop*>& stops = gradient.colorStops();
+	qint64 size = stops.count() * (sizeof(void*) + sizeof(VColorStop));
+	for (int i = 0; i < stops.count(); ++i)
+		size += undoPayloadSize(stops.at(i)->name);
+	return size;
+}
+
+qint64 undoPayloadSize(const StoryText& story)
+{
+	// text buffer and per character flags, style runs are few in comparison
+	return story.length() * (sizeof(QChar) + sizeof(ushort));
+}
+
+/*** ScItemsState *************************************************************/
+
+void ScItemsState::insertItem(const QString& itemname, void * item)
+{
+	int id = keyId(itemname);
+	for (int i = 0; i < pointerMap.count(); ++i)
+	{
+		if (pointerMap.at(i).first == id)
+		{
+			pointerMap[i].second = item;
+			return;
+		}
+	}
+	pointerMap.append(qMakePair(id, item));
+}
+
+void* ScItemsState::getItem(const QString& itemname) const
+{
+	int id = knownKeyId(itemname);
+	for (int i = 0; id >= 0 && i < pointerMap.count(); ++i)
+	{
+		if (pointerMap.at(i).first == id)
+			return pointerMap.at(i).second;
+	}
+	return NULL;
+}
+
+qint64 ScItemsState::memorySize() const
+{
+	return SimpleState::memorySize() - sizeof(SimpleState) + sizeof(ScItemsState)
+		+ pointerMap.capacity() * sizeof(QPair<int, void*>)
+		+ insertItemPos.count() * (sizeof(QPair<void*, int>) + sizeof(void*));
+}
+
 /*** TransactionState *****************************************************/
 
 TransactionState::TransactionState() : UndoState("")
@@ -285,6 +452,15 @@ UndoObject* TransactionState::replace(ulong uid, UndoObject *newUndoObject)
 	return tmp;
 }
 
+qint64 TransactionState::memorySize() const
+{
+	qint64 size = UndoState::memorySize() - sizeof(UndoState) + sizeof(TransactionState);
+	size += states_.capacity() * sizeof(UndoState*);
+	for (uint i = 0; i < states_.size(); ++i)
+		size += states_[i]->memorySize();
+	return size;
+}
+
 void TransactionState::undo() // undo all attached states
 {
 	for (int i = sizet() - 1; i > -1; --i)
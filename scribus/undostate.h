@@ -27,19 +27,26 @@ for which a new license (GPL+exception) is in place.
 #ifndef UNDOSTATE_H
 #define UNDOSTATE_H
 
+#include <utility>
 #include <vector>
 
+#include <QElapsedTimer>
 #include <QMap>
 #include <QPair>
 #include <QPixmap>
 #include <QVariant>
+#include <QVector>
 #include <QList>
 
 #include "scribusapi.h"
 #include "undoobject.h"
 
 class QString;
+class FPointArray;
 class PageItem;
+class StoryText;
+class VGradient;
+struct ImageEffect;
 
 /**
  * @brief UndoState describes an undoable state (action).
@@ -118,9 +125,29 @@ public:
 	virtual void setUndoObject(UndoObject *object);
 	/** @brief return the UndoObject this state belongs to */
 	virtual UndoObject* undoObject();
+	/**
+	 * @brief Returns an estimate of the memory used by this state in bytes.
+	 *
+	 * Used by UndoStack to keep the history within its memory budget. Values
+	 * shared with other objects, like item copies, are not followed.
+	 */
+	virtual qint64 memorySize() const;
+	/**
+	 * @brief Restart the time since the last change of this state.
+	 *
+	 * Call it when a later action is merged into this state.
+	 */
+	void touch();
+	/**
+	 * @brief Returns the milliseconds since the state was created or last touched.
+	 */
+	qint64 msecsSinceChange() const;
 	int transactionCode;
 
 private:
+	friend class UndoStack;
+	/** @brief Size accounted for this state by the UndoStack holding it */
+	qint64 stackedSize_;
 	/** @brief Name of the state (operation) (f.e. Move object) */
 	QString actionName_;
 	/** @brief Detailed description of the state (operation). */
@@ -129,6 +156,8 @@ private:
 	QPixmap *actionPixmap_;
 	/** @brief UndoObject this state belongs to */
 	UndoObjectPtr undoObject_;
+	/** @brief Time since creation or the last touch() */
+	QElapsedTimer changeTimer_;
 };
 
 /*** SimpleState **************************************************************************/
@@ -136,8 +165,10 @@ private:
 /**
  * @brief SimpleState provides a simple implementation of the UndoState.
  *
- * SimpleState uses a <code>QMap</code> to store key-value pairs that can be queried and
- * set using it's get() and set() methods.
+ * SimpleState stores key-value pairs that can be queried and set using it's
+ * get() and set() methods. Keys are interned once for all states and values are
+ * kept in a vector sorted by key id, so a state costs a few bytes per value
+ * instead of a map node and a key string copy.
  *
  * @author Riku Leino tsoots@gmail.com
  * @date December 2004
@@ -285,13 +316,83 @@ public:
 	 */
 	void set(const QString& key, bool value);
 
+	/**
+	 * @brief Tells if an action of the same kind on target may extend this state.
+	 *
+	 * True if this state belongs to target, carries key and was changed less than
+	 * interval milliseconds ago.
+	 * @param target UndoObject of the new action
+	 * @param key Key identifying the kind of action, f.e. "ITEM_MOVE"
+	 * @param interval Time window in milliseconds
+	 */
+	bool canMerge(UndoObject* target, const QString& key, qint64 interval);
+
+	qint64 memorySize() const;
+
+protected:
+	/** @brief Returns the id of key, registering it if it is new */
+	static int keyId(const QString& key);
+	/** @brief Returns the id of key or -1 if no state has used it yet */
+	static int knownKeyId(const QString& key);
+
 private:
-	/** @brief QMap to store key-value pairs */
-	QMap<QString, QVariant> m_values;
+	typedef QPair<int, QVariant> Value;
+	/** @brief Key-value pairs sorted by key id */
+	QVector<Value> m_values;
 
+	/** @brief Returns the position of id in m_values or where it should be inserted */
+	int lowerBound(int id) const;
+	void setValue(const QString& key, const QVariant& value);
 	QVariant variant(const QString& key, const QVariant& def);
 };
 
+/*** Payload sizes *********************************************************************/
+
+/**
+ * @brief Heap memory owned by a value stored in an ScItemState, beyond its sizeof.
+ *
+ * Overloads for the containers and heavy types kept in undo states, anything
+ * else is counted by sizeof only.
+ */
+template<class T>
+inline qint64 undoPayloadSize(const T&) { return 0; }
+
+SCRIBUS_API qint64 undoPayloadSize(const QString& s);
+SCRIBUS_API qint64 undoPayloadSize(const FPointArray& points);
+SCRIBUS_API qint64 undoPayloadSize(const ImageEffect& effect);
+SCRIBUS_API qint64 undoPayloadSize(const VGradient& gradient);
+SCRIBUS_API qint64 undoPayloadSize(const StoryText& story);
+
+template<class T>
+inline qint64 undoPayloadSize(const QList<T>& list)
+{
+	qint64 size = list.count() * (sizeof(void*) + sizeof(T));
+	for (int i = 0; i < list.count(); ++i)
+		size += undoPayloadSize(list.at(i));
+	return size;
+}
+
+template<class T>
+inline qint64 undoPayloadSize(const QVector<T>& vector)
+{
+	qint64 size = vector.capacity() * sizeof(T);
+	for (int i = 0; i < vector.count(); ++i)
+		size += undoPayloadSize(vector.at(i));
+	return size;
+}
+
+template<class A, class B>
+inline qint64 undoPayloadSize(const QPair<A, B>& pair)
+{
+	return undoPayloadSize(pair.first) + undoPayloadSize(pair.second);
+}
+
+template<class A, class B>
+inline qint64 undoPayloadSize(const std::pair<A, B>& pair)
+{
+	return undoPayloadSize(pair.first) + undoPayloadSize(pair.second);
+}
+
 /*** ItemState ***************************************************************************/
 
 template<class C>
@@ -303,6 +404,7 @@ public:
 	~ScItemState() {}
 	void setItem(const C &c) { item_ = c; }
 	C getItem() const { return item_; }
+	qint64 memorySize() const { return SimpleState::memorySize() + sizeof(C) + undoPayloadSize(item_); }
 private:
 	C item_;
 };
@@ -315,11 +417,13 @@ public:
 	ScItemsState(const QString& name, const QString& description = 0, QPixmap* pixmap = 0)
 	: SimpleState(name, description, pixmap) {}
 	~ScItemsState() {}
-	void insertItem(QString itemname, void * item) { pointerMap.insert(itemname, item); }
-	void* getItem(QString itemname) const { if (pointerMap.contains(itemname)) return pointerMap.value(itemname); else return NULL;}
+	void insertItem(const QString& itemname, void * item);
+	void* getItem(const QString& itemname) const;
 	QList< QPair<void*, int> > insertItemPos;
+	qint64 memorySize() const;
 private:
-	QMap<QString,void*> pointerMap;
+	/** @brief Item pointers by interned key id, usually only a handful */
+	QVector< QPair<int, void*> > pointerMap;
 };
 
 /*** TransactionState ********************************************************************/
@@ -397,6 +501,8 @@ public:
 	void undo();
 	/** @brief redo all UndoStates in this transaction */
 	void redo();
+	/** @brief Memory used by all UndoStates in this transaction */
+	qint64 memorySize() const;
 private:
 	/** @brief Number of undo states stored in this transaction */
 	uint size_;
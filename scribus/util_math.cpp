@@ -478,6 +478,72 @@ bool compareDouble(double a, double b)
 }
 
 
+void appendDecimal(QByteArray& out, double value, int decimals)
+{
+	static const double scales[] = { 1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+	decimals = qBound(0, decimals, 9);
+	double scaled = fabs(value) * scales[decimals] + 0.5;
+	if (!(scaled < 9.0e18)) // too large for 64 bits, nan or inf
+	{
+		QByteArray number = QByteArray::number(value, 'f', decimals);
+		if (number.contains('.'))
+		{
+			int end = number.length();
+			while (number.at(end - 1) == '0')
+				--end;
+			if (number.at(end - 1) == '.')
+				--end;
+			number.truncate(end);
+		}
+		out.append(number);
+		return;
+	}
+	quint64 digits = static_cast<quint64>(scaled);
+	if (digits == 0)
+	{
+		out.append('0');
+		return;
+	}
+	// written backwards from the last fraction digit
+	char buffer[24];
+	char* end = buffer + sizeof(buffer);
+	char* p = end;
+	int fraction = decimals;
+	while (fraction > 0 && digits % 10 == 0)
+	{
+		digits /= 10;
+		--fraction;
+	}
+	for (; fraction > 0; --fraction)
+	{
+		*--p = '0' + digits % 10;
+		digits /= 10;
+	}
+	if (p != end)
+		*--p = '.';
+	do
+	{
+		*--p = '0' + digits % 10;
+		digits /= 10;
+	}
+	while (digits > 0);
+	if (value < 0)
+		*--p = '-';
+	out.append(p, end - p);
+}
+
+void appendOperator(QByteArray& out, const double* operands, int count, int decimals, const char* op)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		appendDecimal(out, operands[i], decimals);
+		out.append(' ');
+	}
+	out.append(op);
+	out.append('\n');
+}
+
+
 double constrainAngle(double angle, double constrain)
 {
 	double newAngle=angle;
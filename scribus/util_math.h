@@ -29,6 +29,13 @@ class QRegion;
 If premultiplication does not allow to store result in a long value, perform a standard comparison.
 */
 bool SCRIBUS_API compareDouble(double a, double b);
+/*! \brief Appends value as a decimal number without exponent, as used in PDF and PostScript.
+At most decimals (0-9) digits follow the point, trailing zeros are dropped and
+values rounding to zero are written as "0". Much faster than QByteArray::number().
+*/
+void SCRIBUS_API appendDecimal(QByteArray& out, double value, int decimals);
+/*! \brief Appends a PostScript or PDF operator line "operand ... op\n", the operands written with appendDecimal(). */
+void SCRIBUS_API appendOperator(QByteArray& out, const double* operands, int count, int decimals, const char* op);
 uint SCRIBUS_API getDouble(const QByteArray in, bool raw);
 FPoint   SCRIBUS_API getMaxClipF(FPointArray* Clip);
 FPoint   SCRIBUS_API getMinClipF(FPointArray* Clip);